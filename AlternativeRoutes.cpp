@@ -0,0 +1,315 @@
+#include "AlternativeRoutes.h"
+#include "DaryHeap.h"
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+namespace
+{
+    // Route in dense indices, as the searches build it
+    struct IndexRoute
+    {
+        std::vector<uint32_t> vertices;
+        std::vector<double> lengths; // Cumulative length at every vertex
+        double cost() const { return lengths.back(); }
+    };
+
+    // Plateau from first to last, on both the forward and the backward tree
+    struct Plateau
+    {
+        uint32_t first;
+        uint32_t last;
+        double cost;   // Length of the route through the plateau
+        double length; // Length of the plateau itself
+    };
+
+    uint64_t edgeKey(uint32_t from, uint32_t to) { return (static_cast<uint64_t>(from) << 32) | to; }
+
+    uint32_t checkedIndex(const CompactGraph &compact, uint32_t vertexId)
+    {
+        uint32_t index = compact.indexOf(vertexId);
+        if (index == CompactGraph::kInvalidIndex)
+            throw std::runtime_error("Error: vertex " + std::to_string(vertexId) + " not found in the graph.");
+        return index;
+    }
+
+    // Follows the predecessors of the last settled vertex back to the start of the search
+    IndexRoute forwardPath(const SearchWorkspace &workspace, uint32_t last)
+    {
+        IndexRoute route;
+        for (uint32_t index = last; index != CompactGraph::kInvalidIndex; index = workspace.previous(index))
+        {
+            route.vertices.push_back(index);
+            route.lengths.push_back(workspace.distance<DoubleWeights>(index));
+        }
+        std::reverse(route.vertices.begin(), route.vertices.end());
+        std::reverse(route.lengths.begin(), route.lengths.end());
+        return route;
+    }
+
+    /**
+     * Dijkstra search from source to target that skips the vertices stamped in banned and the
+     * edges from source to bannedTargets. Returns false if target cannot be reached.
+     */
+    bool spurSearch(const CompactGraph &compact, uint32_t source, uint32_t target, const std::vector<uint32_t> &banned,
+                    uint32_t stamp, const std::vector<uint32_t> &bannedTargets, SearchWorkspace &workspace, IndexRoute &spur)
+    {
+        DaryHeap<double> &queue = workspace.queue<DaryHeap<double>>();
+        workspace.begin<DoubleWeights>(compact.vertexCount());
+        queue.clear(compact.vertexCount());
+        workspace.reach(source, 0.0, CompactGraph::kInvalidIndex);
+        queue.push(source, 0.0);
+        while (!queue.empty())
+        {
+            uint32_t current = queue.pop();
+            double distance = workspace.distance<DoubleWeights>(current);
+            workspace.settle(current);
+            if (current == target)
+            {
+                spur = forwardPath(workspace, target);
+                return true;
+            }
+            compact.forEachEdge(current, [&](uint32_t neighbor, double weight)
+                                {
+                if (banned[neighbor] == stamp ||
+                    (current == source && std::find(bannedTargets.begin(), bannedTargets.end(), neighbor) != bannedTargets.end()))
+                    return;
+                double updated = distance + weight;
+                if (updated < workspace.distance<DoubleWeights>(neighbor))
+                {
+                    workspace.reach(neighbor, updated, current);
+                    queue.push(neighbor, updated);
+                } });
+        }
+        return false;
+    }
+
+    // Length of the route on the edges of used
+    double sharedLength(const IndexRoute &route, const std::unordered_set<uint64_t> &used)
+    {
+        double shared = 0.0;
+        for (size_t i = 0; i + 1 < route.vertices.size(); ++i)
+            if (used.count(edgeKey(route.vertices[i], route.vertices[i + 1])))
+                shared += route.lengths[i + 1] - route.lengths[i];
+        return shared;
+    }
+
+    // Translates the routes to vertex IDs and fills in the length each one shares with those before it
+    std::vector<alternatives::Route> toRoutes(const CompactGraph &compact, const std::vector<IndexRoute> &routes)
+    {
+        std::vector<alternatives::Route> result;
+        std::unordered_set<uint64_t> used;
+        for (const IndexRoute &route : routes)
+        {
+            alternatives::Route &out = result.emplace_back();
+            for (uint32_t index : route.vertices)
+                out.path.push_back(compact.idOf(index));
+            out.lengths = route.lengths;
+            out.cost = route.cost();
+            out.shared = sharedLength(route, used);
+            for (size_t i = 0; i + 1 < route.vertices.size(); ++i)
+                used.insert(edgeKey(route.vertices[i], route.vertices[i + 1]));
+        }
+        return result;
+    }
+
+    /**
+     * Dijkstra search that settles vertices until the smallest queued distance exceeds bound, or until
+     * stopAt is settled when bound is infinite. visit(source, visitNeighbor) enumerates the edges.
+     * Returns the settled vertices in settle order.
+     */
+    template <typename Visit>
+    std::vector<uint32_t> boundedTree(uint32_t vertexCount, uint32_t source, uint32_t stopAt, double &bound,
+                                      double maxStretch, SearchWorkspace &workspace, Visit &&visit)
+    {
+        std::vector<uint32_t> settledOrder;
+        DaryHeap<double> &queue = workspace.queue<DaryHeap<double>>();
+        workspace.begin<DoubleWeights>(vertexCount);
+        queue.clear(vertexCount);
+        workspace.reach(source, 0.0, CompactGraph::kInvalidIndex);
+        queue.push(source, 0.0);
+        while (!queue.empty())
+        {
+            uint32_t current = queue.pop();
+            double distance = workspace.distance<DoubleWeights>(current);
+            if (distance > bound)
+                break;
+            workspace.settle(current);
+            settledOrder.push_back(current);
+            if (current == stopAt)
+                bound = distance * maxStretch; // No admissible route goes farther than this
+            visit(current, [&](uint32_t neighbor, double weight)
+                  {
+                double updated = distance + weight;
+                if (updated < workspace.distance<DoubleWeights>(neighbor))
+                {
+                    workspace.reach(neighbor, updated, current);
+                    queue.push(neighbor, updated);
+                } });
+        }
+        return settledOrder;
+    }
+}
+
+std::vector<alternatives::Route> alternatives::kShortest(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId,
+                                                         uint32_t count, SearchWorkspace &workspace)
+{
+    Graph::SearchView view = graph.getSearchView(); // Pinned for the whole query, even if weights are updated
+    const CompactGraph &compact = view.compact;
+    uint32_t start = checkedIndex(compact, startVertexId);
+    uint32_t end = checkedIndex(compact, endVertexId);
+
+    std::vector<uint32_t> banned(compact.vertexCount(), 0);
+    uint32_t stamp = 1;
+    std::vector<IndexRoute> accepted(1);
+    if (count == 0 || !spurSearch(compact, start, end, banned, stamp, {}, workspace, accepted[0]))
+        return {};
+
+    // Candidates by cost, then vertices: equal candidates found from different roots are kept once
+    std::map<std::pair<double, std::vector<uint32_t>>, std::vector<double>> candidates;
+    while (accepted.size() < count)
+    {
+        const IndexRoute previous = accepted.back();
+        for (size_t i = 0; i + 1 < previous.vertices.size(); ++i)
+        {
+            uint32_t spurVertex = previous.vertices[i];
+            ++stamp;
+            for (size_t j = 0; j < i; ++j)
+                banned[previous.vertices[j]] = stamp; // The root stays loopless
+
+            // The routes already accepted with this root leave it by another edge
+            std::vector<uint32_t> bannedTargets;
+            for (const IndexRoute &route : accepted)
+                if (route.vertices.size() > i + 1 &&
+                    std::equal(route.vertices.begin(), route.vertices.begin() + static_cast<std::ptrdiff_t>(i) + 1,
+                               previous.vertices.begin()))
+                    bannedTargets.push_back(route.vertices[i + 1]);
+
+            IndexRoute spur;
+            if (!spurSearch(compact, spurVertex, end, banned, stamp, bannedTargets, workspace, spur))
+                continue;
+            std::vector<uint32_t> vertices(previous.vertices.begin(), previous.vertices.begin() + static_cast<std::ptrdiff_t>(i));
+            std::vector<double> lengths(previous.lengths.begin(), previous.lengths.begin() + static_cast<std::ptrdiff_t>(i));
+            for (size_t j = 0; j < spur.vertices.size(); ++j)
+            {
+                vertices.push_back(spur.vertices[j]);
+                lengths.push_back(previous.lengths[i] + spur.lengths[j]);
+            }
+            double cost = lengths.back();
+            candidates.emplace(std::make_pair(cost, std::move(vertices)), std::move(lengths));
+        }
+        if (candidates.empty())
+            break;
+        auto best = candidates.begin();
+        accepted.push_back({best->first.second, best->second});
+        candidates.erase(best);
+    }
+    return toRoutes(compact, accepted);
+}
+
+std::vector<alternatives::Route> alternatives::plateaus(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId,
+                                                        const Options &options, SearchWorkspace &workspace)
+{
+    Graph::SearchView view = graph.getSearchView(); // Pinned for the whole query, even if weights are updated
+    const CompactGraph &compact = view.compact;
+    const ReverseAdjacency &reverse = *view.reverse;
+    uint32_t start = checkedIndex(compact, startVertexId);
+    uint32_t end = checkedIndex(compact, endVertexId);
+    if (options.count == 0)
+        return {};
+
+    // Forward tree until the end is settled and then up to the stretch bound, backward tree up to the same bound
+    double bound = std::numeric_limits<double>::infinity();
+    std::vector<uint32_t> forwardSettled = boundedTree(compact.vertexCount(), start, end, bound, options.maxStretch, workspace,
+                                                       [&](uint32_t index, auto &&visit)
+                                                       { compact.forEachEdge(index, visit); });
+    if (!workspace.settled(end))
+        return {};
+    double shortest = workspace.distance<DoubleWeights>(end);
+    SearchWorkspace &backward = workspace.backward();
+    boundedTree(compact.vertexCount(), end, CompactGraph::kInvalidIndex, bound, options.maxStretch, backward,
+                [&](uint32_t index, auto &&visit)
+                { reverse.forEachEdge(compact, index, visit); });
+
+    auto onBoth = [&](uint32_t index)
+    { return index != CompactGraph::kInvalidIndex && workspace.settled(index) && backward.settled(index); };
+    // Edge from -> to on both trees: to is reached from from forward, and from reaches the end through to
+    auto plateauEdge = [&](uint32_t from, uint32_t to)
+    { return onBoth(from) && onBoth(to) && workspace.previous(to) == from && backward.previous(from) == to; };
+
+    std::vector<Plateau> candidates;
+    for (uint32_t first : forwardSettled)
+    {
+        if (!backward.settled(first) || plateauEdge(workspace.previous(first), first))
+            continue; // Not on both trees, or not the first vertex of its plateau
+        uint32_t last = first;
+        while (plateauEdge(last, backward.previous(last)))
+            last = backward.previous(last);
+        double cost = workspace.distance<DoubleWeights>(first) + backward.distance<DoubleWeights>(first);
+        double length = workspace.distance<DoubleWeights>(last) - workspace.distance<DoubleWeights>(first);
+        if (cost <= options.maxStretch * shortest && length >= options.localOptimality * shortest)
+            candidates.push_back({first, last, cost, length});
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Plateau &a, const Plateau &b)
+              { return a.cost < b.cost; });
+
+    std::vector<IndexRoute> accepted{forwardPath(workspace, end)};
+    std::unordered_set<uint64_t> used;
+    for (size_t i = 0; i + 1 < accepted[0].vertices.size(); ++i)
+        used.insert(edgeKey(accepted[0].vertices[i], accepted[0].vertices[i + 1]));
+    std::vector<uint32_t> onRoute(compact.vertexCount(), 0);
+    uint32_t stamp = 0;
+    for (const Plateau &plateau : candidates)
+    {
+        if (accepted.size() >= options.count)
+            break;
+
+        // Forward tree up to the end of the plateau, then backward tree to the end
+        IndexRoute route = forwardPath(workspace, plateau.last);
+        for (uint32_t index = backward.previous(plateau.last); index != CompactGraph::kInvalidIndex; index = backward.previous(index))
+        {
+            route.vertices.push_back(index);
+            route.lengths.push_back(plateau.cost - backward.distance<DoubleWeights>(index));
+        }
+
+        ++stamp;
+        bool loopless = true;
+        for (uint32_t index : route.vertices)
+        {
+            loopless = loopless && onRoute[index] != stamp;
+            onRoute[index] = stamp;
+        }
+        if (!loopless || sharedLength(route, used) > options.maxSharing * shortest)
+            continue;
+        for (size_t i = 0; i + 1 < route.vertices.size(); ++i)
+            used.insert(edgeKey(route.vertices[i], route.vertices[i + 1]));
+        accepted.push_back(std::move(route));
+    }
+    return toRoutes(compact, accepted);
+}
+
+void alternatives::printRoutes(const std::vector<Route> &routes, std::ostream &out)
+{
+    if (routes.empty())
+    {
+        out << "No route found." << std::endl;
+        return;
+    }
+    for (size_t r = 0; r < routes.size(); ++r)
+    {
+        const Route &route = routes[r];
+        out << "Route " << (r + 1) << ": length = " << std::fixed << std::setprecision(2) << route.cost
+            << ", stretch = " << std::setprecision(3) << route.cost / routes[0].cost << ", shared = "
+            << std::setprecision(2) << route.shared << ", vertices = " << route.path.size() << std::endl;
+        for (size_t i = 0; i < route.path.size(); ++i)
+        {
+            out << "Vertex[" << std::setw(4) << (i + 1) << "] : id = " << std::setw(8) << route.path[i]
+                << ", length = " << std::fixed << std::setprecision(2) << route.lengths[i] << std::endl;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef ALTERNATIVEROUTES_H
+#define ALTERNATIVEROUTES_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "Graph.h"
+#include "SearchWorkspace.h"
+
+/**
+ * Alternative routes between two vertices, on the double weights.
+ *
+ * kShortest() is the exact baseline: Yen's k shortest loopless paths, where every spur search
+ * is a Dijkstra search that avoids the root of the path and the edges already used after it.
+ * The spur searches reuse one workspace, so they do not allocate per search.
+ *
+ * plateaus() is the fast method: one forward shortest path tree from the start and one backward
+ * tree to the end, both bounded by the largest accepted stretch. A plateau is a chain of edges on
+ * both trees; the route through a plateau follows the forward tree to its end and the backward
+ * tree from there. Candidates are kept if they are loopless, within the stretch, locally optimal
+ * (their plateau is long enough) and share little with the routes already accepted.
+ */
+namespace alternatives
+{
+    /* One route, the first one of a list being the shortest */
+    struct Route
+    {
+        std::vector<uint32_t> path;  // Vertex IDs from start to end
+        std::vector<double> lengths; // Cumulative length in meters at every path vertex
+        double cost = 0.0;           // Length of the whole route in meters
+        double shared = 0.0;         // Length in meters shared with the routes before it in the list
+    };
+
+    /* Admissibility of the alternatives found by plateaus(), relative to the shortest distance d */
+    struct Options
+    {
+        uint32_t count = 3;            // Routes to return, including the shortest one
+        double maxStretch = 1.25;      // A route is at most maxStretch * d long
+        double maxSharing = 0.8;       // A route shares at most maxSharing * d with the routes before it
+        double localOptimality = 0.25; // Every subpath up to localOptimality * d is a shortest path
+    };
+
+    /**
+     * @brief Computes the k shortest loopless routes with Yen's algorithm.
+     * Throws an exception if a vertex does not exist.
+     *
+     * @param graph The graph to search.
+     * @param startVertexId The starting vertex ID.
+     * @param endVertexId The ending vertex ID.
+     * @param count The number of routes k.
+     * @param workspace The workspace to reuse; it must not be used by another query meanwhile.
+     * @return Up to count routes by increasing cost, empty if there is no path.
+     */
+    std::vector<Route> kShortest(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, uint32_t count,
+                                 SearchWorkspace &workspace);
+
+    /**
+     * @brief Computes alternative routes with the plateau method.
+     * Throws an exception if a vertex does not exist.
+     *
+     * @param graph The graph to search.
+     * @param startVertexId The starting vertex ID.
+     * @param endVertexId The ending vertex ID.
+     * @param options The number of routes and their admissibility.
+     * @param workspace The workspace to reuse; the backward tree uses its backward() workspace.
+     * @return The shortest route followed by up to options.count - 1 alternatives, empty if there is no path.
+     */
+    std::vector<Route> plateaus(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, const Options &options,
+                                SearchWorkspace &workspace);
+
+    /**
+     * @brief Prints routes: a summary line per route (cost, stretch, shared length) followed by its vertices.
+     *
+     * @param routes The routes, the shortest one first.
+     * @param out The stream to print to.
+     */
+    void printRoutes(const std::vector<Route> &routes, std::ostream &out);
+}
+
+#endif
\ No newline at end of file
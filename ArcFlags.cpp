@@ -0,0 +1,133 @@
+#include "ArcFlags.h"
+#include "DaryHeap.h"
+#include "utils.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+    // Owned cells and flags computed in memory
+    struct OwnedFlags
+    {
+        std::vector<uint32_t> cells;
+        std::vector<uint64_t> flags;
+    };
+
+    // Sets the flag of an edge for a cell; flag words are shared by the threads
+    void setFlag(std::vector<uint64_t> &flags, uint32_t words, uint32_t edge, uint32_t cell)
+    {
+        std::atomic_ref<uint64_t> word(flags[static_cast<size_t>(edge) * words + cell / 64]);
+        word.fetch_or(uint64_t{1} << (cell % 64), std::memory_order_relaxed);
+    }
+}
+
+ArcFlags::ArcFlags(const CompactGraph &graph, const ReverseAdjacency &reverse, uint32_t cellCount, unsigned threadCount)
+    : weightVersion(graph.version()), totalCells(std::max<uint32_t>(1, cellCount))
+{
+    auto owned = std::make_shared<OwnedFlags>();
+    const uint32_t n = graph.vertexCount();
+    const uint32_t words = wordsPerEdge();
+
+    owned->cells = utils::kdPartition(graph, totalCells);
+    const std::vector<uint32_t> &cells = owned->cells;
+
+    // Edges inside a cell lead to it; boundary vertices are entered from another cell
+    owned->flags.assign(static_cast<size_t>(graph.edgeCount()) * words, 0);
+    std::vector<uint32_t> boundary;
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        bool entered = false;
+        for (uint32_t r = reverse.edgeBegin(v); r < reverse.edgeEnd(v); ++r)
+        {
+            if (cells[reverse.source(r)] == cells[v])
+                setFlag(owned->flags, words, reverse.forwardEdge(r), cells[v]);
+            else
+                entered = true;
+        }
+        if (entered)
+            boundary.push_back(v);
+    }
+
+    // One backward shortest path tree per boundary vertex, spread over the threads
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<size_t> next{0};
+    auto worker = [&]()
+    {
+        std::vector<double> distance(n, kInfinity);
+        std::vector<uint32_t> treeEdge(n, CompactGraph::kInvalidIndex); // Forward edge from a vertex towards the root
+        std::vector<uint32_t> touched;
+        DaryHeap<double> queue;
+        for (size_t b = next++; b < boundary.size(); b = next++)
+        {
+            uint32_t root = boundary[b];
+            uint32_t cell = cells[root];
+            for (uint32_t v : touched)
+            {
+                distance[v] = kInfinity;
+                treeEdge[v] = CompactGraph::kInvalidIndex;
+            }
+            touched.clear();
+            queue.clear(n);
+
+            distance[root] = 0.0;
+            touched.push_back(root);
+            queue.push(root, 0.0);
+            while (!queue.empty())
+            {
+                uint32_t u = queue.pop();
+                if (treeEdge[u] != CompactGraph::kInvalidIndex)
+                    setFlag(owned->flags, words, treeEdge[u], cell);
+                for (uint32_t r = reverse.edgeBegin(u); r < reverse.edgeEnd(u); ++r)
+                {
+                    uint32_t v = reverse.source(r);
+                    uint32_t edge = reverse.forwardEdge(r);
+                    double updated = distance[u] + graph.weight(edge);
+                    if (updated < distance[v])
+                    {
+                        if (distance[v] == kInfinity)
+                            touched.push_back(v);
+                        distance[v] = updated;
+                        treeEdge[v] = edge;
+                        queue.push(v, updated);
+                    }
+                }
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < threadCount && i < boundary.size(); ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread &thread : threads)
+        thread.join();
+
+    data = Arrays{owned->cells, owned->flags};
+    storage = std::move(owned);
+}
+
+ArcFlags::ArcFlags(std::shared_ptr<const void> storage, const Arrays &arrays, uint32_t cellCount, uint64_t version)
+    : storage(std::move(storage)), weightVersion(version), totalCells(cellCount), data(arrays)
+{
+}
+
+double ArcFlags::density() const
+{
+    if (data.flags.empty())
+        return 0.0;
+    size_t set = 0;
+    for (uint64_t word : data.flags)
+        set += static_cast<size_t>(std::popcount(word));
+    return static_cast<double>(set) / (static_cast<double>(edgeCount()) * totalCells);
+}
+
+size_t ArcFlags::memoryUsage() const
+{
+    return data.cells.size_bytes() + data.flags.size_bytes();
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#ifndef ARCFLAGS_H
+#define ARCFLAGS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include "CompactGraph.h"
+#include "ReverseAdjacency.h"
+
+/**
+ * Arc flags for goal-directed Dijkstra queries.
+ *
+ * The vertices are partitioned into cells by a k-d split of their coordinates: every split
+ * cuts the longer side of the bounding box of a part at the vertex count that keeps the cells
+ * balanced. Every edge gets one bit per cell, set if the edge lies on a shortest path to a vertex
+ * of that cell. A query towards a vertex of cell c then only relaxes the edges whose bit c is set.
+ *
+ * The bits of a cell are computed with one backward Dijkstra search from every boundary vertex
+ * of the cell (a vertex with an incoming edge from another cell), in parallel: the edges of the
+ * shortest path tree get the bit, as do the edges inside the cell. Like the landmarks, the flags
+ * are read through spans so that they can point into a memory-mapped snapshot, and they are only
+ * valid for the weight version they were computed on.
+ */
+class ArcFlags
+{
+public:
+    /* Views over the cells and flags, in snapshot order */
+    struct Arrays
+    {
+        std::span<const uint32_t> cells; // Cell of every vertex
+        std::span<const uint64_t> flags; // Bit c % 64 of flags[e * wordsPerEdge() + c / 64] is the flag of edge e for cell c
+    };
+
+    /* Constructor & destructor */
+    ArcFlags() = default;
+    ~ArcFlags() = default;
+
+    /**
+     * Partitions the graph and computes the flags of every edge with parallel backward searches.
+     *
+     * @param graph The compact graph.
+     * @param reverse The reverse adjacency of the graph, for the backward searches.
+     * @param cellCount The number of cells, at least 1.
+     * @param threadCount The number of threads to use; 0 picks one per hardware thread.
+     */
+    ArcFlags(const CompactGraph &graph, const ReverseAdjacency &reverse, uint32_t cellCount, unsigned threadCount = 0);
+
+    /**
+     * Wraps externally owned cells and flags without copying them, e.g. from a snapshot.
+     *
+     * @param storage The object owning the memory the arrays point into.
+     * @param arrays The views over the cells and flags.
+     * @param cellCount The number of cells.
+     * @param version The weight version of the graph the flags were computed on.
+     */
+    ArcFlags(std::shared_ptr<const void> storage, const Arrays &arrays, uint32_t cellCount, uint64_t version);
+
+    /* Number of cells, of 64-bit flag words per edge and weight version of the flags */
+    uint32_t cellCount() const { return totalCells; }
+    uint32_t wordsPerEdge() const { return (totalCells + 63) / 64; }
+    uint64_t version() const { return weightVersion; }
+
+    /* Number of vertices and edges covered */
+    uint32_t vertexCount() const { return static_cast<uint32_t>(data.cells.size()); }
+    uint32_t edgeCount() const { return totalCells > 0 ? static_cast<uint32_t>(data.flags.size() / wordsPerEdge()) : 0; }
+
+    /* Cell of a vertex */
+    uint32_t cellOf(uint32_t index) const { return data.cells[index]; }
+
+    /* True if the edge lies on a shortest path to some vertex of the cell */
+    bool isSet(uint32_t edge, uint32_t cell) const
+    {
+        return (data.flags[static_cast<size_t>(edge) * wordsPerEdge() + cell / 64] >> (cell % 64)) & 1;
+    }
+
+    /**
+     * Gets the share of the flags that are set, a measure of how much a query can prune.
+     *
+     * @return The fraction of set bits over all edges and cells, between 0 and 1.
+     */
+    double density() const;
+
+    /**
+     * Gets the number of bytes held by the cells and flags.
+     *
+     * @return The memory footprint in bytes.
+     */
+    size_t memoryUsage() const;
+
+    /* Raw views over the cells and flags, e.g. for serialization */
+    const Arrays &arrays() const { return data; }
+
+private:
+    std::shared_ptr<const void> storage; // Keeps the memory behind the spans alive
+    uint64_t weightVersion = 0;
+    uint32_t totalCells = 0;
+    Arrays data;
+};
+
+#endif
\ No newline at end of file
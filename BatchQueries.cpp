@@ -0,0 +1,264 @@
+#include "BatchQueries.h"
+#include "algorithms.h"
+#include "SearchWorkspace.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using Search = std::function<PathResult(const Graph &, const parser::QueryPair &, SearchWorkspace &)>;
+
+    // Query positions [begin, end) still to answer by one thread; other threads steal from its end
+    struct WorkRange
+    {
+        std::mutex mutex;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    Search searchFor(const std::string &algorithm, QueueType queueType, bool withPaths)
+    {
+        if (algorithm == "bfs")
+            return [](const Graph &graph, const parser::QueryPair &query, SearchWorkspace &workspace)
+            { return algorithms::bfs(graph, query.idStart, query.idEnd, workspace); };
+        if (algorithm == "dijkstra")
+            return [queueType](const Graph &graph, const parser::QueryPair &query, SearchWorkspace &workspace)
+            { return algorithms::dijkstra(graph, query.idStart, query.idEnd, workspace, queueType); };
+        if (algorithm == "astar")
+            return [queueType](const Graph &graph, const parser::QueryPair &query, SearchWorkspace &workspace)
+            { return algorithms::aStar(graph, query.idStart, query.idEnd, workspace, queueType); };
+        if (algorithm == "bidijkstra")
+            return [queueType](const Graph &graph, const parser::QueryPair &query, SearchWorkspace &workspace)
+            { return algorithms::bidirectionalDijkstra(graph, query.idStart, query.idEnd, workspace, queueType); };
+        if (algorithm == "biastar")
+            return [queueType](const Graph &graph, const parser::QueryPair &query, SearchWorkspace &workspace)
+            { return algorithms::bidirectionalAStar(graph, query.idStart, query.idEnd, workspace, queueType); };
+        if (algorithm == "alt")
+            return [queueType](const Graph &graph, const parser::QueryPair &query, SearchWorkspace &workspace)
+            { return algorithms::alt(graph, query.idStart, query.idEnd, workspace, queueType); };
+        if (algorithm == "ch")
+            return [queueType](const Graph &graph, const parser::QueryPair &query, SearchWorkspace &workspace)
+            { return algorithms::contractionHierarchy(graph, query.idStart, query.idEnd, workspace, queueType); };
+        if (algorithm == "arcflags")
+            return [queueType](const Graph &graph, const parser::QueryPair &query, SearchWorkspace &workspace)
+            { return algorithms::arcFlags(graph, query.idStart, query.idEnd, workspace, queueType); };
+        if (algorithm == "crp")
+            return [queueType](const Graph &graph, const parser::QueryPair &query, SearchWorkspace &workspace)
+            { return algorithms::multiLevelOverlay(graph, query.idStart, query.idEnd, workspace, queueType); };
+        if (algorithm == "hl")
+            return [withPaths](const Graph &graph, const parser::QueryPair &query, SearchWorkspace &)
+            { return algorithms::hubLabelQuery(graph, query.idStart, query.idEnd, withPaths); };
+        throw std::runtime_error("Error: Unknown algorithm '" + algorithm +
+                                 "'. Use bfs, dijkstra, astar, bidijkstra, biastar, alt, ch, hl, arcflags, or crp.");
+    }
+
+    // Takes the next query of the thread's own range
+    bool takeOwn(WorkRange &range, size_t &index)
+    {
+        std::lock_guard<std::mutex> lock(range.mutex);
+        if (range.begin == range.end)
+            return false;
+        index = range.begin++;
+        return true;
+    }
+
+    // Moves the second half of the largest other range into the empty own range and takes its first query.
+    // Returns false once every range is empty. Only one range is locked at a time.
+    bool steal(std::vector<WorkRange> &ranges, size_t self, size_t &index)
+    {
+        while (true)
+        {
+            size_t victim = self;
+            size_t largest = 0;
+            for (size_t r = 0; r < ranges.size(); ++r)
+            {
+                if (r == self)
+                    continue;
+                std::lock_guard<std::mutex> lock(ranges[r].mutex);
+                if (ranges[r].end - ranges[r].begin > largest)
+                {
+                    largest = ranges[r].end - ranges[r].begin;
+                    victim = r;
+                }
+            }
+            if (victim == self)
+                return false;
+
+            size_t begin, end;
+            {
+                std::lock_guard<std::mutex> lock(ranges[victim].mutex);
+                size_t remaining = ranges[victim].end - ranges[victim].begin;
+                if (remaining == 0)
+                    continue; // Emptied meanwhile, look again
+                end = ranges[victim].end;
+                ranges[victim].end -= (remaining + 1) / 2;
+                begin = ranges[victim].end;
+            }
+            std::lock_guard<std::mutex> lock(ranges[self].mutex);
+            index = begin;
+            ranges[self].begin = begin + 1;
+            ranges[self].end = end;
+            return true;
+        }
+    }
+
+    const char *statusName(PathResult::Status status)
+    {
+        switch (status)
+        {
+        case PathResult::Status::Found:
+            return "found";
+        case PathResult::Status::SameVertex:
+            return "same-vertex";
+        case PathResult::Status::NoNeighbors:
+            return "no-neighbors";
+        case PathResult::Status::NotFound:
+            return "not-found";
+        case PathResult::Status::NoPath:
+            return "no-path";
+        }
+        return "unknown";
+    }
+}
+
+double batch::BatchReport::throughput() const
+{
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0.0 ? static_cast<double>(results.size()) / seconds : 0.0;
+}
+
+std::chrono::microseconds batch::BatchReport::percentile(double percent) const
+{
+    if (latencies.empty())
+        return std::chrono::microseconds(0);
+    std::vector<std::chrono::microseconds> sorted(latencies);
+    size_t rank = static_cast<size_t>(std::ceil(percent / 100.0 * static_cast<double>(sorted.size())));
+    size_t position = std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0);
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(position), sorted.end());
+    return sorted[position];
+}
+
+batch::BatchReport batch::run(const Graph &graph, const std::vector<parser::QueryPair> &queries, const std::string &algorithm,
+                              QueueType queueType, bool withPaths, unsigned threadCount)
+{
+    Search search = searchFor(algorithm, queueType, withPaths);
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threadCount, queries.size())));
+
+    BatchReport report;
+    report.threadCount = threadCount;
+    report.results.resize(queries.size());
+    report.latencies.resize(queries.size());
+
+    // Contiguous initial ranges: neighbouring queries of a sorted batch stay on the same thread
+    std::vector<WorkRange> ranges(threadCount);
+    for (unsigned t = 0; t < threadCount; ++t)
+    {
+        ranges[t].begin = queries.size() * t / threadCount;
+        ranges[t].end = queries.size() * (t + 1) / threadCount;
+    }
+
+    std::atomic<bool> failed{false};
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+    auto worker = [&](size_t self)
+    {
+        SearchWorkspace workspace;
+        size_t index = 0;
+        while (!failed && (takeOwn(ranges[self], index) || steal(ranges, self, index)))
+        {
+            try
+            {
+                auto start = Clock::now();
+                PathResult result = search(graph, queries[index], workspace);
+                report.latencies[index] = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+                if (!withPaths)
+                {
+                    result.path = std::vector<uint32_t>();
+                    result.lengths = std::vector<double>();
+                }
+                report.results[index] = std::move(result);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure)
+                    failure = std::current_exception();
+                failed = true;
+            }
+        }
+    };
+
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < threadCount; ++t)
+        threads.emplace_back(worker, t);
+    worker(0);
+    for (std::thread &thread : threads)
+        thread.join();
+    report.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+
+    if (failure)
+        std::rethrow_exception(failure);
+    return report;
+}
+
+void batch::writeCsv(const BatchReport &report, std::ostream &out, bool withPaths)
+{
+    out << "start,end,status,distance,visited" << (withPaths ? ",path" : "") << '\n'
+        << std::fixed << std::setprecision(2);
+    for (const PathResult &result : report.results)
+    {
+        out << result.startVertexId << ',' << result.endVertexId << ',' << statusName(result.status) << ',';
+        if (result.found())
+            out << result.cost;
+        else if (result.status == PathResult::Status::SameVertex)
+            out << 0.0;
+        else
+            out << "inf";
+        out << ',' << result.visitedCount;
+        if (withPaths)
+        {
+            out << ',';
+            for (size_t i = 0; i < result.path.size(); ++i)
+                out << (i > 0 ? " " : "") << result.path[i];
+        }
+        out << '\n';
+    }
+    out.flush();
+}
+
+void batch::printSummary(const BatchReport &report, std::ostream &out)
+{
+    size_t found = static_cast<size_t>(std::count_if(report.results.begin(), report.results.end(), [](const PathResult &result)
+                                                     { return result.found(); }));
+    out << "INFO: " << report.results.size() << " queries (" << found << " with a path) on " << report.threadCount
+        << " threads in " << report.elapsed.count() / 1000 << "ms: " << std::fixed << std::setprecision(0)
+        << report.throughput() << " queries/s, latency p50 " << report.percentile(50).count() << "us, p95 "
+        << report.percentile(95).count() << "us, p99 " << report.percentile(99).count() << "us" << std::endl;
+    out.unsetf(std::ios::floatfield);
+    out << std::setprecision(6);
+}
+
+size_t batch::countMismatches(const BatchReport &report, const BatchReport &reference, double weightStep)
+{
+    size_t mismatches = 0;
+    for (size_t i = 0; i < report.results.size(); ++i)
+    {
+        const PathResult &result = report.results[i], &expected = reference.results[i];
+        size_t edges = expected.path.empty() ? 0 : expected.path.size() - 1;
+        double tolerance = std::max(0.01, weightStep * static_cast<double>(edges));
+        if (result.status != expected.status || (result.found() && std::abs(result.cost - expected.cost) > tolerance))
+            mismatches++;
+    }
+    return mismatches;
+}
\ No newline at end of file
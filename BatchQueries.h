@@ -0,0 +1,93 @@
+#ifndef BATCHQUERIES_H
+#define BATCHQUERIES_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Graph.h"
+#include "GraphParser.h"
+#include "PathResult.h"
+#include "PriorityQueue.h"
+
+/**
+ * Batch answering of point-to-point queries on a graph loaded once, e.g. the origin-destination
+ * pairs of an offline route-planning job.
+ *
+ * Queries are spread over a work-stealing pool: every thread starts with a contiguous range of
+ * the batch and, once it is empty, steals the second half of the largest remaining range of
+ * another thread. Each thread keeps its own search workspace, and results are stored by query
+ * position so they come out in input order whatever thread answered them.
+ */
+namespace batch
+{
+    /* Results and timings of a batch */
+    struct BatchReport
+    {
+        std::vector<PathResult> results;                  // One per query, in input order
+        std::vector<std::chrono::microseconds> latencies; // Wall time of every query, in input order
+        std::chrono::microseconds elapsed{0};             // Wall time of the whole batch
+        unsigned threadCount = 0;
+
+        /* Queries answered per second */
+        double throughput() const;
+
+        /**
+         * @brief Latency at the given percentile (nearest rank).
+         *
+         * @param percent The percentile, between 0 and 100.
+         * @return The latency, 0 for an empty batch.
+         */
+        std::chrono::microseconds percentile(double percent) const;
+    };
+
+    /**
+     * @brief Answers every query with the given algorithm, using the workspace variants of the searches.
+     * The graph must already hold what the algorithm needs (landmarks, hierarchy or hub labels).
+     * Throws an exception for an unknown algorithm, or the first exception thrown by a query.
+     *
+     * @param graph The graph to search; it is only read.
+     * @param queries The origin-destination pairs.
+     * @param algorithm The algorithm name, as for --algorithm.
+     * @param queueType The priority queue implementation to use.
+     * @param withPaths True to keep the paths, false to keep only the costs (less memory on large batches).
+     * @param threadCount The number of threads to use; 0 picks one per hardware thread.
+     * @return The results and timings.
+     */
+    BatchReport run(const Graph &graph, const std::vector<parser::QueryPair> &queries, const std::string &algorithm,
+                    QueueType queueType, bool withPaths, unsigned threadCount = 0);
+
+    /**
+     * @brief Writes the results as CSV, one line per query in input order: start, end, status,
+     * distance ("inf" without a path) and visited count, plus the space-separated path if kept.
+     *
+     * @param report The batch results.
+     * @param out The stream to write to.
+     * @param withPaths True to add the path column.
+     */
+    void writeCsv(const BatchReport &report, std::ostream &out, bool withPaths);
+
+    /**
+     * @brief Prints the query count, throughput and p50/p95/p99 latencies of a batch.
+     *
+     * @param report The batch results.
+     * @param out The stream to print to.
+     */
+    void printSummary(const BatchReport &report, std::ostream &out);
+
+    /**
+     * @brief Compares a batch with a reference batch of the same queries, e.g. answered by Dijkstra.
+     * Statuses must match and distances may differ by up to a centimeter, the precision of hub labels,
+     * or by one weight step per edge of the reference path if that is more, so that searches on
+     * rounded weights are only flagged beyond their rounding error.
+     *
+     * @param report The batch to check.
+     * @param reference The reference batch, run with paths.
+     * @param weightStep The step the weights of the checked batch were rounded to (Graph::weightStep()).
+     * @return The number of queries that differ.
+     */
+    size_t countMismatches(const BatchReport &report, const BatchReport &reference, double weightStep);
+}
+
+#endif
\ No newline at end of file
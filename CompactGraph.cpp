@@ -0,0 +1,180 @@
+#include "CompactGraph.h"
+#include "Graph.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    // Owned backing arrays of a CompactGraph built in memory
+    struct OwnedArrays
+    {
+        std::vector<uint32_t> ids;
+        std::vector<uint32_t> idOrder;
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> targets;
+        std::vector<double> weights;
+        std::vector<double> longitudes;
+        std::vector<double> latitudes;
+    };
+
+    CompactGraph::Arrays viewsOf(const OwnedArrays &owned)
+    {
+        return CompactGraph::Arrays{owned.ids, owned.idOrder, owned.offsets, owned.targets,
+                                    owned.weights, owned.longitudes, owned.latitudes};
+    }
+}
+
+CompactGraph::CompactGraph(const Graph &graph, uint64_t version) : weightVersion(version)
+{
+    auto owned = std::make_shared<OwnedArrays>();
+    const auto &vertices = graph.getVertices();
+
+    owned->ids.reserve(vertices.size());
+    for (const auto &pair : vertices)
+    {
+        owned->ids.push_back(pair.first);
+    }
+    std::sort(owned->ids.begin(), owned->ids.end());
+
+    // Ascending IDs make the identity permutation the sorted order
+    owned->idOrder.resize(owned->ids.size());
+    for (uint32_t i = 0; i < owned->idOrder.size(); ++i)
+    {
+        owned->idOrder[i] = i;
+    }
+
+    owned->longitudes.reserve(owned->ids.size());
+    owned->latitudes.reserve(owned->ids.size());
+    for (uint32_t id : owned->ids)
+    {
+        const Vertex &vertex = vertices.at(id);
+        owned->longitudes.push_back(vertex.getLongitude());
+        owned->latitudes.push_back(vertex.getLatitude());
+    }
+
+    // indexOf() is needed to translate the edge targets below
+    data.ids = owned->ids;
+    data.idOrder = owned->idOrder;
+
+    size_t edgeTotal = 0;
+    for (const auto &pair : graph.getAdjacencyList())
+    {
+        edgeTotal += pair.second.size();
+    }
+    owned->targets.reserve(edgeTotal);
+    owned->weights.reserve(edgeTotal);
+
+    owned->offsets.reserve(owned->ids.size() + 1);
+    owned->offsets.push_back(0);
+    for (uint32_t id : owned->ids)
+    {
+        for (const Edge &edge : graph.getNeighbors(id))
+        {
+            owned->targets.push_back(indexOf(edge.getEndId()));
+            owned->weights.push_back(edge.getWeight());
+        }
+        owned->offsets.push_back(static_cast<uint32_t>(owned->targets.size()));
+    }
+
+    data = viewsOf(*owned);
+    storage = std::move(owned);
+}
+
+CompactGraph::CompactGraph(std::shared_ptr<const void> storage, const Arrays &arrays, uint64_t version)
+    : storage(std::move(storage)), weightVersion(version), data(arrays)
+{
+}
+
+CompactGraph CompactGraph::withWeights(std::shared_ptr<const std::vector<double>> weights) const
+{
+    if (weights->size() != data.weights.size())
+    {
+        throw std::runtime_error("Weight overlay size does not match the number of edges");
+    }
+
+    CompactGraph updated(*this);
+    updated.data.weights = *weights;
+    updated.weightStorage = std::move(weights);
+    updated.weightVersion = weightVersion + 1;
+    return updated;
+}
+
+CompactGraph CompactGraph::reordered(std::span<const uint32_t> order) const
+{
+    const uint32_t n = vertexCount();
+    std::vector<uint32_t> newIndex(n, kInvalidIndex);
+    if (order.size() != n)
+    {
+        throw std::runtime_error("Vertex order does not cover every vertex");
+    }
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (order[i] >= n || newIndex[order[i]] != kInvalidIndex)
+        {
+            throw std::runtime_error("Vertex order is not a permutation");
+        }
+        newIndex[order[i]] = i;
+    }
+
+    auto owned = std::make_shared<OwnedArrays>();
+    owned->ids.resize(n);
+    owned->idOrder.resize(n);
+    owned->longitudes.resize(n);
+    owned->latitudes.resize(n);
+    owned->offsets.reserve(n + 1);
+    owned->targets.reserve(edgeCount());
+    owned->weights.reserve(edgeCount());
+
+    owned->offsets.push_back(0);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        uint32_t old = order[i];
+        owned->ids[i] = data.ids[old];
+        owned->longitudes[i] = data.longitudes[old];
+        owned->latitudes[i] = data.latitudes[old];
+        for (uint32_t edge = edgeBegin(old); edge < edgeEnd(old); ++edge)
+        {
+            owned->targets.push_back(newIndex[data.targets[edge]]);
+            owned->weights.push_back(data.weights[edge]);
+        }
+        owned->offsets.push_back(static_cast<uint32_t>(owned->targets.size()));
+    }
+
+    // The sorted-by-ID order is unchanged, only the indices it refers to are renamed
+    for (uint32_t k = 0; k < n; ++k)
+    {
+        owned->idOrder[k] = newIndex[data.idOrder[k]];
+    }
+
+    Arrays views = viewsOf(*owned);
+    return CompactGraph(std::move(owned), views, weightVersion);
+}
+
+uint32_t CompactGraph::findEdge(uint32_t fromIndex, uint32_t toIndex) const
+{
+    for (uint32_t edge = edgeBegin(fromIndex); edge < edgeEnd(fromIndex); ++edge)
+    {
+        if (data.targets[edge] == toIndex)
+            return edge;
+    }
+    return kInvalidIndex;
+}
+
+uint32_t CompactGraph::indexOf(uint32_t vertexId) const
+{
+    auto it = std::lower_bound(data.idOrder.begin(), data.idOrder.end(), vertexId,
+                               [this](uint32_t index, uint32_t id)
+                               { return data.ids[index] < id; });
+    if (it != data.idOrder.end() && data.ids[*it] == vertexId)
+    {
+        return *it;
+    }
+    return kInvalidIndex;
+}
+
+size_t CompactGraph::memoryUsage() const
+{
+    return data.ids.size_bytes() + data.idOrder.size_bytes() + data.offsets.size_bytes() +
+           data.targets.size_bytes() + data.weights.size_bytes() + data.longitudes.size_bytes() +
+           data.latitudes.size_bytes();
+}
\ No newline at end of file
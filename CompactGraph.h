@@ -0,0 +1,169 @@
+#ifndef COMPACTGRAPH_H
+#define COMPACTGRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <vector>
+#include "WeightTraits.h"
+
+class Graph;
+
+/**
+ * Frozen compressed-sparse-row (CSR) view of a Graph used by the search algorithms.
+ *
+ * Original vertex IDs are remapped to dense indices in [0, vertexCount()), the
+ * outgoing edges of index u are stored contiguously in [edgeBegin(u), edgeEnd(u))
+ * and coordinates live in flat arrays. IDs are only translated at the API boundary
+ * through indexOf() and idOf().
+ *
+ * The arrays are read through spans so that they can either be owned by the
+ * CompactGraph or point straight into a memory-mapped snapshot. Copies share the
+ * same storage and are cheap, so a query can pin a consistent copy while edge
+ * weights are replaced through withWeights().
+ */
+class CompactGraph
+{
+public:
+    /* Weights and distances are double-precision meters */
+    using Traits = DoubleWeights;
+
+    /* Sentinel returned by indexOf() for unknown vertex IDs */
+    static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    /* Views over every array of the CSR representation, in snapshot order */
+    struct Arrays
+    {
+        std::span<const uint32_t> ids;      // Dense index -> original vertex ID
+        std::span<const uint32_t> idOrder;  // Dense indices sorted by original vertex ID, for indexOf()
+        std::span<const uint32_t> offsets;  // vertexCount() + 1 entries into targets/weights
+        std::span<const uint32_t> targets;  // Dense index of the end vertex of every edge
+        std::span<const double> weights;    // Weight of every edge
+        std::span<const double> longitudes; // Longitude of every vertex
+        std::span<const double> latitudes;  // Latitude of every vertex
+    };
+
+    /* Constructors & destructor */
+    CompactGraph() = default;
+    ~CompactGraph() = default;
+
+    /**
+     * Builds the CSR representation from the vertices and adjacency list of a graph.
+     * Dense indices are assigned in ascending order of the original vertex IDs and
+     * the edges of every vertex keep their insertion order.
+     *
+     * @param graph The graph to freeze.
+     * @param version The weight version of the new representation.
+     */
+    explicit CompactGraph(const Graph &graph, uint64_t version = 0);
+
+    /**
+     * Wraps externally owned arrays without copying them.
+     * The arrays must be consistent with each other (see Arrays) and stay valid
+     * for as long as the storage object is alive.
+     *
+     * @param storage The object owning the memory the arrays point into.
+     * @param arrays The views over the CSR arrays.
+     * @param version The weight version of the arrays.
+     */
+    CompactGraph(std::shared_ptr<const void> storage, const Arrays &arrays, uint64_t version = 0);
+
+    /**
+     * Creates a copy sharing the topology and coordinates of this graph but using new edge
+     * weights (copy-on-write overlay). The copy has the next weight version, so that data
+     * derived from the old weights can detect that it is stale.
+     *
+     * @param weights The new weight of every edge, in edge order.
+     * @return The re-weighted compact graph.
+     */
+    CompactGraph withWeights(std::shared_ptr<const std::vector<double>> weights) const;
+
+    /**
+     * Creates a copy with the vertices renumbered in the given order: vertex order[i]
+     * becomes dense index i. Adjacency, weights and coordinates are permuted to match and
+     * the ID translation is updated, so results only change in how ties are broken.
+     * Throws an exception if the order is not a permutation of the dense indices.
+     *
+     * @param order The old dense index of every new dense index.
+     * @return The reordered compact graph, with the same weight version.
+     */
+    CompactGraph reordered(std::span<const uint32_t> order) const;
+
+    /**
+     * Gets the weight version: 0 when first built, incremented by every withWeights() update.
+     *
+     * @return The weight version.
+     */
+    uint64_t version() const { return weightVersion; }
+
+    /* Sizes */
+    uint32_t vertexCount() const { return static_cast<uint32_t>(data.ids.size()); }
+    uint32_t edgeCount() const { return static_cast<uint32_t>(data.targets.size()); }
+
+    /**
+     * Translates an original vertex ID into its dense index.
+     *
+     * @param vertexId The original vertex ID.
+     * @return The dense index, or kInvalidIndex if the vertex does not exist.
+     */
+    uint32_t indexOf(uint32_t vertexId) const;
+
+    /* Translates a dense index back into the original vertex ID */
+    uint32_t idOf(uint32_t index) const { return data.ids[index]; }
+
+    /* Edge range of a vertex: edges of index u are [edgeBegin(u), edgeEnd(u)) */
+    uint32_t edgeBegin(uint32_t index) const { return data.offsets[index]; }
+    uint32_t edgeEnd(uint32_t index) const { return data.offsets[index + 1]; }
+    uint32_t degree(uint32_t index) const { return data.offsets[index + 1] - data.offsets[index]; }
+
+    /**
+     * Finds the first edge between two vertices.
+     *
+     * @param fromIndex The dense index of the start vertex.
+     * @param toIndex The dense index of the end vertex.
+     * @return The edge index, or kInvalidIndex if there is no such edge.
+     */
+    uint32_t findEdge(uint32_t fromIndex, uint32_t toIndex) const;
+
+    /* Edge data */
+    uint32_t target(uint32_t edge) const { return data.targets[edge]; }
+    double weight(uint32_t edge) const { return data.weights[edge]; }
+
+    /**
+     * Visits the outgoing edges of a vertex in storage order.
+     * Same interface as CompressedAdjacency::forEachEdge, so searches can run on either.
+     *
+     * @param index The dense index of the vertex.
+     * @param visit Callable invoked as visit(targetIndex, weight) for every edge.
+     */
+    template <typename Visitor>
+    void forEachEdge(uint32_t index, Visitor &&visit) const
+    {
+        for (uint32_t edge = data.offsets[index]; edge < data.offsets[index + 1]; ++edge)
+            visit(data.targets[edge], data.weights[edge]);
+    }
+
+    /* Vertex coordinates */
+    double longitude(uint32_t index) const { return data.longitudes[index]; }
+    double latitude(uint32_t index) const { return data.latitudes[index]; }
+
+    /**
+     * Gets the number of bytes held by the CSR arrays.
+     *
+     * @return The memory footprint in bytes.
+     */
+    size_t memoryUsage() const;
+
+    /* Raw views over the CSR arrays, e.g. for serialization */
+    const Arrays &arrays() const { return data; }
+
+private:
+    std::shared_ptr<const void> storage;       // Keeps the memory behind the spans alive
+    std::shared_ptr<const void> weightStorage; // Keeps overlay weights alive after withWeights()
+    uint64_t weightVersion = 0;
+    Arrays data;
+};
+
+#endif
\ No newline at end of file
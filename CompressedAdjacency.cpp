@@ -0,0 +1,70 @@
+#include "CompressedAdjacency.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    void writeVarint(std::vector<uint8_t> &bytes, uint32_t value)
+    {
+        while (value >= 0x80)
+        {
+            bytes.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(value));
+    }
+}
+
+CompressedAdjacency::CompressedAdjacency(const CompactGraph &graph)
+    : edgeCount(graph.edgeCount()), weightVersion(graph.version())
+{
+    const uint32_t n = graph.vertexCount();
+    offsets.reserve(n + 1);
+    bytes.reserve(static_cast<size_t>(graph.edgeCount()) * 4);
+
+    std::vector<std::pair<uint32_t, uint32_t>> edges; // {target, quantized weight} of the current vertex
+    offsets.push_back(0);
+    for (uint32_t u = 0; u < n; ++u)
+    {
+        edges.clear();
+        for (uint32_t edge = graph.edgeBegin(u); edge < graph.edgeEnd(u); ++edge)
+        {
+            edges.emplace_back(graph.target(edge), CentimeterWeights::quantize(graph.weight(edge)));
+        }
+        std::sort(edges.begin(), edges.end());
+
+        uint32_t previous = u;
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            if (i == 0)
+            {
+                int32_t delta = static_cast<int32_t>(edges[i].first - u);
+                writeVarint(bytes, (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31)); // zigzag encode
+            }
+            else
+            {
+                writeVarint(bytes, edges[i].first - previous);
+            }
+            writeVarint(bytes, edges[i].second);
+            previous = edges[i].first;
+        }
+
+        if (bytes.size() > std::numeric_limits<uint32_t>::max())
+        {
+            throw std::runtime_error("Compressed adjacency exceeds 4 GiB");
+        }
+        offsets.push_back(static_cast<uint32_t>(bytes.size()));
+    }
+    bytes.shrink_to_fit();
+}
+
+size_t CompressedAdjacency::memoryUsage() const
+{
+    return offsets.size() * sizeof(uint32_t) + bytes.size();
+}
+
+double CompressedAdjacency::bytesPerEdge() const
+{
+    return edgeCount > 0 ? static_cast<double>(memoryUsage()) / edgeCount : 0.0;
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#ifndef COMPRESSEDADJACENCY_H
+#define COMPRESSEDADJACENCY_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "CompactGraph.h"
+#include "WeightTraits.h"
+
+/**
+ * Compressed adjacency of a CompactGraph for memory-bound workloads.
+ *
+ * The edges of every vertex are sorted by target and stored as a byte stream of
+ * LEB128 varints: the first target as a zigzag delta from the source index, the
+ * following ones as gaps from the previous target, each one followed by the weight
+ * quantized to 1/kWeightScale meters. Road neighbors have close indices (especially
+ * after reordering), so most edges take 2 to 4 bytes instead of 12.
+ */
+class CompressedAdjacency
+{
+public:
+    /* Decoded weights are double-precision meters */
+    using Traits = DoubleWeights;
+
+    /* Quantization step of the weights: centimeters */
+    static constexpr double kWeightScale = CentimeterWeights::kScale;
+
+    /* Constructor & destructor */
+    CompressedAdjacency() = default;
+    ~CompressedAdjacency() = default;
+
+    /**
+     * Encodes the adjacency of a compact graph.
+     * Throws an exception if a weight is negative or too large for the quantization.
+     *
+     * @param graph The compact graph to compress.
+     */
+    explicit CompressedAdjacency(const CompactGraph &graph);
+
+    /**
+     * Decodes the outgoing edges of a vertex sequentially, in increasing target order.
+     *
+     * @param index The dense index of the vertex.
+     * @param visit Callable invoked as visit(targetIndex, weight) for every edge.
+     */
+    template <typename Visitor>
+    void forEachEdge(uint32_t index, Visitor &&visit) const
+    {
+        const uint8_t *position = bytes.data() + offsets[index];
+        const uint8_t *end = bytes.data() + offsets[index + 1];
+        if (position == end)
+            return;
+
+        uint32_t delta = readVarint(position);
+        uint32_t target = index + static_cast<uint32_t>((delta >> 1) ^ -(delta & 1)); // zigzag decode
+        visit(target, dequantize(readVarint(position)));
+        while (position < end)
+        {
+            target += readVarint(position);
+            visit(target, dequantize(readVarint(position)));
+        }
+    }
+
+    /* Weight version of the compact graph the adjacency was built from */
+    uint64_t version() const { return weightVersion; }
+
+    /**
+     * Gets the number of bytes of the compressed adjacency (offsets and byte stream).
+     *
+     * @return The memory footprint in bytes.
+     */
+    size_t memoryUsage() const;
+
+    /**
+     * Gets the average number of bytes used per edge, offsets included.
+     *
+     * @return The bytes per edge.
+     */
+    double bytesPerEdge() const;
+
+private:
+    /* Quantized value reserved for closed (infinite weight) edges */
+    static constexpr uint32_t kInfiniteWeight = CentimeterWeights::kClosed;
+
+    std::vector<uint32_t> offsets; // vertexCount + 1 byte offsets into bytes
+    std::vector<uint8_t> bytes;    // Varint-encoded target deltas and weights
+    uint32_t edgeCount = 0;
+    uint64_t weightVersion = 0;
+
+    static uint32_t readVarint(const uint8_t *&position)
+    {
+        uint32_t value = *position & 0x7F;
+        for (int shift = 7; *position++ & 0x80; shift += 7)
+            value |= static_cast<uint32_t>(*position & 0x7F) << shift;
+        return value;
+    }
+
+    static double dequantize(uint32_t quantized)
+    {
+        return quantized == kInfiniteWeight ? std::numeric_limits<double>::infinity() : quantized / kWeightScale;
+    }
+};
+
+#endif
\ No newline at end of file
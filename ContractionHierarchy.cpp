@@ -0,0 +1,312 @@
+#include "ContractionHierarchy.h"
+#include "DaryHeap.h"
+#include "SearchWorkspace.h"
+#include "WeightTraits.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+    // Witness searches give up (and keep the shortcut) after settling this many vertices. Estimating
+    // priorities with a short search is much faster and barely changes the order.
+    constexpr uint32_t kPrioritySettleLimit = 20;
+    constexpr uint32_t kContractionSettleLimit = 500;
+
+    // Edge between two vertices not contracted yet; middle is the vertex a shortcut bypasses
+    struct Arc
+    {
+        uint32_t other;
+        double weight;
+        uint32_t middle;
+    };
+
+    struct Shortcut
+    {
+        uint32_t from;
+        uint32_t to;
+        double weight;
+    };
+
+    // Graph of the vertices not contracted yet, with the incoming and outgoing arcs of every vertex
+    struct OverlayGraph
+    {
+        std::vector<std::vector<Arc>> out;
+        std::vector<std::vector<Arc>> in;
+
+        // Inserts the arc from -> to or lowers its weight; parallel arcs are merged
+        void addArc(uint32_t from, uint32_t to, double weight, uint32_t middle)
+        {
+            auto update = [&](std::vector<Arc> &arcs, uint32_t other)
+            {
+                for (Arc &arc : arcs)
+                {
+                    if (arc.other == other)
+                    {
+                        if (weight < arc.weight)
+                            arc = {other, weight, middle};
+                        return;
+                    }
+                }
+                arcs.push_back({other, weight, middle});
+            };
+            update(out[from], to);
+            update(in[to], from);
+        }
+
+        static void removeArc(std::vector<Arc> &arcs, uint32_t other)
+        {
+            arcs.erase(std::remove_if(arcs.begin(), arcs.end(), [&](const Arc &arc)
+                                      { return arc.other == other; }),
+                       arcs.end());
+        }
+    };
+
+    // Per-thread state of the witness searches
+    struct WitnessSearch
+    {
+        SearchWorkspace workspace;
+        DaryHeap<double> queue;
+    };
+
+    /**
+     * Finds the shortcuts needed to contract v: for every pair of neighbors u -> v -> x, a
+     * local Dijkstra from u that avoids v and the other vertices being contracted looks for
+     * a witness path at most as short as u -> v -> x, settling at most settleLimit vertices.
+     */
+    std::vector<Shortcut> findShortcuts(const OverlayGraph &overlay, uint32_t v, const std::vector<char> &contracting,
+                                        WitnessSearch &search, uint32_t settleLimit)
+    {
+        std::vector<Shortcut> shortcuts;
+        const std::vector<Arc> &outArcs = overlay.out[v];
+        for (const Arc &incoming : overlay.in[v])
+        {
+            uint32_t u = incoming.other;
+            double limit = -1.0; // Stays negative only if v has no out-neighbor other than u; 0 is a valid path length
+            for (const Arc &outgoing : outArcs)
+            {
+                if (outgoing.other != u)
+                    limit = std::max(limit, incoming.weight + outgoing.weight);
+            }
+            if (limit < 0.0)
+                continue;
+
+            search.workspace.begin<DoubleWeights>(static_cast<uint32_t>(overlay.out.size()));
+            search.queue.clear(static_cast<uint32_t>(overlay.out.size()));
+            search.workspace.reach(u, 0.0, CompactGraph::kInvalidIndex);
+            search.queue.push(u, 0.0);
+            uint32_t settledCount = 0;
+            size_t targetsLeft = outArcs.size(); // The search is over once every out-neighbor of v is settled
+            while (!search.queue.empty() && settledCount < settleLimit && targetsLeft > 0)
+            {
+                uint32_t current = search.queue.pop();
+                double distance = search.workspace.distance<DoubleWeights>(current);
+                if (distance > limit)
+                    break;
+                search.workspace.settle(current);
+                settledCount++;
+                for (const Arc &outgoing : outArcs)
+                    targetsLeft -= outgoing.other == current;
+                for (const Arc &arc : overlay.out[current])
+                {
+                    if (arc.other == v || contracting[arc.other])
+                        continue;
+                    double updated = distance + arc.weight;
+                    if (updated < search.workspace.distance<DoubleWeights>(arc.other))
+                    {
+                        search.workspace.reach(arc.other, updated, current);
+                        search.queue.push(arc.other, updated);
+                    }
+                }
+            }
+
+            for (const Arc &outgoing : outArcs)
+            {
+                double through = incoming.weight + outgoing.weight;
+                if (outgoing.other != u && search.workspace.distance<DoubleWeights>(outgoing.other) > through)
+                    shortcuts.push_back({u, outgoing.other, through});
+            }
+        }
+        return shortcuts;
+    }
+
+    // Calls work(search, i) for every i in [0, count) on threadCount threads, each with its own witness search
+    template <typename Work>
+    void parallelFor(size_t count, unsigned threadCount, std::vector<WitnessSearch> &searches, Work &&work)
+    {
+        std::atomic<size_t> next{0};
+        auto worker = [&](WitnessSearch &search)
+        {
+            for (size_t i = next++; i < count; i = next++)
+                work(search, i);
+        };
+        std::vector<std::thread> threads;
+        for (unsigned t = 1; t < threadCount; ++t)
+            threads.emplace_back(worker, std::ref(searches[t]));
+        worker(searches[0]);
+        for (std::thread &thread : threads)
+            thread.join();
+    }
+
+    // Converts the arcs kept at contraction time into a CSR search graph
+    ContractionHierarchy::SearchGraph toSearchGraph(const std::vector<std::vector<Arc>> &arcs, size_t &shortcuts)
+    {
+        ContractionHierarchy::SearchGraph graph;
+        graph.offsets.reserve(arcs.size() + 1);
+        graph.offsets.push_back(0);
+        for (const std::vector<Arc> &vertexArcs : arcs)
+        {
+            for (const Arc &arc : vertexArcs)
+            {
+                graph.targets.push_back(arc.other);
+                graph.weights.push_back(arc.weight);
+                graph.middles.push_back(arc.middle);
+                if (arc.middle != CompactGraph::kInvalidIndex)
+                    shortcuts++;
+            }
+            graph.offsets.push_back(static_cast<uint32_t>(graph.targets.size()));
+        }
+        return graph;
+    }
+}
+
+ContractionHierarchy::ContractionHierarchy(const CompactGraph &graph, unsigned threadCount)
+    : weightVersion(graph.version())
+{
+    const uint32_t n = graph.vertexCount();
+    OverlayGraph overlay;
+    overlay.out.resize(n);
+    overlay.in.resize(n);
+    for (uint32_t u = 0; u < n; ++u)
+    {
+        graph.forEachEdge(u, [&](uint32_t v, double weight)
+                          {
+            if (v != u && std::isfinite(weight))
+                overlay.addArc(u, v, weight, CompactGraph::kInvalidIndex); });
+    }
+
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<WitnessSearch> searches(threadCount);
+
+    std::vector<std::vector<Arc>> upArcs(n), downArcs(n);
+    std::vector<int64_t> priority(n, 0);
+    std::vector<uint32_t> contractedNeighbors(n, 0);
+    std::vector<char> dirty(n, 1), contracting(n, 0), contracted(n, 0);
+    std::vector<uint32_t> remaining(n);
+    for (uint32_t v = 0; v < n; ++v)
+        remaining[v] = v;
+    ranks.assign(n, 0);
+    uint32_t nextRank = 0;
+
+    while (!remaining.empty())
+    {
+        // Priorities of the vertices whose neighborhood changed: 2 * edge difference + contracted neighbors
+        std::vector<uint32_t> stale;
+        for (uint32_t v : remaining)
+        {
+            if (dirty[v])
+                stale.push_back(v);
+        }
+        parallelFor(stale.size(), threadCount, searches, [&](WitnessSearch &search, size_t i)
+                    {
+            uint32_t v = stale[i];
+            int64_t added = static_cast<int64_t>(findShortcuts(overlay, v, contracting, search, kPrioritySettleLimit).size());
+            int64_t removed = static_cast<int64_t>(overlay.in[v].size() + overlay.out[v].size());
+            priority[v] = 2 * (added - removed) + contractedNeighbors[v];
+            dirty[v] = 0; });
+
+        // Independent set: vertices of smaller priority than all their neighbors (ties broken by index)
+        auto before = [&](uint32_t a, uint32_t b)
+        { return priority[a] < priority[b] || (priority[a] == priority[b] && a < b); };
+        std::vector<uint32_t> selected;
+        for (uint32_t v : remaining)
+        {
+            bool isMinimum = true;
+            for (const std::vector<Arc> *arcs : {&overlay.in[v], &overlay.out[v]})
+            {
+                for (const Arc &arc : *arcs)
+                    isMinimum = isMinimum && before(v, arc.other);
+            }
+            if (isMinimum)
+                selected.push_back(v);
+        }
+
+        // Witness searches of the set run in parallel and avoid all of its vertices
+        for (uint32_t v : selected)
+            contracting[v] = 1;
+        std::vector<std::vector<Shortcut>> added(selected.size());
+        parallelFor(selected.size(), threadCount, searches, [&](WitnessSearch &search, size_t i)
+                    { added[i] = findShortcuts(overlay, selected[i], contracting, search, kContractionSettleLimit); });
+
+        for (size_t i = 0; i < selected.size(); ++i)
+        {
+            uint32_t v = selected[i];
+            ranks[v] = nextRank++;
+            upArcs[v] = std::move(overlay.out[v]);
+            downArcs[v] = std::move(overlay.in[v]);
+            overlay.out[v].clear();
+            overlay.in[v].clear();
+            for (const Arc &arc : upArcs[v])
+            {
+                OverlayGraph::removeArc(overlay.in[arc.other], v);
+                dirty[arc.other] = 1;
+                contractedNeighbors[arc.other]++;
+            }
+            for (const Arc &arc : downArcs[v])
+            {
+                OverlayGraph::removeArc(overlay.out[arc.other], v);
+                dirty[arc.other] = 1;
+                contractedNeighbors[arc.other]++;
+            }
+            for (const Shortcut &shortcut : added[i])
+                overlay.addArc(shortcut.from, shortcut.to, shortcut.weight, v);
+            contracting[v] = 0;
+            contracted[v] = 1;
+        }
+
+        remaining.erase(std::remove_if(remaining.begin(), remaining.end(), [&](uint32_t v)
+                                       { return contracted[v]; }),
+                        remaining.end());
+    }
+
+    up = toSearchGraph(upArcs, shortcuts);
+    down = toSearchGraph(downArcs, shortcuts);
+}
+
+void ContractionHierarchy::unpack(uint32_t fromIndex, uint32_t toIndex, std::vector<uint32_t> &path) const
+{
+    // The edge is stored at its lower-ranked end
+    uint32_t middle = CompactGraph::kInvalidIndex;
+    const SearchGraph &graph = ranks[toIndex] > ranks[fromIndex] ? up : down;
+    uint32_t at = ranks[toIndex] > ranks[fromIndex] ? fromIndex : toIndex;
+    uint32_t other = ranks[toIndex] > ranks[fromIndex] ? toIndex : fromIndex;
+    for (uint32_t edge = graph.offsets[at]; edge < graph.offsets[at + 1]; ++edge)
+    {
+        if (graph.targets[edge] == other)
+        {
+            middle = graph.middles[edge];
+            break;
+        }
+    }
+
+    if (middle == CompactGraph::kInvalidIndex)
+    {
+        path.push_back(toIndex);
+        return;
+    }
+    unpack(fromIndex, middle, path);
+    unpack(middle, toIndex, path);
+}
+
+size_t ContractionHierarchy::memoryUsage() const
+{
+    size_t bytes = ranks.size() * sizeof(uint32_t);
+    for (const SearchGraph *graph : {&up, &down})
+    {
+        bytes += (graph->offsets.size() + graph->targets.size() + graph->middles.size()) * sizeof(uint32_t) +
+                 graph->weights.size() * sizeof(double);
+    }
+    return bytes;
+}
@@ -0,0 +1,98 @@
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CompactGraph.h"
+
+/**
+ * Contraction Hierarchy of a CompactGraph, for shortest path queries that settle only a few
+ * hundred vertices.
+ *
+ * Vertices are contracted one independent set at a time in the order given by their edge
+ * difference (shortcuts added minus edges removed) and their number of contracted neighbors.
+ * Contracting a vertex adds a shortcut between two of its neighbors unless a witness search
+ * finds a path at most as short around it. The rank of a vertex is its contraction order.
+ *
+ * The result is stored as two CSR search graphs over the dense indices of the CompactGraph:
+ * the upward graph holds the edges v -> w with rank(w) > rank(v) at v, the downward graph the
+ * edges w -> v with rank(w) > rank(v), also at v, pointing to w. A query runs a forward search
+ * on the upward graph and a backward search on the downward graph. Every shortcut records the
+ * vertex it bypasses, so that paths can be unpacked to original edges.
+ * The hierarchy holds the double weights of one weight version and is rebuilt when they change.
+ */
+class ContractionHierarchy
+{
+public:
+    /* CSR search graph with the bypassed vertex of every edge (kInvalidIndex for original edges) */
+    struct SearchGraph
+    {
+        std::vector<uint32_t> offsets; // vertexCount() + 1 entries into the edge arrays
+        std::vector<uint32_t> targets;
+        std::vector<double> weights;
+        std::vector<uint32_t> middles;
+
+        /**
+         * Visits the edges of a vertex, with the same interface as CompactGraph::forEachEdge.
+         *
+         * @param index The dense index of the vertex.
+         * @param visit Callable invoked as visit(targetIndex, weight) for every edge.
+         */
+        template <typename Visitor>
+        void forEachEdge(uint32_t index, Visitor &&visit) const
+        {
+            for (uint32_t edge = offsets[index]; edge < offsets[index + 1]; ++edge)
+                visit(targets[edge], weights[edge]);
+        }
+    };
+
+    /* Constructor & destructor */
+    ContractionHierarchy() = default;
+    ~ContractionHierarchy() = default;
+
+    /**
+     * Contracts the graph. Priorities and witness searches of an independent set run in parallel.
+     *
+     * @param graph The compact graph; closed (infinite) edges are left out.
+     * @param threadCount The number of threads to use; 0 picks one per hardware thread.
+     */
+    explicit ContractionHierarchy(const CompactGraph &graph, unsigned threadCount = 0);
+
+    /* Search graphs of the queries */
+    const SearchGraph &upward() const { return up; }
+    const SearchGraph &downward() const { return down; }
+
+    /* Contraction order of a vertex, and weight version the hierarchy was built from */
+    uint32_t rank(uint32_t index) const { return ranks[index]; }
+    uint64_t version() const { return weightVersion; }
+
+    /* Number of vertices and of shortcuts in both search graphs */
+    uint32_t vertexCount() const { return static_cast<uint32_t>(ranks.size()); }
+    size_t shortcutCount() const { return shortcuts; }
+
+    /**
+     * Unpacks a search graph edge into the original edges it stands for.
+     *
+     * @param fromIndex The dense index of the tail of the edge.
+     * @param toIndex The dense index of its head.
+     * @param path The vertices after fromIndex up to toIndex are appended to it.
+     */
+    void unpack(uint32_t fromIndex, uint32_t toIndex, std::vector<uint32_t> &path) const;
+
+    /**
+     * Gets the number of bytes held by the search graphs and the ranks.
+     *
+     * @return The memory footprint in bytes.
+     */
+    size_t memoryUsage() const;
+
+private:
+    std::vector<uint32_t> ranks;
+    SearchGraph up;
+    SearchGraph down;
+    size_t shortcuts = 0;
+    uint64_t weightVersion = 0;
+};
+
+#endif
\ No newline at end of file
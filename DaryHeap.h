@@ -0,0 +1,150 @@
+#ifndef DARYHEAP_H
+#define DARYHEAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * Indexed d-ary min-heap of dense vertex indices with a real decrease-key.
+ *
+ * The position of every queued vertex is tracked, so push() on a queued vertex moves
+ * it up in place instead of inserting a duplicate. Entries are ordered by key, then by
+ * index, which pops vertices in exactly the order of a std::set of {key, index} pairs.
+ * A wider node (Arity 4) halves the depth of the heap and keeps the children of a
+ * node in one cache line.
+ */
+template <typename Key, unsigned Arity = 4>
+class DaryHeap
+{
+public:
+    /* Constructor & destructor */
+    DaryHeap() = default;
+    ~DaryHeap() = default;
+
+    /**
+     * Empties the heap for a query on a graph of the given size.
+     * Only the positions of the vertices still queued are reset.
+     *
+     * @param vertexCount The number of vertices of the graph.
+     */
+    void clear(uint32_t vertexCount)
+    {
+        if (position.size() != vertexCount)
+            position.assign(vertexCount, kAbsent);
+        else
+            for (const Entry &entry : heap)
+                position[entry.index] = kAbsent;
+        heap.clear();
+    }
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+
+    /**
+     * Inserts a vertex, or lowers its key if it is already queued with a larger one.
+     *
+     * @param index The dense index of the vertex.
+     * @param key The priority of the vertex.
+     */
+    void push(uint32_t index, Key key)
+    {
+        uint32_t at = position[index];
+        if (at == kAbsent)
+        {
+            at = static_cast<uint32_t>(heap.size());
+            heap.push_back({key, index});
+        }
+        else if (key < heap[at].key)
+        {
+            heap[at].key = key;
+        }
+        else
+        {
+            return; // Not a decrease
+        }
+        siftUp(at);
+    }
+
+    /**
+     * Removes the vertex with the smallest key.
+     *
+     * @return The dense index of the vertex.
+     */
+    uint32_t pop()
+    {
+        uint32_t index = heap.front().index;
+        position[index] = kAbsent;
+        Entry last = heap.back();
+        heap.pop_back();
+        if (!heap.empty())
+        {
+            heap.front() = last;
+            siftDown(0);
+        }
+        return index;
+    }
+
+private:
+    static constexpr uint32_t kAbsent = std::numeric_limits<uint32_t>::max();
+
+    struct Entry
+    {
+        Key key;
+        uint32_t index;
+
+        bool operator<(const Entry &other) const
+        {
+            return key < other.key || (key == other.key && index < other.index);
+        }
+    };
+
+    std::vector<Entry> heap;
+    std::vector<uint32_t> position; // Heap slot of every queued vertex, kAbsent otherwise
+
+    void place(uint32_t at, const Entry &entry)
+    {
+        heap[at] = entry;
+        position[entry.index] = at;
+    }
+
+    void siftUp(uint32_t at)
+    {
+        Entry entry = heap[at];
+        while (at > 0)
+        {
+            uint32_t parent = (at - 1) / Arity;
+            if (!(entry < heap[parent]))
+                break;
+            place(at, heap[parent]);
+            at = parent;
+        }
+        place(at, entry);
+    }
+
+    void siftDown(uint32_t at)
+    {
+        Entry entry = heap[at];
+        const size_t count = heap.size();
+        while (true)
+        {
+            size_t first = static_cast<size_t>(at) * Arity + 1;
+            if (first >= count)
+                break;
+            size_t best = first;
+            for (size_t child = first + 1; child < first + Arity && child < count; ++child)
+            {
+                if (heap[child] < heap[best])
+                    best = child;
+            }
+            if (!(heap[best] < entry))
+                break;
+            place(at, heap[best]);
+            at = static_cast<uint32_t>(best);
+        }
+        place(at, entry);
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include "DeltaStepping.h"
+#include "DaryHeap.h"
+#include <algorithm>
+#include <barrier>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace
+{
+    constexpr double kInfinity = std::numeric_limits<double>::infinity();
+    constexpr size_t kNoBucket = std::numeric_limits<size_t>::max();
+
+    // Relaxation of an edge, sent to the thread owning its head
+    struct Request
+    {
+        uint32_t vertex;
+        uint32_t parent;
+        double distance;
+    };
+
+    // State owned by one thread: the buckets of its vertices and its outgoing requests per owner
+    struct Worker
+    {
+        std::vector<std::vector<uint32_t>> buckets;
+        std::vector<uint32_t> settled;              // Vertices removed from the current bucket, for the heavy phase
+        std::vector<std::vector<Request>> outboxes; // One buffer per destination thread
+        size_t smallestBucket = kNoBucket;          // Proposal for the next bucket
+        bool bucketLeft = false;                    // The current bucket was refilled
+    };
+}
+
+double sssp::chooseDelta(const CompactGraph &graph)
+{
+    // With delta at this quantile most road segments are light, which keeps the heavy phase
+    // small, while buckets stay narrow enough that few vertices are relaxed more than once
+    constexpr double kLightQuantile = 0.9;
+
+    std::vector<double> weights;
+    weights.reserve(graph.edgeCount());
+    for (uint32_t u = 0; u < graph.vertexCount(); ++u)
+    {
+        graph.forEachEdge(u, [&](uint32_t, double weight)
+                          {
+            if (std::isfinite(weight))
+                weights.push_back(weight); });
+    }
+    if (weights.empty())
+        return 1.0;
+    auto quantile = weights.begin() + static_cast<ptrdiff_t>((weights.size() - 1) * kLightQuantile);
+    std::nth_element(weights.begin(), quantile, weights.end());
+    return std::max(*quantile, 1e-3);
+}
+
+sssp::ShortestPathTree sssp::deltaStepping(const CompactGraph &graph, uint32_t sourceIndex, double delta, unsigned threadCount)
+{
+    const uint32_t n = graph.vertexCount();
+    if (delta <= 0.0)
+        delta = chooseDelta(graph);
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    ShortestPathTree tree{std::vector<double>(n, kInfinity), std::vector<uint32_t>(n, CompactGraph::kInvalidIndex)};
+    if (sourceIndex >= n)
+        return tree;
+
+    std::vector<Worker> workers(threadCount);
+    for (Worker &worker : workers)
+        worker.outboxes.resize(threadCount);
+    auto owner = [&](uint32_t v)
+    { return v % threadCount; };
+    auto bucketOf = [&](double distance)
+    { return static_cast<size_t>(distance / delta); };
+
+    tree.distances[sourceIndex] = 0.0;
+    workers[owner(sourceIndex)].buckets.push_back({sourceIndex});
+
+    // Aggregates the proposals of all threads once they all reached the barrier
+    size_t currentBucket = kNoBucket;
+    bool bucketLeft = false;
+    std::barrier sync(static_cast<ptrdiff_t>(threadCount), [&]() noexcept
+                      {
+        currentBucket = kNoBucket;
+        bucketLeft = false;
+        for (const Worker &worker : workers)
+        {
+            currentBucket = std::min(currentBucket, worker.smallestBucket);
+            bucketLeft = bucketLeft || worker.bucketLeft;
+        } });
+
+    auto run = [&](unsigned t)
+    {
+        Worker &self = workers[t];
+        std::vector<char> inSettled(n, 0); // Only entries of owned vertices are used
+
+        // Sends the relaxations of the edges of u selected by isLight to their owners
+        auto relaxEdges = [&](uint32_t u, bool light)
+        {
+            double distance = tree.distances[u];
+            graph.forEachEdge(u, [&](uint32_t v, double weight)
+                              {
+                if ((weight <= delta) == light && std::isfinite(weight))
+                    self.outboxes[owner(v)].push_back({v, u, distance + weight}); });
+        };
+        // Applies the requests addressed to this thread
+        auto applyRequests = [&]()
+        {
+            for (Worker &sender : workers)
+            {
+                for (const Request &request : sender.outboxes[t])
+                {
+                    if (request.distance < tree.distances[request.vertex])
+                    {
+                        tree.distances[request.vertex] = request.distance;
+                        tree.parents[request.vertex] = request.parent;
+                        size_t bucket = bucketOf(request.distance);
+                        if (bucket >= self.buckets.size())
+                            self.buckets.resize(bucket + 1);
+                        self.buckets[bucket].push_back(request.vertex);
+                    }
+                }
+            }
+        };
+        // Requests are read by their owner after a barrier, and cleared by their sender after the next one
+        auto clearOutboxes = [&]()
+        {
+            for (std::vector<Request> &outbox : self.outboxes)
+                outbox.clear();
+        };
+
+        size_t from = 0;
+        while (true)
+        {
+            self.smallestBucket = kNoBucket;
+            for (size_t b = from; b < self.buckets.size(); ++b)
+            {
+                if (!self.buckets[b].empty())
+                {
+                    self.smallestBucket = b;
+                    break;
+                }
+            }
+            sync.arrive_and_wait();
+            const size_t bucket = currentBucket;
+            if (bucket == kNoBucket)
+                break;
+
+            // Light phases: empty the bucket until no relaxation refills it
+            for (uint32_t u : self.settled)
+                inSettled[u] = 0;
+            self.settled.clear();
+            while (true)
+            {
+                std::vector<uint32_t> frontier;
+                if (bucket < self.buckets.size())
+                    frontier.swap(self.buckets[bucket]);
+                for (uint32_t u : frontier)
+                {
+                    if (bucketOf(tree.distances[u]) != bucket)
+                        continue; // Moved to a smaller bucket since it was queued here
+                    if (!inSettled[u])
+                    {
+                        inSettled[u] = 1;
+                        self.settled.push_back(u);
+                    }
+                    relaxEdges(u, true);
+                }
+                sync.arrive_and_wait();
+                applyRequests();
+                self.bucketLeft = bucket < self.buckets.size() && !self.buckets[bucket].empty();
+                sync.arrive_and_wait();
+                clearOutboxes();
+                if (!bucketLeft)
+                    break;
+            }
+
+            // Heavy phase: heavy edges lead to later buckets, so they are relaxed once
+            for (uint32_t u : self.settled)
+                relaxEdges(u, false);
+            sync.arrive_and_wait();
+            applyRequests();
+            sync.arrive_and_wait();
+            clearOutboxes();
+            from = bucket + 1;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < threadCount; ++t)
+        threads.emplace_back(run, t);
+    run(0);
+    for (std::thread &thread : threads)
+        thread.join();
+    return tree;
+}
+
+sssp::ShortestPathTree sssp::dijkstra(const CompactGraph &graph, uint32_t sourceIndex)
+{
+    const uint32_t n = graph.vertexCount();
+    ShortestPathTree tree{std::vector<double>(n, kInfinity), std::vector<uint32_t>(n, CompactGraph::kInvalidIndex)};
+    if (sourceIndex >= n)
+        return tree;
+
+    DaryHeap<double> queue;
+    queue.clear(n);
+    tree.distances[sourceIndex] = 0.0;
+    queue.push(sourceIndex, 0.0);
+    while (!queue.empty())
+    {
+        uint32_t u = queue.pop();
+        graph.forEachEdge(u, [&](uint32_t v, double weight)
+                          {
+            double updated = tree.distances[u] + weight;
+            if (updated < tree.distances[v])
+            {
+                tree.distances[v] = updated;
+                tree.parents[v] = u;
+                queue.push(v, updated);
+            } });
+    }
+    return tree;
+}
+
+size_t sssp::verify(const CompactGraph &graph, const ShortestPathTree &tree, const ShortestPathTree &reference)
+{
+    // Equally short paths summed in another order may differ in the last bits
+    auto close = [](double a, double b)
+    { return a == b || std::abs(a - b) <= 1e-9 * std::max(std::abs(a), std::abs(b)); };
+
+    size_t failures = 0;
+    for (uint32_t v = 0; v < graph.vertexCount(); ++v)
+    {
+        bool valid = close(tree.distances[v], reference.distances[v]);
+        uint32_t parent = tree.parents[v];
+        if (valid && parent != CompactGraph::kInvalidIndex)
+        {
+            // The parent edge must close the distance; parallel edges may differ, so any one matching is fine
+            bool onShortestPath = false;
+            graph.forEachEdge(parent, [&](uint32_t target, double weight)
+                              { onShortestPath = onShortestPath || (target == v && close(tree.distances[parent] + weight, tree.distances[v])); });
+            valid = onShortestPath;
+        }
+        else if (valid)
+            valid = tree.distances[v] == 0.0 || tree.distances[v] == kInfinity; // Only the source and unreachable vertices
+        failures += !valid;
+    }
+    return failures;
+}
\ No newline at end of file
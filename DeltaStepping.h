@@ -0,0 +1,70 @@
+#ifndef DELTASTEPPING_H
+#define DELTASTEPPING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CompactGraph.h"
+
+/**
+ * One-to-all shortest paths (full shortest path trees), e.g. for coverage analysis.
+ *
+ * deltaStepping() is the parallel engine: tentative distances are kept in buckets of width
+ * delta, and the smallest bucket is emptied in phases that relax all its light edges
+ * (weight <= delta) at once, its heavy edges once it is empty. Every vertex is owned by one
+ * thread, which alone updates its distance and buckets: relaxations are written to
+ * thread-local request buffers and applied by the owner after a barrier, so no atomics are
+ * needed. dijkstra() is the sequential reference the results are verified against.
+ */
+namespace sssp
+{
+    /* Distance and parent of every dense vertex index */
+    struct ShortestPathTree
+    {
+        std::vector<double> distances; // Meters, infinity if unreachable
+        std::vector<uint32_t> parents; // kInvalidIndex for the source and unreachable vertices
+    };
+
+    /**
+     * @brief Chooses the bucket width from the edge weight distribution: light edges must be
+     * frequent enough to expose parallelism, buckets wide enough to keep the number of phases low.
+     *
+     * @param graph The compact graph.
+     * @return The bucket width in meters.
+     */
+    double chooseDelta(const CompactGraph &graph);
+
+    /**
+     * @brief Computes the shortest path tree of a source with parallel delta-stepping.
+     *
+     * @param graph The compact graph.
+     * @param sourceIndex The dense index of the source.
+     * @param delta The bucket width in meters; 0 picks chooseDelta().
+     * @param threadCount The number of threads to use; 0 picks one per hardware thread.
+     * @return The distances and parents.
+     */
+    ShortestPathTree deltaStepping(const CompactGraph &graph, uint32_t sourceIndex, double delta = 0.0,
+                                   unsigned threadCount = 0);
+
+    /**
+     * @brief Computes the shortest path tree of a source with a sequential Dijkstra search.
+     *
+     * @param graph The compact graph.
+     * @param sourceIndex The dense index of the source.
+     * @return The distances and parents.
+     */
+    ShortestPathTree dijkstra(const CompactGraph &graph, uint32_t sourceIndex);
+
+    /**
+     * @brief Checks a tree against a reference: distances must match (up to rounding of equally
+     * short paths summed in another order) and every parent must lie on a shortest path.
+     *
+     * @param graph The compact graph.
+     * @param tree The tree to check.
+     * @param reference The reference tree, e.g. from dijkstra().
+     * @return The number of vertices failing the check.
+     */
+    size_t verify(const CompactGraph &graph, const ShortestPathTree &tree, const ShortestPathTree &reference);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include "DistanceMatrix.h"
+#include "DaryHeap.h"
+#include "SearchWorkspace.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    constexpr char kMagic[8] = {'M', 'P', 'F', 'D', 'M', 'A', 'T', '\0'};
+
+    // Per-thread search state
+    struct SearchState
+    {
+        SearchWorkspace workspace;
+        DaryHeap<double> queue;
+    };
+
+    // Distance of a target left in the bucket of a vertex by its backward search
+    struct BucketEntry
+    {
+        uint32_t target; // Column of the target
+        double distance;
+    };
+
+    // Calls work(state, i) for every i in [0, count) on threadCount threads, each with its own search state
+    template <typename Work>
+    void parallelFor(size_t count, unsigned threadCount, Work &&work)
+    {
+        std::atomic<size_t> next{0};
+        auto worker = [&]()
+        {
+            SearchState state;
+            for (size_t i = next++; i < count; i = next++)
+                work(state, i);
+        };
+        std::vector<std::thread> threads;
+        for (unsigned t = 1; t < threadCount && t < count; ++t)
+            threads.emplace_back(worker);
+        worker();
+        for (std::thread &thread : threads)
+            thread.join();
+    }
+
+    std::vector<uint32_t> toIndices(const CompactGraph &compact, const std::vector<uint32_t> &ids)
+    {
+        std::vector<uint32_t> indices;
+        indices.reserve(ids.size());
+        for (uint32_t id : ids)
+        {
+            uint32_t index = compact.indexOf(id);
+            if (index == CompactGraph::kInvalidIndex)
+                throw std::runtime_error("Error: vertex " + std::to_string(id) + " not found in the graph.");
+            indices.push_back(index);
+        }
+        return indices;
+    }
+
+    /**
+     * Runs a Dijkstra search from source on the adjacency and calls onSettle(index, distance) for
+     * every settled vertex, until the queue is empty or onSettle returns false.
+     */
+    template <typename Adjacency, typename OnSettle>
+    void search(const Adjacency &adjacency, uint32_t vertexCount, uint32_t source, SearchState &state, OnSettle &&onSettle)
+    {
+        SearchWorkspace &workspace = state.workspace;
+        workspace.begin<DoubleWeights>(vertexCount);
+        state.queue.clear(vertexCount);
+        workspace.reach(source, 0.0, CompactGraph::kInvalidIndex);
+        state.queue.push(source, 0.0);
+        while (!state.queue.empty())
+        {
+            uint32_t current = state.queue.pop();
+            double distance = workspace.distance<DoubleWeights>(current);
+            workspace.settle(current);
+            if (!onSettle(current, distance))
+                return;
+            adjacency.forEachEdge(current, [&](uint32_t neighbor, double weight)
+                                  {
+                double updated = distance + weight;
+                if (updated < workspace.distance<DoubleWeights>(neighbor))
+                {
+                    workspace.reach(neighbor, updated, current);
+                    state.queue.push(neighbor, updated);
+                } });
+        }
+    }
+
+    // One-to-many Dijkstra per source, stopped once every target is settled
+    void computeWithDijkstra(const CompactGraph &compact, const std::vector<uint32_t> &sources,
+                             const std::vector<uint32_t> &targets, unsigned threadCount, std::vector<double> &distances)
+    {
+        std::vector<char> isTarget(compact.vertexCount(), 0);
+        size_t distinctTargets = 0;
+        for (uint32_t target : targets)
+        {
+            distinctTargets += !isTarget[target];
+            isTarget[target] = 1;
+        }
+
+        parallelFor(sources.size(), threadCount, [&](SearchState &state, size_t i)
+                    {
+            size_t remaining = distinctTargets;
+            search(compact, compact.vertexCount(), sources[i], state, [&](uint32_t index, double)
+                   { return !isTarget[index] || --remaining > 0; });
+            for (size_t j = 0; j < targets.size(); ++j)
+                distances[i * targets.size() + j] = state.workspace.distance<DoubleWeights>(targets[j]); });
+    }
+
+    // Bucket many-to-many on the upward and downward graphs of a contraction hierarchy
+    void computeWithBuckets(const ContractionHierarchy &hierarchy, const std::vector<uint32_t> &sources,
+                            const std::vector<uint32_t> &targets, unsigned threadCount, std::vector<double> &distances)
+    {
+        const uint32_t n = hierarchy.vertexCount();
+
+        // Backward upward searches, one per target; their settled vertices are gathered into buckets
+        std::vector<std::vector<std::pair<uint32_t, BucketEntry>>> spaces(targets.size());
+        parallelFor(targets.size(), threadCount, [&](SearchState &state, size_t j)
+                    { search(hierarchy.downward(), n, targets[j], state, [&](uint32_t index, double distance)
+                             {
+                spaces[j].push_back({index, {static_cast<uint32_t>(j), distance}});
+                return true; }); });
+
+        std::vector<size_t> offsets(n + 1, 0);
+        for (const auto &space : spaces)
+        {
+            for (const auto &[index, entry] : space)
+                offsets[index + 1]++;
+        }
+        for (uint32_t v = 0; v < n; ++v)
+            offsets[v + 1] += offsets[v];
+        std::vector<BucketEntry> buckets(offsets[n]);
+        std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+        for (auto &space : spaces)
+        {
+            for (const auto &[index, entry] : space)
+                buckets[fill[index]++] = entry;
+            std::vector<std::pair<uint32_t, BucketEntry>>().swap(space);
+        }
+
+        // Forward upward searches, one per source, scanning the buckets of the vertices they settle
+        parallelFor(sources.size(), threadCount, [&](SearchState &state, size_t i)
+                    {
+            double *row = distances.data() + i * targets.size();
+            search(hierarchy.upward(), n, sources[i], state, [&](uint32_t index, double distance)
+                   {
+                for (size_t b = offsets[index]; b < offsets[index + 1]; ++b)
+                    row[buckets[b].target] = std::min(row[buckets[b].target], distance + buckets[b].distance);
+                return true; }); });
+    }
+}
+
+matrix::DistanceTable matrix::compute(const Graph &graph, const std::vector<uint32_t> &sources,
+                                      const std::vector<uint32_t> &targets, unsigned threadCount)
+{
+    Graph::SearchView view = graph.getSearchView(); // Pinned for the whole table, even if weights are updated
+    std::vector<uint32_t> sourceIndices = toIndices(view.compact, sources);
+    std::vector<uint32_t> targetIndices = toIndices(view.compact, targets);
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    DistanceTable table{sources, targets, std::vector<double>(sources.size() * targets.size(), std::numeric_limits<double>::infinity())};
+    if (view.hierarchy)
+        computeWithBuckets(*view.hierarchy, sourceIndices, targetIndices, threadCount, table.distances);
+    else
+        computeWithDijkstra(view.compact, sourceIndices, targetIndices, threadCount, table.distances);
+    return table;
+}
+
+void matrix::writeCsv(const DistanceTable &table, std::ostream &out)
+{
+    out << "source";
+    for (uint32_t target : table.targets)
+        out << ',' << target;
+    out << '\n'
+        << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < table.sources.size(); ++i)
+    {
+        out << table.sources[i];
+        for (size_t j = 0; j < table.targets.size(); ++j)
+        {
+            double distance = table.at(i, j);
+            if (distance == std::numeric_limits<double>::infinity())
+                out << ",inf";
+            else
+                out << ',' << distance;
+        }
+        out << '\n';
+    }
+    out.flush();
+}
+
+void matrix::writeBinary(const DistanceTable &table, const std::string &filename)
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Error: could not open file " + filename + " for writing");
+    }
+
+    uint32_t rows = static_cast<uint32_t>(table.sources.size());
+    uint32_t columns = static_cast<uint32_t>(table.targets.size());
+    file.write(kMagic, sizeof(kMagic));
+    file.write(reinterpret_cast<const char *>(&rows), sizeof(rows));
+    file.write(reinterpret_cast<const char *>(&columns), sizeof(columns));
+    file.write(reinterpret_cast<const char *>(table.sources.data()), static_cast<std::streamsize>(rows * sizeof(uint32_t)));
+    file.write(reinterpret_cast<const char *>(table.targets.data()), static_cast<std::streamsize>(columns * sizeof(uint32_t)));
+    file.write(reinterpret_cast<const char *>(table.distances.data()),
+               static_cast<std::streamsize>(table.distances.size() * sizeof(double)));
+    if (!file)
+    {
+        throw std::runtime_error("Error: could not write distance matrix " + filename);
+    }
+}
+
+size_t matrix::countMismatches(const DistanceTable &table, const DistanceTable &reference)
+{
+    size_t mismatches = 0;
+    for (size_t i = 0; i < table.distances.size(); ++i)
+    {
+        double distance = table.distances[i], expected = reference.distances[i];
+        if (distance != expected && !(std::abs(distance - expected) <= 1e-9 * std::max(1.0, expected))) // inf - inf is NaN
+            mismatches++;
+    }
+    return mismatches;
+}
\ No newline at end of file
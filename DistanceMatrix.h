@@ -0,0 +1,74 @@
+#ifndef DISTANCEMATRIX_H
+#define DISTANCEMATRIX_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Graph.h"
+
+/**
+ * Many-to-many shortest distance tables, e.g. to match vehicles to pickups.
+ *
+ * Without preprocessing, every source runs one Dijkstra search that stops as soon as all
+ * targets are settled. When the graph has a contraction hierarchy, the bucket algorithm is
+ * used instead: an upward backward search from every target leaves its distance in a bucket
+ * at each vertex it settles, and an upward forward search from every source scans the buckets
+ * of the vertices it settles. Sources (and targets) are spread across threads.
+ */
+namespace matrix
+{
+    /* Row-major table of shortest distances in meters, infinity where there is no path */
+    struct DistanceTable
+    {
+        std::vector<uint32_t> sources;
+        std::vector<uint32_t> targets;
+        std::vector<double> distances; // distances[i * targets.size() + j] is from sources[i] to targets[j]
+
+        double at(size_t sourceIndex, size_t targetIndex) const { return distances[sourceIndex * targets.size() + targetIndex]; }
+    };
+
+    /**
+     * @brief Computes the distances from every source to every target, on the double weights.
+     * Throws an exception if a vertex does not exist.
+     *
+     * @param graph The graph to query; its contraction hierarchy is used if it has one.
+     * @param sources The source vertex IDs.
+     * @param targets The target vertex IDs.
+     * @param threadCount The number of threads to use; 0 picks one per hardware thread.
+     * @return The distance table.
+     */
+    DistanceTable compute(const Graph &graph, const std::vector<uint32_t> &sources, const std::vector<uint32_t> &targets,
+                          unsigned threadCount = 0);
+
+    /**
+     * @brief Writes a table as CSV: a header with the target IDs, then one row per source
+     * starting with its ID. Unreachable targets are written as "inf".
+     *
+     * @param table The table to write.
+     * @param out The stream to write to.
+     */
+    void writeCsv(const DistanceTable &table, std::ostream &out);
+
+    /**
+     * @brief Writes a table in binary form: the magic "MPFDMAT", the uint32 row and column counts,
+     * the uint32 source and target IDs, then the row-major double distances, all in host byte order.
+     *
+     * @param table The table to write.
+     * @param filename The name of the file to write.
+     */
+    void writeBinary(const DistanceTable &table, const std::string &filename);
+
+    /**
+     * @brief Compares a table with a reference table of the same sources and targets, e.g. computed
+     * without a hierarchy. Both are computed on the double weights, so entries may only differ by the
+     * rounding of sums taken in another order (a relative 1e-9); unreachable entries must match.
+     *
+     * @param table The table to check.
+     * @param reference The reference table.
+     * @return The number of entries that differ.
+     */
+    size_t countMismatches(const DistanceTable &table, const DistanceTable &reference);
+}
+
+#endif
\ No newline at end of file
@@ -1,121 +1,393 @@
 #include "Graph.h"
 #include "Vertex.h"
 #include "Edge.h"
-#include "utils.h"
-#include <fstream>
-#include <sstream>
+#include "GraphBuilder.h"
 #include <iostream>
 #include <stdexcept>
+#include <type_traits>
 
 Graph::Graph(const std::string &filename)
 {
     initializeFromFile(filename);
 }
 
+Graph::Graph(const CompactGraph &compact)
+{
+    std::lock_guard<std::mutex> update(updateMutex);
+    publish(compact, true);
+}
+
 void Graph::initializeFromFile(const std::string &filename)
 {
-    std::ifstream file(filename);
-    if (!file.is_open())
+    GraphBuilder builder;
+    builder.addSink(*this);
+    builder.addSink(statistics);
+    builder.build(filename);
+}
+
+void Graph::onVertex(const Vertex &vertex)
+{
+    addVertex(vertex);
+}
+
+void Graph::onEdge(const Edge &edge)
+{
+    addEdge(edge);
+}
+
+void Graph::onFinish()
+{
+    freeze();
+}
+
+void Graph::addVertex(const Vertex &vertex)
+{
+    vertices.insert_or_assign(vertex.getId(), vertex);
+}
+
+void Graph::addEdge(const Edge &edge)
+{
+    uint32_t startId = edge.getStartId();
+    uint32_t endId = edge.getEndId();
+    if (vertices.find(startId) == vertices.end() || vertices.find(endId) == vertices.end())
+    {
+        throw std::runtime_error("Edge connects to non-existent vertex");
+    }
+    adjacencyList[startId].push_back(edge);
+}
+
+void Graph::freeze()
+{
+    std::lock_guard<std::mutex> update(updateMutex);
+    // A rebuilt graph keeps counting versions so that derived data built on the old one is stale
+    uint64_t version = compact.vertexCount() > 0 ? compact.version() + 1 : 0;
+    publish(CompactGraph(*this, version), true);
+}
+
+void Graph::publish(CompactGraph updated, bool topologyChanged)
+{
+    // The replacements are built from the current members without compactMutex, which only the writers
+    // holding updateMutex replace, so that queries keep getting the previous version in the meantime
+    SearchView next;
+    next.compact = std::move(updated);
+    next.reverse = topologyChanged || !reverse ? std::make_shared<const ReverseAdjacency>(next.compact) : reverse;
+    next.sphere = topologyChanged || !sphere ? std::make_shared<const SphereCoordinates>(next.compact) : sphere;
+    next.sphereScale = next.sphere->admissibleScale(next.compact);
+    if (compressed)
+        next.compressed = std::make_shared<const CompressedAdjacency>(next.compact);
+    std::visit([&next](const auto &current)
+               {
+        using Current = std::decay_t<decltype(current)>;
+        if constexpr (!std::is_same_v<Current, std::monostate>)
+            next.quantized = std::make_shared<const typename Current::element_type>(next.compact); },
+               quantized);
+    // New weights only make the landmarks, hierarchy, labels and flags stale, for refresh() to rebuild
+    // them once before the next query rather than on every update; their indices no longer hold otherwise
+    next.landmarks = landmarks;
+    next.hierarchy = hierarchy;
+    next.hubLabels = hubLabels;
+    next.arcFlags = arcFlags;
+    if (topologyChanged)
+        rebuildStale(next, true);
+    if (overlay && topologyChanged)
+        next.overlay = std::make_shared<const MultiLevelOverlay>(next.compact, *next.reverse, overlay->levelCount(), overlay->fanout());
+    else if (overlay)
+        next.overlay = std::make_shared<const MultiLevelOverlay>(overlay->customized(next.compact, compact)); // Same partition, new weights
+
+    std::lock_guard<std::mutex> lock(compactMutex);
+    compact = std::move(next.compact);
+    compressed = std::move(next.compressed);
+    quantized = std::move(next.quantized);
+    reverse = std::move(next.reverse);
+    sphere = std::move(next.sphere);
+    sphereScale = next.sphereScale;
+    landmarks = std::move(next.landmarks);
+    hierarchy = std::move(next.hierarchy);
+    hubLabels = std::move(next.hubLabels);
+    arcFlags = std::move(next.arcFlags);
+    overlay = std::move(next.overlay);
+}
+
+void Graph::rebuildStale(SearchView &next, bool force) const
+{
+    auto stale = [&](const auto &structure)
+    { return structure && (force || structure->version() != next.compact.version()); };
+    if (stale(next.landmarks))
+        next.landmarks = std::make_shared<const Landmarks>(next.compact, *next.reverse, next.landmarks->count(), landmarkStrategy);
+    if (stale(next.hierarchy) || stale(next.hubLabels))
+        next.hierarchy = std::make_shared<const ContractionHierarchy>(next.compact);
+    if (stale(next.hubLabels))
+        next.hubLabels = std::make_shared<const HubLabels>(next.hierarchy, next.hubLabels->hasPaths());
+    if (stale(next.arcFlags))
+        next.arcFlags = std::make_shared<const ArcFlags>(next.compact, *next.reverse, next.arcFlags->cellCount());
+}
+
+bool Graph::hasStaleStructures() const
+{
+    auto stale = [this](const auto &structure)
+    { return structure && structure->version() != compact.version(); };
+    return stale(landmarks) || stale(hierarchy) || stale(hubLabels) || stale(arcFlags);
+}
+
+void Graph::refresh() const
+{
+    std::lock_guard<std::mutex> update(updateMutex);
+    if (!hasStaleStructures())
+        return; // Rebuilt by another caller meanwhile
+    SearchView next;
+    next.compact = compact;
+    next.reverse = reverse;
+    next.landmarks = landmarks;
+    next.hierarchy = hierarchy;
+    next.hubLabels = hubLabels;
+    next.arcFlags = arcFlags;
+    rebuildStale(next, false);
+
+    std::lock_guard<std::mutex> lock(compactMutex);
+    landmarks = std::move(next.landmarks);
+    hierarchy = std::move(next.hierarchy);
+    hubLabels = std::move(next.hubLabels);
+    arcFlags = std::move(next.arcFlags);
+}
+
+void Graph::compress()
+{
+    std::lock_guard<std::mutex> update(updateMutex);
+    auto built = std::make_shared<const CompressedAdjacency>(compact);
+    std::lock_guard<std::mutex> lock(compactMutex);
+    compressed = std::move(built);
+}
+
+template <typename Traits>
+void Graph::quantize()
+{
+    std::lock_guard<std::mutex> update(updateMutex);
+    auto built = std::make_shared<const QuantizedGraph<Traits>>(compact);
+    std::lock_guard<std::mutex> lock(compactMutex);
+    quantized = std::move(built);
+}
+
+template void Graph::quantize<CentimeterWeights>();
+template void Graph::quantize<DecimeterWeights>();
+
+Graph::QuantizedView Graph::getQuantized() const
+{
+    std::lock_guard<std::mutex> lock(compactMutex);
+    return quantized;
+}
+
+double Graph::weightStep() const
+{
+    std::lock_guard<std::mutex> lock(compactMutex);
+    if (compressed)
+        return 1.0 / CompressedAdjacency::kWeightScale;
+    return std::visit([](const auto &current)
+                      {
+        using Current = std::decay_t<decltype(current)>;
+        if constexpr (std::is_same_v<Current, std::monostate>)
+            return 0.0;
+        else
+            return 1.0 / Current::element_type::Traits::kScale; },
+                      quantized);
+}
+
+void Graph::computeLandmarks(uint32_t count, const std::string &strategy)
+{
+    std::lock_guard<std::mutex> update(updateMutex);
+    auto built = std::make_shared<const Landmarks>(compact, *reverse, count, strategy);
+    std::lock_guard<std::mutex> lock(compactMutex);
+    landmarks = std::move(built);
+    landmarkStrategy = strategy;
+}
+
+void Graph::setLandmarks(std::shared_ptr<const Landmarks> loaded)
+{
+    std::lock_guard<std::mutex> update(updateMutex);
+    std::lock_guard<std::mutex> lock(compactMutex);
+    if (loaded && (loaded->version() != compact.version() || loaded->vertexCount() != compact.vertexCount()))
+    {
+        throw std::runtime_error("Error: the landmarks were computed on another version of the graph.");
+    }
+    landmarks = std::move(loaded);
+    if (landmarkStrategy.empty())
+        landmarkStrategy = "avoid";
+}
+
+std::shared_ptr<const Landmarks> Graph::getLandmarks() const
+{
+    return getSearchView().landmarks; // Rebuilt first if stale
+}
+
+void Graph::contract()
+{
+    std::lock_guard<std::mutex> update(updateMutex);
+    auto built = std::make_shared<const ContractionHierarchy>(compact);
+    std::lock_guard<std::mutex> lock(compactMutex);
+    hierarchy = std::move(built);
+}
+
+std::shared_ptr<const ContractionHierarchy> Graph::getHierarchy() const
+{
+    return getSearchView().hierarchy; // Rebuilt first if stale
+}
+
+void Graph::buildHubLabels(bool withPaths)
+{
+    std::lock_guard<std::mutex> update(updateMutex);
+    auto builtHierarchy = hierarchy && hierarchy->version() == compact.version() ? hierarchy : std::make_shared<const ContractionHierarchy>(compact);
+    auto built = std::make_shared<const HubLabels>(builtHierarchy, withPaths);
+    std::lock_guard<std::mutex> lock(compactMutex);
+    hierarchy = std::move(builtHierarchy);
+    hubLabels = std::move(built);
+}
+
+void Graph::setHubLabels(std::shared_ptr<const HubLabels> loaded)
+{
+    std::lock_guard<std::mutex> update(updateMutex);
+    std::lock_guard<std::mutex> lock(compactMutex);
+    if (loaded && (loaded->version() != compact.version() || loaded->vertexCount() != compact.vertexCount()))
     {
-        throw std::runtime_error("Error: could not open file " + filename);
+        throw std::runtime_error("Error: the hub labels were computed on another version of the graph.");
     }
+    hubLabels = std::move(loaded);
+}
 
-    int vertexCount = 0;
-    int edgeCount = 0;
-    std::string line;
-    int lineNumber = 0;
+std::shared_ptr<const HubLabels> Graph::getHubLabels() const
+{
+    return getSearchView().hubLabels; // Rebuilt first if stale
+}
 
-    while (std::getline(file, line))
+void Graph::computeArcFlags(uint32_t cellCount)
+{
+    std::lock_guard<std::mutex> update(updateMutex);
+    auto built = std::make_shared<const ArcFlags>(compact, *reverse, cellCount);
+    std::lock_guard<std::mutex> lock(compactMutex);
+    arcFlags = std::move(built);
+}
+
+void Graph::setArcFlags(std::shared_ptr<const ArcFlags> loaded)
+{
+    std::lock_guard<std::mutex> update(updateMutex);
+    std::lock_guard<std::mutex> lock(compactMutex);
+    if (loaded && (loaded->version() != compact.version() || loaded->vertexCount() != compact.vertexCount() ||
+                   loaded->edgeCount() != compact.edgeCount()))
     {
-        lineNumber++;
+        throw std::runtime_error("Error: the arc flags were computed on another version of the graph.");
+    }
+    arcFlags = std::move(loaded);
+}
 
-        if (line.empty() || line[0] == '#')
-            continue; // skip empty lines or comments
+std::shared_ptr<const ArcFlags> Graph::getArcFlags() const
+{
+    return getSearchView().arcFlags; // Rebuilt first if stale
+}
 
-        std::string_view sv(line);
-        char type = sv.front();
-        sv.remove_prefix(2); // remove "V," or "E,"
+void Graph::buildOverlay(uint32_t levelCount)
+{
+    std::lock_guard<std::mutex> update(updateMutex);
+    auto built = std::make_shared<const MultiLevelOverlay>(compact, *reverse, levelCount);
+    std::lock_guard<std::mutex> lock(compactMutex);
+    overlay = std::move(built);
+}
 
-        if (type == 'V')
+std::shared_ptr<const MultiLevelOverlay> Graph::getOverlay() const
+{
+    std::lock_guard<std::mutex> lock(compactMutex);
+    return overlay;
+}
+
+Graph::SearchView Graph::getSearchView() const
+{
+    for (;;)
+    {
         {
-            uint32_t id;
-            double longitude, latitude;
+            std::lock_guard<std::mutex> lock(compactMutex);
+            if (!hasStaleStructures())
+                return SearchView{compact, compressed, quantized, reverse, sphere, sphereScale, landmarks, hierarchy, hubLabels, arcFlags, overlay};
+        }
+        refresh(); // Once per weight version, whichever query comes first; the others wait for it
+    }
+}
 
-            try
-            {
-                id = std::stoi(std::string(utils::nextField(sv)));
-                longitude = std::stod(std::string(utils::nextField(sv)));
-                latitude = std::stod(std::string(utils::nextField(sv)));
-            }
-            catch (const std::invalid_argument &e)
-            {
-                throw std::runtime_error("Parsing error at line " + std::to_string(lineNumber) +
-                                         ": Invalid number format in vertex definition (possibly due to comments or malformed data).\n" +
-                                         "Line content: " + line + "\n" +
-                                         "Hint: Check for inline comments (//) or non-numeric characters.");
-            }
-            catch (const std::out_of_range &e)
-            {
-                throw std::runtime_error("Parsing error at line " + std::to_string(lineNumber) +
-                                         ": Number out of range in vertex definition.\n" +
-                                         "Line content: " + line);
-            }
+std::shared_ptr<const CompressedAdjacency> Graph::getCompressed() const
+{
+    std::lock_guard<std::mutex> lock(compactMutex);
+    return compressed;
+}
+
+CompactGraph Graph::getCompact() const
+{
+    std::lock_guard<std::mutex> lock(compactMutex);
+    return compact;
+}
+
+void Graph::reorder(std::span<const uint32_t> order)
+{
+    std::lock_guard<std::mutex> update(updateMutex);
+    publish(compact.reordered(order), true);
+}
+
+size_t Graph::updateEdgeWeight(uint32_t idStart, uint32_t idEnd, double weight)
+{
+    return applyWeightUpdates({parser::WeightUpdate{idStart, idEnd, weight, 0}});
+}
 
-            Vertex v(id, longitude, latitude);
-            addVertex(v);
-            vertexCount++;
+size_t Graph::applyWeightUpdates(const std::vector<parser::WeightUpdate> &updates)
+{
+    std::lock_guard<std::mutex> update(updateMutex);
+
+    auto describe = [](const parser::WeightUpdate &update)
+    {
+        std::string where = update.lineNumber > 0 ? "Error at line " + std::to_string(update.lineNumber) + ": " : "";
+        return where + "edge " + std::to_string(update.idStart) + " -> " + std::to_string(update.idEnd);
+    };
+
+    // Validate the whole batch first so that a bad update leaves the graph untouched
+    std::vector<std::pair<uint32_t, uint32_t>> indices;
+    indices.reserve(updates.size());
+    for (const parser::WeightUpdate &update : updates)
+    {
+        if (!(update.weight >= 0))
+        {
+            throw std::runtime_error(describe(update) + " has a negative or invalid weight");
         }
-        else if (type == 'E')
+        uint32_t from = compact.indexOf(update.idStart);
+        uint32_t to = compact.indexOf(update.idEnd);
+        if (from == CompactGraph::kInvalidIndex || to == CompactGraph::kInvalidIndex ||
+            compact.findEdge(from, to) == CompactGraph::kInvalidIndex)
         {
-            std::string parsedWeight;
-            uint32_t idStart, idEnd;
-            double weight;
+            throw std::runtime_error(describe(update) + " does not exist");
+        }
+        indices.emplace_back(from, to);
+    }
 
-            try
-            {
-                idStart = std::stoi(std::string(utils::nextField(sv)));
-                idEnd = std::stoi(std::string(utils::nextField(sv)));
-                parsedWeight = std::string(utils::nextField(sv));
-                weight = parsedWeight.empty() || parsedWeight == "0" ? utils::computeEuclideanDistance(*this, getVertex(idStart), getVertex(idEnd))
-                                                                     : std::stod(parsedWeight);
-            }
-            catch (const std::invalid_argument &e)
-            {
-                throw std::runtime_error("Parsing error at line " + std::to_string(lineNumber) +
-                                         ": Invalid number format in edge definition (possibly due to comments or malformed data).\n" +
-                                         "Line content: " + line + "\n" +
-                                         "Hint: Check for inline comments (//) or non-numeric characters.");
-            }
-            catch (const std::out_of_range &e)
+    auto weights = std::make_shared<std::vector<double>>(compact.arrays().weights.begin(), compact.arrays().weights.end());
+    size_t updatedCount = 0;
+    for (size_t i = 0; i < updates.size(); ++i)
+    {
+        auto [from, to] = indices[i];
+        for (uint32_t edge = compact.edgeBegin(from); edge < compact.edgeEnd(from); ++edge)
+        {
+            if (compact.target(edge) == to)
             {
-                throw std::runtime_error("Parsing error at line " + std::to_string(lineNumber) +
-                                         ": Number out of range in edge definition.\n" +
-                                         "Line content: " + line);
+                (*weights)[edge] = updates[i].weight;
+                updatedCount++;
             }
-
-            Edge e(idStart, idEnd, weight);
-            addEdge(e);
-            edgeCount++;
         }
     }
 
-    file.close();
+    publish(compact.withWeights(std::move(weights)), false);
+    return updatedCount;
 }
 
-void Graph::addVertex(const Vertex &vertex)
+size_t Graph::loadWeightUpdates(const std::string &filename)
 {
-    vertices.insert_or_assign(vertex.getId(), vertex);
+    return applyWeightUpdates(parser::parseWeightUpdates(filename));
 }
 
-void Graph::addEdge(const Edge &edge)
+const GraphStatistics &Graph::getStatistics() const
 {
-    uint32_t startId = edge.getStartId();
-    uint32_t endId = edge.getEndId();
-    if (vertices.find(startId) == vertices.end() || vertices.find(endId) == vertices.end())
-    {
-        throw std::runtime_error("Edge connects to non-existent vertex");
-    }
-    adjacencyList[startId].push_back(edge);
+    return statistics;
 }
 
 const std::unordered_map<uint32_t, Vertex> &Graph::getVertices() const
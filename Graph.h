@@ -7,12 +7,73 @@
 #include <cstdint>
 #include "Vertex.h"
 #include "Edge.h"
+#include "CompactGraph.h"
+#include "CompressedAdjacency.h"
+#include "QuantizedGraph.h"
+#include "ReverseAdjacency.h"
+#include "Landmarks.h"
+#include "ContractionHierarchy.h"
+#include "HubLabels.h"
+#include "ArcFlags.h"
+#include "MultiLevelOverlay.h"
+#include "SphereCoordinates.h"
+#include "GraphSink.h"
+#include "GraphStatistics.h"
+#include "GraphParser.h"
+#include <mutex>
+#include <variant>
 
-class Graph
+/**
+ * Road map graph. The graph is the core store sink of the GraphBuilder pipeline:
+ * loading passes every parsed vertex and edge through addVertex() and addEdge().
+ */
+class Graph : public GraphSink
 {
+public:
+    /* Integer graph enabled by quantize(), one alternative per supported precision */
+    using QuantizedView = std::variant<std::monostate,
+                                       std::shared_ptr<const QuantizedGraph<CentimeterWeights>>,
+                                       std::shared_ptr<const QuantizedGraph<DecimeterWeights>>>;
+
 private:
     std::unordered_map<uint32_t, Vertex> vertices;
-    std::unordered_map<uint32_t, std::vector<Edge>> adjacencyList;
+    std::unordered_map<uint32_t, std::vector<Edge>> adjacencyList; // Loaded edges and weights, never changed by weight updates
+    CompactGraph compact;             // Frozen CSR view used by the search algorithms
+    std::shared_ptr<const CompressedAdjacency> compressed; // Set once compress() enabled the compressed mode
+    QuantizedView quantized;          // Set once quantize() enabled the integer mode
+    std::shared_ptr<const ReverseAdjacency> reverse; // Incoming edges, for backward searches
+    std::shared_ptr<const SphereCoordinates> sphere; // Vertex unit vectors, for the A* heuristics
+    double sphereScale = 1.0;         // Admissible scale of the sphere bounds for the current weights
+    // The landmarks, hierarchy, labels and flags are left stale by weight updates and rebuilt by refresh()
+    mutable std::shared_ptr<const Landmarks> landmarks; // Set once computeLandmarks() or setLandmarks() enabled ALT
+    std::string landmarkStrategy;     // Selection strategy used when the landmarks are recomputed
+    mutable std::shared_ptr<const ContractionHierarchy> hierarchy; // Set once contract() enabled CH queries
+    mutable std::shared_ptr<const HubLabels> hubLabels; // Set once buildHubLabels() or setHubLabels() enabled label queries
+    mutable std::shared_ptr<const ArcFlags> arcFlags; // Set once computeArcFlags() or setArcFlags() enabled arc flag queries
+    std::shared_ptr<const MultiLevelOverlay> overlay; // Set once buildOverlay() enabled overlay queries
+    mutable std::mutex compactMutex;  // Guards swapping in new structures against concurrent getCompact() copies
+    mutable std::mutex updateMutex;   // Serializes the writers, held while they build the structures to swap in
+    GraphStatistics statistics;       // Collected while loading from a file
+
+    /**
+     * Installs a new compact graph and keeps the compressed and quantized graphs and the overlay,
+     * if enabled, and the reverse adjacency and sphere coordinates in sync. The landmarks, the
+     * hierarchy, the labels and the flags are rebuilt too if the topology changed, and are otherwise
+     * left stale for refresh(). Must be called with updateMutex held: everything is built first and
+     * compactMutex is only taken to swap the new structures in, so that getSearchView() keeps
+     * serving the previous version meanwhile.
+     *
+     * @param updated The new compact graph.
+     * @param topologyChanged False if only the weights changed, so the reverse adjacency and sphere coordinates stay valid.
+     */
+    void publish(CompactGraph updated, bool topologyChanged);
+
+protected:
+    /**
+     * Constructor for derived classes that load the graph themselves, once they are fully
+     * constructed, so that the builder events reach their overrides.
+     */
+    Graph() = default;
 
 public:
     /**
@@ -22,13 +83,28 @@ public:
      */
     Graph(const std::string &filename);
 
+    /**
+     * Constructor that wraps an already frozen compact graph, e.g. one loaded from a snapshot.
+     * Such a graph has no vertex or adjacency maps: only getCompact() is populated.
+     *
+     * @param compact The compact graph to use.
+     */
+    explicit Graph(const CompactGraph &compact);
+
     /**
      * Helper method to initialize the graph from a file.
+     * The file is parsed once by a GraphBuilder with this graph and its statistics as sinks,
+     * and the graph is frozen at the end.
      *
      * @param filename The name of the file containing the graph data.
      */
     virtual void initializeFromFile(const std::string &filename);
 
+    /* GraphSink events, forwarded to addVertex() and addEdge(); onFinish() freezes the graph */
+    void onVertex(const Vertex &vertex) override;
+    void onEdge(const Edge &edge) override;
+    void onFinish() override;
+
     /**
      * Virtual method to add a vertex to the graph.
      * This method can be overridden in derived classes for additional functionality.
@@ -45,6 +121,246 @@ public:
      */
     virtual void addEdge(const Edge &edge);
 
+    /**
+     * Builds the compact CSR representation from the current vertices and edges.
+     * Called automatically once loading from a file is complete; later additions are
+     * not visible to the search algorithms until the graph is frozen again. The edges keep
+     * their loaded weights: weight updates applied before are not carried over.
+     */
+    void freeze();
+
+    /**
+     * Gets the frozen CSR representation of the graph used by the search algorithms.
+     * The returned copy shares its arrays with the graph and keeps them alive, so a query
+     * holding it sees a consistent snapshot even if weights are updated meanwhile.
+     *
+     * @return The CompactGraph built by the last call to freeze() or weight update.
+     */
+    CompactGraph getCompact() const;
+
+    /* Compact graph and matching compressed adjacency, quantized graph, landmarks, hierarchy, labels, arc flags and overlay (if enabled), reverse adjacency and sphere coordinates, taken together */
+    struct SearchView
+    {
+        CompactGraph compact;
+        std::shared_ptr<const CompressedAdjacency> compressed;
+        QuantizedView quantized;
+        std::shared_ptr<const ReverseAdjacency> reverse;
+        std::shared_ptr<const SphereCoordinates> sphere;
+        double sphereScale = 1.0; // Factor applied to the sphere bounds, see SphereCoordinates::admissibleScale()
+        std::shared_ptr<const Landmarks> landmarks;
+        std::shared_ptr<const ContractionHierarchy> hierarchy;
+        std::shared_ptr<const HubLabels> hubLabels;
+        std::shared_ptr<const ArcFlags> arcFlags;
+        std::shared_ptr<const MultiLevelOverlay> overlay;
+    };
+
+    /**
+     * Gets a consistent view of the structures a query runs on, calling refresh() first if
+     * weight updates left some of them stale. Like getCompact(), the view pins its data for as
+     * long as it is held.
+     *
+     * @return The current search view.
+     */
+    SearchView getSearchView() const;
+
+    /**
+     * Rebuilds, in one batch, the landmarks, hierarchy, labels and flags that weight updates
+     * left stale. getSearchView() and the getters call it, so calling it beforehand only moves
+     * that cost out of the first query after the updates.
+     */
+    void refresh() const;
+
+    /**
+     * Enables the compressed adjacency mode: the search algorithms then decode delta/varint
+     * encoded neighbor lists with quantized weights instead of reading the plain CSR arrays.
+     * The compressed adjacency is rebuilt whenever the compact graph changes.
+     */
+    void compress();
+
+    /**
+     * Gets the compressed adjacency matching the current compact graph.
+     *
+     * @return The compressed adjacency, or nullptr when the compressed mode is not enabled.
+     */
+    std::shared_ptr<const CompressedAdjacency> getCompressed() const;
+
+    /**
+     * Enables the integer mode: the search algorithms then run on a QuantizedGraph with
+     * fixed-point weights of the given traits and integer distances.
+     * The quantized graph is rebuilt whenever the compact graph changes.
+     * Throws an exception if a weight cannot be represented with the traits.
+     *
+     * @tparam Traits CentimeterWeights or DecimeterWeights.
+     */
+    template <typename Traits>
+    void quantize();
+
+    /**
+     * Gets the quantized graph matching the current compact graph.
+     *
+     * @return The quantized graph, or std::monostate when the integer mode is not enabled.
+     */
+    QuantizedView getQuantized() const;
+
+    /**
+     * Gets the step the searches round every edge weight to in the enabled mode, so that
+     * their distances may be off by up to half a step per edge.
+     *
+     * @return The step in meters: that of the traits in the integer mode, a centimeter in the
+     *         compressed mode, 0 on the double-precision weights.
+     */
+    double weightStep() const;
+
+    /**
+     * Enables ALT queries: selects landmarks and computes their distance tables.
+     * The landmarks are recomputed, with the same count and strategy, whenever the topology changes
+     * and by refresh() after weight updates.
+     * Throws an exception for an unknown strategy.
+     *
+     * @param count The number of landmarks.
+     * @param strategy The selection strategy, "farthest" or "avoid".
+     */
+    void computeLandmarks(uint32_t count, const std::string &strategy);
+
+    /**
+     * Enables ALT queries with precomputed landmarks, e.g. loaded from a snapshot.
+     * Throws an exception if they were not computed on the current compact graph.
+     *
+     * @param loaded The landmarks to use.
+     */
+    void setLandmarks(std::shared_ptr<const Landmarks> loaded);
+
+    /**
+     * Gets the landmarks matching the current compact graph, rebuilt first if stale.
+     *
+     * @return The landmarks, or nullptr when ALT is not enabled.
+     */
+    std::shared_ptr<const Landmarks> getLandmarks() const;
+
+    /**
+     * Enables Contraction Hierarchy queries: contracts the compact graph.
+     * The hierarchy is rebuilt whenever the topology changes and by refresh() after weight updates.
+     */
+    void contract();
+
+    /**
+     * Gets the contraction hierarchy matching the current compact graph, rebuilt first if stale.
+     *
+     * @return The hierarchy, or nullptr when CH queries are not enabled.
+     */
+    std::shared_ptr<const ContractionHierarchy> getHierarchy() const;
+
+    /**
+     * Enables hub label queries: builds the labels from the contraction hierarchy, which is
+     * contracted first if needed. The labels are rebuilt whenever the topology changes and by
+     * refresh() after weight updates.
+     *
+     * @param withPaths True to also support path retrieval, not only distances.
+     */
+    void buildHubLabels(bool withPaths);
+
+    /**
+     * Enables hub label queries with precomputed labels, e.g. loaded from a snapshot.
+     * Throws an exception if they were not computed on the current compact graph.
+     *
+     * @param loaded The labels to use.
+     */
+    void setHubLabels(std::shared_ptr<const HubLabels> loaded);
+
+    /**
+     * Gets the hub labels matching the current compact graph, rebuilt first if stale.
+     *
+     * @return The labels, or nullptr when label queries are not enabled.
+     */
+    std::shared_ptr<const HubLabels> getHubLabels() const;
+
+    /**
+     * Enables arc flag queries: partitions the graph into cells and computes the flags of every edge.
+     * The flags are recomputed, with the same cell count, whenever the topology changes and by
+     * refresh() after weight updates.
+     *
+     * @param cellCount The number of cells.
+     */
+    void computeArcFlags(uint32_t cellCount);
+
+    /**
+     * Enables arc flag queries with precomputed flags, e.g. loaded from a snapshot.
+     * Throws an exception if they were not computed on the current compact graph.
+     *
+     * @param loaded The flags to use.
+     */
+    void setArcFlags(std::shared_ptr<const ArcFlags> loaded);
+
+    /**
+     * Gets the arc flags matching the current compact graph, rebuilt first if stale.
+     *
+     * @return The flags, or nullptr when arc flag queries are not enabled.
+     */
+    std::shared_ptr<const ArcFlags> getArcFlags() const;
+
+    /**
+     * Enables multi-level overlay queries: partitions the compact graph and customizes the overlay.
+     * When only the weights of the compact graph change, the partition is kept and the overlay is
+     * customized again, only in the cells holding changed edges; other changes rebuild it with the same number of levels.
+     *
+     * @param levelCount The number of overlay levels.
+     */
+    void buildOverlay(uint32_t levelCount);
+
+    /**
+     * Gets the multi-level overlay matching the current compact graph.
+     *
+     * @return The overlay, or nullptr when overlay queries are not enabled.
+     */
+    std::shared_ptr<const MultiLevelOverlay> getOverlay() const;
+
+    /**
+     * Renumbers the vertices of the compact graph for memory locality (see reordering).
+     * Vertex IDs seen through the API are unchanged. A later freeze() restores the default order.
+     *
+     * @param order The old dense index of every new dense index.
+     */
+    void reorder(std::span<const uint32_t> order);
+
+    /**
+     * Sets the weight of every edge from idStart to idEnd without rebuilding the graph.
+     * Throws an exception if the edge does not exist or the weight is negative.
+     *
+     * @param idStart The starting vertex ID of the edge.
+     * @param idEnd The ending vertex ID of the edge.
+     * @param weight The new weight; infinity closes the edge.
+     * @return The number of edges updated (parallel edges are all updated).
+     */
+    size_t updateEdgeWeight(uint32_t idStart, uint32_t idEnd, double weight);
+
+    /**
+     * Applies a batch of weight updates as a single new weight version.
+     * The compact graph gets a copy-on-write weight overlay, so queries that already
+     * hold the previous version are not affected. The batch is validated before anything
+     * is changed: on error the graph is left untouched. Only the weight-dependent arrays and
+     * the overlay customization are redone here; the landmarks, hierarchy, labels and flags
+     * are marked stale and rebuilt once by the next getSearchView() or refresh().
+     *
+     * @param updates The weight updates to apply, in order.
+     * @return The number of edges updated.
+     */
+    size_t applyWeightUpdates(const std::vector<parser::WeightUpdate> &updates);
+
+    /**
+     * Reads a weight delta file ("W,idStart,idEnd,weight" lines) and applies it as one batch.
+     *
+     * @param filename The name of the weight delta file.
+     * @return The number of edges updated.
+     */
+    size_t loadWeightUpdates(const std::string &filename);
+
+    /**
+     * Gets the statistics collected while loading the graph file.
+     *
+     * @return A const reference to the statistics; empty for graphs wrapping a snapshot.
+     */
+    const GraphStatistics &getStatistics() const;
+
     /**
      * Gets the map of vertices in the graph.
      *
@@ -53,7 +369,8 @@ public:
     const std::unordered_map<uint32_t, Vertex> &getVertices() const;
 
     /**
-     * Gets the adjacency list of the graph.
+     * Gets the adjacency list of the graph, with the weights it was loaded with. Weight updates
+     * only change the compact graph, so that this map can be read while they are applied.
      *
      * @return A const reference to an unordered map of vertex ID to a vector of Edge objects.
      */
@@ -62,6 +379,7 @@ public:
     /**
      * Gets the list of edges (neighbors) connected to the given vertex ID.
      * Note: returns a const reference to avoid copying potentially large neighbor lists.
+     * Like getAdjacencyList(), the edges keep their loaded weights.
      *
      * @param vertexId The ID of the vertex whose neighbors are to be retrieved.
      * @return A const reference to a vector of Edge objects representing the neighbors.
@@ -89,6 +407,19 @@ public:
      * Virtual destructor.
      */
     virtual ~Graph() = default;
+
+private:
+    /**
+     * Rebuilds the landmarks, hierarchy, labels and flags of a view that do not match its compact
+     * graph, with the same parameters. Must be called with updateMutex held.
+     *
+     * @param next The view to update; its reverse adjacency must match its compact graph.
+     * @param force True to rebuild every enabled structure, e.g. after a topology change.
+     */
+    void rebuildStale(SearchView &next, bool force) const;
+
+    /* True if an enabled landmark, hierarchy, label or flag structure predates the weights; needs a lock */
+    bool hasStaleStructures() const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "GraphBuilder.h"
+#include "utils.h"
+#include <stdexcept>
+#include <unordered_map>
+
+void GraphBuilder::addSink(GraphSink &sink)
+{
+    sinks.push_back(&sink);
+}
+
+void GraphBuilder::build(const std::string &filename)
+{
+    parser::ParsedGraph parsed = parser::parseFile(filename);
+
+    for (const Vertex &vertex : parsed.vertices)
+    {
+        for (GraphSink *sink : sinks)
+            sink->onVertex(vertex);
+    }
+
+    resolveMissingWeights(parsed);
+    std::vector<Vertex>().swap(parsed.vertices); // Sinks keep their own copies from here on
+
+    for (const parser::ParsedEdge &parsedEdge : parsed.edges)
+    {
+        Edge edge(parsedEdge.idStart, parsedEdge.idEnd, parsedEdge.weight);
+        try
+        {
+            for (GraphSink *sink : sinks)
+                sink->onEdge(edge);
+        }
+        catch (const std::runtime_error &e)
+        {
+            throw std::runtime_error("Error at line " + std::to_string(parsedEdge.lineNumber) + ": " + e.what());
+        }
+    }
+    std::vector<parser::ParsedEdge>().swap(parsed.edges); // Not held while the sinks build their final structures
+
+    for (GraphSink *sink : sinks)
+        sink->onFinish();
+}
+
+void GraphBuilder::resolveMissingWeights(parser::ParsedGraph &parsed)
+{
+    std::vector<size_t> missing;
+    for (size_t i = 0; i < parsed.edges.size(); ++i)
+    {
+        if (!parsed.edges[i].hasWeight)
+            missing.push_back(i);
+    }
+    if (missing.empty())
+        return;
+
+    // Later definitions of the same vertex ID replace earlier ones, as in Graph::addVertex
+    std::unordered_map<uint32_t, size_t> vertexIndex;
+    vertexIndex.reserve(parsed.vertices.size());
+    for (size_t i = 0; i < parsed.vertices.size(); ++i)
+    {
+        vertexIndex.insert_or_assign(parsed.vertices[i].getId(), i);
+    }
+
+    double sumLat = 0.0, sumLong = 0.0;
+    for (const auto &pair : vertexIndex)
+    {
+        sumLat += parsed.vertices[pair.second].getLatitude();
+        sumLong += parsed.vertices[pair.second].getLongitude();
+    }
+    utils::ProjectionContext context = utils::projectionContext(sumLat / vertexIndex.size(), sumLong / vertexIndex.size());
+
+    // Gather the endpoint coordinates into flat arrays for the batched distance kernel
+    std::vector<double> longitudes1(missing.size()), latitudes1(missing.size());
+    std::vector<double> longitudes2(missing.size()), latitudes2(missing.size());
+    for (size_t i = 0; i < missing.size(); ++i)
+    {
+        const parser::ParsedEdge &edge = parsed.edges[missing[i]];
+        auto start = vertexIndex.find(edge.idStart);
+        auto end = vertexIndex.find(edge.idEnd);
+        if (start == vertexIndex.end() || end == vertexIndex.end())
+        {
+            throw std::runtime_error("Error at line " + std::to_string(edge.lineNumber) + ": Vertex not found");
+        }
+        longitudes1[i] = parsed.vertices[start->second].getLongitude();
+        latitudes1[i] = parsed.vertices[start->second].getLatitude();
+        longitudes2[i] = parsed.vertices[end->second].getLongitude();
+        latitudes2[i] = parsed.vertices[end->second].getLatitude();
+    }
+
+    std::vector<double> distances(missing.size());
+    utils::computeEuclideanDistances(context, longitudes1, latitudes1, longitudes2, latitudes2, distances);
+
+    for (size_t i = 0; i < missing.size(); ++i)
+    {
+        parsed.edges[missing[i]].weight = distances[i];
+        parsed.edges[missing[i]].hasWeight = true;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef GRAPHBUILDER_H
+#define GRAPHBUILDER_H
+
+#include <string>
+#include <vector>
+#include "GraphSink.h"
+#include "GraphParser.h"
+
+/**
+ * Single-pass loading pipeline for graph files.
+ *
+ * The file is parsed once, missing edge weights are resolved in one batch and
+ * the resulting vertex and edge events are emitted to every registered sink.
+ * Parsing is not incremental: the whole file is parsed into memory first, since
+ * computed weights need the coordinates of every vertex. The parsed vertices and
+ * edges are released as soon as their events are emitted, so they are no longer
+ * held when onFinish() lets the sinks build their final structures.
+ */
+class GraphBuilder
+{
+private:
+    std::vector<GraphSink *> sinks;
+
+    /**
+     * Fills the weights of the edges whose weight field was empty or "0" with the projected
+     * Euclidean distance between their endpoints. The projection context is computed once
+     * from all the parsed vertices and the distances in a single batched pass.
+     *
+     * @param parsed The parsed graph; edges without a weight are updated in place.
+     */
+    static void resolveMissingWeights(parser::ParsedGraph &parsed);
+
+public:
+    /**
+     * Registers a sink; sinks receive the events in registration order.
+     * The sink must outlive the call to build().
+     *
+     * @param sink The sink to add.
+     */
+    void addSink(GraphSink &sink);
+
+    /**
+     * Parses the file and emits all its vertices, then all its edges, then onFinish(), to every sink.
+     * Throws an exception on malformed input, reporting the offending line.
+     *
+     * @param filename The name of the file containing vertex and edge definitions.
+     */
+    void build(const std::string &filename);
+};
+
+#endif
\ No newline at end of file
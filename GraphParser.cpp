@@ -0,0 +1,314 @@
+#include "GraphParser.h"
+#include "MappedFile.h"
+#include "utils.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+
+namespace
+{
+    // Below this size per chunk, spawning another thread costs more than it saves
+    constexpr size_t kMinChunkSize = 1 << 20;
+
+    // Output of one chunk; line numbers are local to the chunk until the merge
+    struct ChunkResult
+    {
+        std::vector<Vertex> vertices;
+        std::vector<parser::ParsedEdge> edges;
+        uint32_t lineCount = 0;
+        uint32_t errorLine = 0;  // Local line of the first error, 0 if none
+        std::string errorDetail; // Error message following "Parsing error at line N"
+        std::exception_ptr exception;
+    };
+
+    /**
+     * Parses a number the way std::stoi/std::stod did: leading whitespace and an explicit
+     * '+' sign are skipped and trailing characters are ignored.
+     */
+    template <typename T>
+    std::errc parseNumber(std::string_view field, T &value)
+    {
+        while (!field.empty() && std::isspace(static_cast<unsigned char>(field.front())))
+            field.remove_prefix(1);
+        if (!field.empty() && field.front() == '+')
+            field.remove_prefix(1);
+        return std::from_chars(field.data(), field.data() + field.size(), value).ec;
+    }
+
+    std::string invalidFormat(const char *definition, std::string_view line)
+    {
+        return std::string(": Invalid number format in ") + definition + " definition (possibly due to comments or malformed data).\n" +
+               "Line content: " + std::string(line) + "\n" +
+               "Hint: Check for inline comments (//) or non-numeric characters.";
+    }
+
+    std::string outOfRange(const char *definition, std::string_view line)
+    {
+        return std::string(": Number out of range in ") + definition + " definition.\n" +
+               "Line content: " + std::string(line);
+    }
+
+    // Records the error of a failed parseNumber; returns false so callers can stop the chunk
+    bool fail(ChunkResult &result, std::errc error, const char *definition, std::string_view line)
+    {
+        result.errorLine = result.lineCount;
+        result.errorDetail = error == std::errc::result_out_of_range ? outOfRange(definition, line)
+                                                                     : invalidFormat(definition, line);
+        return false;
+    }
+
+    bool parseLine(std::string_view line, ChunkResult &result)
+    {
+        if (line.empty() || line[0] == '#')
+            return true; // skip empty lines or comments
+
+        std::string_view sv(line);
+        char type = sv.front();
+        sv.remove_prefix(std::min<size_t>(2, sv.size())); // remove "V," or "E,"
+
+        if (type == 'V')
+        {
+            uint32_t id;
+            double longitude, latitude;
+            std::errc error;
+
+            if ((error = parseNumber(utils::nextField(sv), id)) != std::errc() ||
+                (error = parseNumber(utils::nextField(sv), longitude)) != std::errc() ||
+                (error = parseNumber(utils::nextField(sv), latitude)) != std::errc())
+            {
+                return fail(result, error, "vertex", line);
+            }
+            result.vertices.emplace_back(id, longitude, latitude);
+        }
+        else if (type == 'E')
+        {
+            parser::ParsedEdge edge{0, 0, 0.0, true, result.lineCount};
+            std::errc error;
+
+            if ((error = parseNumber(utils::nextField(sv), edge.idStart)) != std::errc() ||
+                (error = parseNumber(utils::nextField(sv), edge.idEnd)) != std::errc())
+            {
+                return fail(result, error, "edge", line);
+            }
+
+            std::string_view parsedWeight = utils::nextField(sv);
+            if (parsedWeight.empty() || parsedWeight == "0")
+            {
+                edge.hasWeight = false; // Computed from the coordinates once all vertices are known
+            }
+            else if ((error = parseNumber(parsedWeight, edge.weight)) != std::errc())
+            {
+                return fail(result, error, "edge", line);
+            }
+            result.edges.push_back(edge);
+        }
+        return true;
+    }
+
+    void parseChunk(const char *begin, const char *end, ChunkResult &result)
+    {
+        try
+        {
+            const char *position = begin;
+            while (position < end)
+            {
+                const char *newline = static_cast<const char *>(std::memchr(position, '\n', end - position));
+                const char *lineEnd = newline ? newline : end;
+                result.lineCount++;
+
+                if (!parseLine(std::string_view(position, lineEnd - position), result))
+                    return; // Stop at the first error of the chunk
+
+                position = newline ? newline + 1 : end;
+            }
+        }
+        catch (...)
+        {
+            result.exception = std::current_exception();
+        }
+    }
+}
+
+parser::ParsedGraph parser::parseFile(const std::string &filename, unsigned threadCount)
+{
+    MappedFile file(filename);
+    const char *data = file.data();
+    size_t size = file.size();
+
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    size_t chunkCount = std::clamp<size_t>(size / kMinChunkSize, 1, threadCount);
+
+    // Split at line boundaries: every chunk but the first starts right after a newline
+    std::vector<const char *> bounds = {data};
+    for (size_t i = 1; i < chunkCount; ++i)
+    {
+        const char *target = std::max(data + size * i / chunkCount, bounds.back());
+        const char *newline = static_cast<const char *>(std::memchr(target, '\n', data + size - target));
+        bounds.push_back(newline ? newline + 1 : data + size);
+    }
+    bounds.push_back(data + size);
+
+    std::vector<ChunkResult> results(chunkCount);
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < chunkCount; ++i)
+    {
+        threads.emplace_back(parseChunk, bounds[i], bounds[i + 1], std::ref(results[i]));
+    }
+    parseChunk(bounds[0], bounds[1], results[0]);
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    // Report the first error in file order, with its global line number
+    uint32_t linesBefore = 0;
+    size_t vertexTotal = 0, edgeTotal = 0;
+    for (ChunkResult &result : results)
+    {
+        if (result.exception)
+            std::rethrow_exception(result.exception);
+        if (result.errorLine != 0)
+        {
+            throw std::runtime_error("Parsing error at line " + std::to_string(linesBefore + result.errorLine) +
+                                     result.errorDetail);
+        }
+        linesBefore += result.lineCount;
+        vertexTotal += result.vertices.size();
+        edgeTotal += result.edges.size();
+    }
+
+    ParsedGraph parsed;
+    parsed.vertices.reserve(vertexTotal);
+    parsed.edges.reserve(edgeTotal);
+    linesBefore = 0;
+    for (ChunkResult &result : results)
+    {
+        parsed.vertices.insert(parsed.vertices.end(), result.vertices.begin(), result.vertices.end());
+        for (ParsedEdge &edge : result.edges)
+        {
+            edge.lineNumber += linesBefore;
+            parsed.edges.push_back(edge);
+        }
+        linesBefore += result.lineCount;
+        std::vector<Vertex>().swap(result.vertices);
+        std::vector<ParsedEdge>().swap(result.edges);
+    }
+    return parsed;
+}
+
+std::vector<parser::WeightUpdate> parser::parseWeightUpdates(const std::string &filename)
+{
+    MappedFile file(filename);
+    const char *position = file.data();
+    const char *end = file.data() + file.size();
+
+    std::vector<WeightUpdate> updates;
+    uint32_t lineNumber = 0;
+    while (position < end)
+    {
+        const char *newline = static_cast<const char *>(std::memchr(position, '\n', end - position));
+        std::string_view line(position, (newline ? newline : end) - position);
+        position = newline ? newline + 1 : end;
+        lineNumber++;
+
+        if (line.empty() || line[0] != 'W')
+            continue; // skip empty lines, comments and other definitions
+
+        std::string_view sv(line);
+        sv.remove_prefix(std::min<size_t>(2, sv.size())); // remove "W,"
+
+        WeightUpdate update{0, 0, 0.0, lineNumber};
+        std::errc error;
+        if ((error = parseNumber(utils::nextField(sv), update.idStart)) != std::errc() ||
+            (error = parseNumber(utils::nextField(sv), update.idEnd)) != std::errc() ||
+            (error = parseNumber(utils::nextField(sv), update.weight)) != std::errc())
+        {
+            throw std::runtime_error("Parsing error at line " + std::to_string(lineNumber) +
+                                     (error == std::errc::result_out_of_range ? outOfRange("weight update", line)
+                                                                              : invalidFormat("weight update", line)));
+        }
+        updates.push_back(update);
+    }
+    return updates;
+}
+
+std::vector<uint32_t> parser::parseVertexList(const std::string &filename)
+{
+    MappedFile file(filename);
+    const char *position = file.data();
+    const char *end = file.data() + file.size();
+
+    std::vector<uint32_t> ids;
+    uint32_t lineNumber = 0;
+    while (position < end)
+    {
+        const char *newline = static_cast<const char *>(std::memchr(position, '\n', end - position));
+        std::string_view line(position, (newline ? newline : end) - position);
+        position = newline ? newline + 1 : end;
+        lineNumber++;
+
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::string_view sv(line);
+        while (!sv.empty())
+        {
+            std::string_view field = utils::nextField(sv);
+            if (field.empty())
+                continue; // Trailing or doubled commas
+            uint32_t id = 0;
+            std::errc error = parseNumber(field, id);
+            if (error != std::errc())
+            {
+                throw std::runtime_error("Parsing error at line " + std::to_string(lineNumber) +
+                                         (error == std::errc::result_out_of_range ? outOfRange("vertex list", line)
+                                                                                  : invalidFormat("vertex list", line)));
+            }
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
+
+std::vector<parser::QueryPair> parser::parseQueries(const std::string &filename)
+{
+    MappedFile file(filename);
+    const char *position = file.data();
+    const char *end = file.data() + file.size();
+
+    std::vector<QueryPair> queries;
+    uint32_t lineNumber = 0;
+    while (position < end)
+    {
+        const char *newline = static_cast<const char *>(std::memchr(position, '\n', end - position));
+        std::string_view line(position, (newline ? newline : end) - position);
+        position = newline ? newline + 1 : end;
+        lineNumber++;
+
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::string_view sv(line);
+        QueryPair query{0, 0};
+        std::errc error;
+        if ((error = parseNumber(utils::nextField(sv), query.idStart)) != std::errc() ||
+            (error = parseNumber(utils::nextField(sv), query.idEnd)) != std::errc())
+        {
+            throw std::runtime_error("Parsing error at line " + std::to_string(lineNumber) +
+                                     (error == std::errc::result_out_of_range ? outOfRange("query", line)
+                                                                              : invalidFormat("query", line)));
+        }
+        queries.push_back(query);
+    }
+    return queries;
+}
\ No newline at end of file
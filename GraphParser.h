@@ -0,0 +1,99 @@
+#ifndef GRAPHPARSER_H
+#define GRAPHPARSER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Vertex.h"
+
+/**
+ * Parallel parser for V/E graph files.
+ *
+ * The file is memory-mapped, split into line-aligned chunks and every chunk is
+ * parsed on its own thread with std::from_chars, straight from the mapping.
+ * The per-thread buffers are then concatenated in file order.
+ */
+namespace parser
+{
+    /**
+     * Edge as read from an E line. The weight is only meaningful when hasWeight is set:
+     * an empty or "0" weight field means the weight has to be computed from the coordinates.
+     */
+    struct ParsedEdge
+    {
+        uint32_t idStart;
+        uint32_t idEnd;
+        double weight;
+        bool hasWeight;
+        uint32_t lineNumber; // 1-based line of the E definition, for error messages
+    };
+
+    /* Vertices and edges of a graph file, in file order */
+    struct ParsedGraph
+    {
+        std::vector<Vertex> vertices;
+        std::vector<ParsedEdge> edges;
+    };
+
+    /**
+     * New weight of the edges from idStart to idEnd, as read from a W line of a weight delta file.
+     * An infinite weight ("inf") closes the road segment.
+     */
+    struct WeightUpdate
+    {
+        uint32_t idStart;
+        uint32_t idEnd;
+        double weight;
+        uint32_t lineNumber; // 1-based line of the W definition, 0 for updates not read from a file
+    };
+
+    /* Origin-destination pair of a batch query file */
+    struct QueryPair
+    {
+        uint32_t idStart;
+        uint32_t idEnd;
+    };
+
+    /**
+     * @brief Parses a graph file on several threads.
+     * Throws an exception on the first malformed line of the file, reporting its line
+     * number and content exactly like the sequential parser did.
+     *
+     * @param filename The name of the file containing vertex and edge definitions.
+     * @param threadCount The number of threads to use; 0 picks one per hardware thread.
+     * @return The parsed vertices and edges.
+     */
+    ParsedGraph parseFile(const std::string &filename, unsigned threadCount = 0);
+
+    /**
+     * @brief Parses a weight delta file made of "W,idStart,idEnd,weight" lines.
+     * Empty lines and lines starting with '#' are skipped. Throws an exception on the
+     * first malformed line, reporting its line number and content.
+     *
+     * @param filename The name of the weight delta file.
+     * @return The weight updates, in file order.
+     */
+    std::vector<WeightUpdate> parseWeightUpdates(const std::string &filename);
+
+    /**
+     * @brief Parses a list of vertex IDs, one per line or separated by commas.
+     * Empty lines and lines starting with '#' are skipped. Throws an exception on the
+     * first malformed ID, reporting its line number and content.
+     *
+     * @param filename The name of the vertex list file.
+     * @return The vertex IDs, in file order.
+     */
+    std::vector<uint32_t> parseVertexList(const std::string &filename);
+
+    /**
+     * @brief Parses a batch query file made of "idStart,idEnd" lines.
+     * Empty lines and lines starting with '#' are skipped. Throws an exception on the
+     * first malformed line, reporting its line number and content.
+     *
+     * @param filename The name of the query file.
+     * @return The queries, in file order.
+     */
+    std::vector<QueryPair> parseQueries(const std::string &filename);
+}
+
+#endif
\ No newline at end of file
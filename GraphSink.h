@@ -0,0 +1,37 @@
+#ifndef GRAPHSINK_H
+#define GRAPHSINK_H
+
+#include "Vertex.h"
+#include "Edge.h"
+
+/**
+ * Receiver of the vertex and edge events emitted by a GraphBuilder.
+ * Sinks are plugged into the builder so that a file is parsed once and every
+ * consumer (graph store, scene builder, statistics...) sees the same stream.
+ */
+class GraphSink
+{
+public:
+    virtual ~GraphSink() = default;
+
+    /**
+     * Called once per vertex, in file order, before any edge.
+     *
+     * @param vertex The parsed vertex.
+     */
+    virtual void onVertex(const Vertex &vertex) = 0;
+
+    /**
+     * Called once per edge, in file order, with its weight already resolved.
+     *
+     * @param edge The parsed edge.
+     */
+    virtual void onEdge(const Edge &edge) = 0;
+
+    /**
+     * Called after the last edge has been emitted.
+     */
+    virtual void onFinish() {}
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "GraphStatistics.h"
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+
+GraphStatistics::GraphStatistics()
+    : minWeight(std::numeric_limits<double>::max()), maxWeight(std::numeric_limits<double>::lowest()),
+      minLon(std::numeric_limits<double>::max()), maxLon(std::numeric_limits<double>::lowest()),
+      minLat(std::numeric_limits<double>::max()), maxLat(std::numeric_limits<double>::lowest())
+{
+}
+
+void GraphStatistics::onVertex(const Vertex &vertex)
+{
+    vertexCount++;
+    minLon = std::min(minLon, vertex.getLongitude());
+    maxLon = std::max(maxLon, vertex.getLongitude());
+    minLat = std::min(minLat, vertex.getLatitude());
+    maxLat = std::max(maxLat, vertex.getLatitude());
+}
+
+void GraphStatistics::onEdge(const Edge &edge)
+{
+    edgeCount++;
+    if (edge.getStartId() == edge.getEndId())
+        selfLoopCount++;
+    totalWeight += edge.getWeight();
+    minWeight = std::min(minWeight, edge.getWeight());
+    maxWeight = std::max(maxWeight, edge.getWeight());
+}
+
+void GraphStatistics::print(std::ostream &out) const
+{
+    out << "Vertices = " << vertexCount << ", edges = " << edgeCount << ", self loops = " << selfLoopCount << std::endl;
+    if (edgeCount > 0)
+    {
+        out << "Edge length: total = " << std::fixed << std::setprecision(2) << totalWeight
+            << ", min = " << minWeight << ", max = " << maxWeight
+            << ", mean = " << totalWeight / edgeCount << std::endl;
+    }
+    if (vertexCount > 0)
+    {
+        out << "Bounding box: longitude [" << std::setprecision(6) << minLon << ", " << maxLon
+            << "], latitude [" << minLat << ", " << maxLat << "]" << std::endl;
+    }
+}
\ No newline at end of file
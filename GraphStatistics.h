@@ -0,0 +1,42 @@
+#ifndef GRAPHSTATISTICS_H
+#define GRAPHSTATISTICS_H
+
+#include <cstddef>
+#include <ostream>
+#include "GraphSink.h"
+
+/**
+ * Graph sink collecting summary statistics of a loaded graph file.
+ */
+class GraphStatistics : public GraphSink
+{
+private:
+    size_t vertexCount = 0;
+    size_t edgeCount = 0;
+    size_t selfLoopCount = 0;
+    double totalWeight = 0.0;
+    double minWeight, maxWeight;
+    double minLon, maxLon, minLat, maxLat;
+
+public:
+    /* Constructor & destructor */
+    GraphStatistics();
+    ~GraphStatistics() = default;
+
+    void onVertex(const Vertex &vertex) override;
+    void onEdge(const Edge &edge) override;
+
+    /* Getters */
+    size_t getVertexCount() const { return vertexCount; }
+    size_t getEdgeCount() const { return edgeCount; }
+    double getTotalWeight() const { return totalWeight; }
+
+    /**
+     * Prints the statistics in a human readable form.
+     *
+     * @param out The stream to print to.
+     */
+    void print(std::ostream &out) const;
+};
+
+#endif
\ No newline at end of file
@@ -2,8 +2,6 @@
 #include "utils.h"
 #include <stdexcept>
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <stdexcept>
 #include <limits>
 #include <QPen>
@@ -11,7 +9,7 @@
 #include <QPointF>
 #include <QRectF>
 
-GraphicGraph::GraphicGraph(const std::string &filename, QGraphicsScene *scene) : Graph(filename), graphicsScene(scene),
+GraphicGraph::GraphicGraph(const std::string &filename, QGraphicsScene *scene) : Graph(), graphicsScene(scene),
                                                                                  minLon(std::numeric_limits<double>::max()), maxLon(std::numeric_limits<double>::lowest()),
                                                                                  minLat(std::numeric_limits<double>::max()), maxLat(std::numeric_limits<double>::lowest())
 {
@@ -24,12 +22,13 @@ GraphicGraph::GraphicGraph(const std::string &filename, QGraphicsScene *scene) :
         }
     }
 
-    this->initializeFromFile(filename);
+    // Loaded here rather than by the base constructor so that the single parsing pass
+    // reaches the scene-building overrides of addVertex and addEdge
+    initializeFromFile(filename);
 }
 
 GraphicGraph::~GraphicGraph()
 {
-    Graph::~Graph();
     for (auto &item : vertexItems)
     {
         if (item.second)
@@ -42,96 +41,6 @@ GraphicGraph::~GraphicGraph()
     }
 }
 
-void GraphicGraph::initializeFromFile(const std::string &filename)
-{
-    std::ifstream file(filename);
-    if (!file.is_open())
-    {
-        throw std::runtime_error("Error: could not open file " + filename);
-    }
-
-    int vertexCount = 0;
-    int edgeCount = 0;
-    std::string line;
-    int lineNumber = 0;
-
-    while (std::getline(file, line))
-    {
-        lineNumber++;
-
-        if (line.empty() || line[0] == '#')
-            continue; // skip empty lines or comments
-
-        std::string_view sv(line);
-        char type = sv.front();
-        sv.remove_prefix(2); // remove "V," or "E,"
-
-        if (type == 'V')
-        {
-            uint32_t id;
-            double longitude, latitude;
-
-            try
-            {
-                id = std::stoi(std::string(utils::nextField(sv)));
-                longitude = std::stod(std::string(utils::nextField(sv)));
-                latitude = std::stod(std::string(utils::nextField(sv)));
-            }
-            catch (const std::invalid_argument &e)
-            {
-                throw std::runtime_error("Parsing error at line " + std::to_string(lineNumber) +
-                                         ": Invalid number format in vertex definition (possibly due to comments or malformed data).\n" +
-                                         "Line content: " + line + "\n" +
-                                         "Hint: Check for inline comments (//) or non-numeric characters.");
-            }
-            catch (const std::out_of_range &e)
-            {
-                throw std::runtime_error("Parsing error at line " + std::to_string(lineNumber) +
-                                         ": Number out of range in vertex definition.\n" +
-                                         "Line content: " + line);
-            }
-
-            Vertex v(id, longitude, latitude);
-            this->addVertex(v);
-            vertexCount++;
-        }
-        else if (type == 'E')
-        {
-            std::string parsedWeight;
-            uint32_t idStart, idEnd;
-            double weight;
-
-            try
-            {
-                idStart = std::stoi(std::string(utils::nextField(sv)));
-                idEnd = std::stoi(std::string(utils::nextField(sv)));
-                parsedWeight = std::string(utils::nextField(sv));
-                weight = parsedWeight.empty() || parsedWeight == "0" ? utils::computeEuclideanDistance(*this, getVertex(idStart), getVertex(idEnd))
-                                                                     : std::stod(parsedWeight);
-            }
-            catch (const std::invalid_argument &e)
-            {
-                throw std::runtime_error("Parsing error at line " + std::to_string(lineNumber) +
-                                         ": Invalid number format in edge definition (possibly due to comments or malformed data).\n" +
-                                         "Line content: " + line + "\n" +
-                                         "Hint: Check for inline comments (//) or non-numeric characters.");
-            }
-            catch (const std::out_of_range &e)
-            {
-                throw std::runtime_error("Parsing error at line " + std::to_string(lineNumber) +
-                                         ": Number out of range in edge definition.\n" +
-                                         "Line content: " + line);
-            }
-
-            Edge e(idStart, idEnd, weight);
-            this->addEdge(e);
-            edgeCount++;
-        }
-    }
-
-    file.close();
-}
-
 void GraphicGraph::addVertex(const Vertex &vertex)
 {
     Graph::addVertex(vertex);
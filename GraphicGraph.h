@@ -6,6 +6,10 @@
 #include <QGraphicsEllipseItem>
 #include <QGraphicsLineItem>
 
+/**
+ * Graph that also builds its Qt scene while loading: the overridden addVertex() and
+ * addEdge() act as the scene builder sink of the single GraphBuilder pass.
+ */
 class GraphicGraph : public Graph
 {
 public:
@@ -13,14 +17,6 @@ public:
     GraphicGraph(const std::string &filename, QGraphicsScene *scene);
     ~GraphicGraph();
 
-    /**
-     * Helper method to initialize the graph from a file.
-     * Extends the base class method for graphical setup.
-     *
-     * @param filename The name of the file containing the graph data.
-     */
-    void initializeFromFile(const std::string &filename) override;
-
     /**
      * Adds a vertex to the graph and creates its graphical representation.
      *
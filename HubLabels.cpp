@@ -0,0 +1,231 @@
+#include "HubLabels.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    constexpr uint64_t kNoDistance = std::numeric_limits<uint64_t>::max();
+
+    // Label entry during construction, with its exact distance in meters
+    struct Entry
+    {
+        uint32_t hub; // Rank of the hub
+        double distance;
+        uint32_t next; // Neighbor the entry was inherited from, kInvalidIndex for the vertex itself
+    };
+
+    using Label = std::vector<Entry>;
+
+    // Owned label arrays of labels built in memory
+    struct OwnedLabels
+    {
+        std::vector<uint64_t> forwardOffsets;
+        std::vector<uint32_t> forwardHubs;
+        std::vector<uint32_t> forwardDistances;
+        std::vector<uint64_t> backwardOffsets;
+        std::vector<uint32_t> backwardHubs;
+        std::vector<uint32_t> backwardDistances;
+    };
+
+    // Shortest distance through a hub common to a forward and a backward label, both sorted by hub
+    double meet(const Label &forward, const Label &backward)
+    {
+        double best = std::numeric_limits<double>::infinity();
+        size_t i = 0, j = 0;
+        while (i < forward.size() && j < backward.size())
+        {
+            if (forward[i].hub == backward[j].hub)
+                best = std::min(best, forward[i].distance + backward[j].distance);
+            uint32_t a = forward[i].hub, b = backward[j].hub;
+            i += a <= b;
+            j += b <= a;
+        }
+        return best;
+    }
+
+    uint32_t toCentimeters(double meters)
+    {
+        double centimeters = std::round(meters * 100.0);
+        if (!(centimeters < std::numeric_limits<uint32_t>::max()))
+            throw std::runtime_error("Error: label distance " + std::to_string(meters) + " cannot be stored in centimeters.");
+        return static_cast<uint32_t>(centimeters);
+    }
+
+    // Appends the labels to the compressed arrays
+    void compress(const std::vector<Label> &labels, std::vector<uint64_t> &offsets, std::vector<uint32_t> &hubs,
+                  std::vector<uint32_t> &distances, std::vector<uint32_t> *next)
+    {
+        offsets.reserve(labels.size() + 1);
+        offsets.push_back(0);
+        for (const Label &label : labels)
+        {
+            for (const Entry &entry : label)
+            {
+                hubs.push_back(entry.hub);
+                distances.push_back(toCentimeters(entry.distance));
+                if (next)
+                    next->push_back(entry.next);
+            }
+            offsets.push_back(hubs.size());
+        }
+    }
+}
+
+HubLabels::HubLabels(std::shared_ptr<const ContractionHierarchy> source, bool withPaths)
+    : weightVersion(source->version())
+{
+    const uint32_t n = source->vertexCount();
+    std::vector<uint32_t> byRank(n);
+    for (uint32_t v = 0; v < n; ++v)
+        byRank[source->rank(v)] = v;
+
+    std::vector<Label> forward(n), backward(n);
+    std::vector<double> best(n, std::numeric_limits<double>::infinity());
+    std::vector<uint32_t> next(n), touched;
+
+    // The label of v merges the labels of its higher ranked neighbors, which are final already
+    auto build = [&](uint32_t v, const ContractionHierarchy::SearchGraph &graph, std::vector<Label> &labels,
+                     const std::vector<Label> &opposite, bool isForward)
+    {
+        touched.clear();
+        auto relax = [&](uint32_t hub, double distance, uint32_t from)
+        {
+            if (best[hub] == std::numeric_limits<double>::infinity())
+                touched.push_back(hub);
+            if (distance < best[hub])
+            {
+                best[hub] = distance;
+                next[hub] = from;
+            }
+        };
+        relax(source->rank(v), 0.0, CompactGraph::kInvalidIndex);
+        graph.forEachEdge(v, [&](uint32_t neighbor, double weight)
+                          {
+            for (const Entry &entry : labels[neighbor])
+                relax(entry.hub, weight + entry.distance, neighbor); });
+
+        std::sort(touched.begin(), touched.end());
+        Label candidates;
+        candidates.reserve(touched.size());
+        for (uint32_t hub : touched)
+        {
+            candidates.push_back({hub, best[hub], next[hub]});
+            best[hub] = std::numeric_limits<double>::infinity();
+        }
+
+        // Entries beaten through another hub are not shortest distances and never needed by a query
+        Label &label = labels[v];
+        for (const Entry &entry : candidates)
+        {
+            const Label &hubLabel = opposite[byRank[entry.hub]];
+            double through = isForward ? meet(candidates, hubLabel) : meet(hubLabel, candidates);
+            if (!(through < entry.distance))
+                label.push_back(entry);
+        }
+    };
+    for (uint32_t rank = n; rank-- > 0;)
+    {
+        uint32_t v = byRank[rank];
+        build(v, source->upward(), forward, backward, true);
+        build(v, source->downward(), backward, forward, false);
+    }
+
+    auto owned = std::make_shared<OwnedLabels>();
+    compress(forward, owned->forwardOffsets, owned->forwardHubs, owned->forwardDistances, withPaths ? &forwardNext : nullptr);
+    compress(backward, owned->backwardOffsets, owned->backwardHubs, owned->backwardDistances, withPaths ? &backwardNext : nullptr);
+    if (withPaths)
+    {
+        hierarchy = std::move(source);
+        vertexOfRank = std::move(byRank);
+    }
+
+    data = Arrays{owned->forwardOffsets, owned->forwardHubs, owned->forwardDistances,
+                  owned->backwardOffsets, owned->backwardHubs, owned->backwardDistances};
+    storage = std::move(owned);
+}
+
+HubLabels::HubLabels(std::shared_ptr<const void> storage, const Arrays &arrays, uint64_t version)
+    : storage(std::move(storage)), weightVersion(version), data(arrays)
+{
+}
+
+std::pair<uint64_t, uint32_t> HubLabels::intersect(uint32_t fromIndex, uint32_t toIndex) const
+{
+    const uint32_t *forwardHubs = data.forwardHubs.data() + data.forwardOffsets[fromIndex];
+    const uint32_t *forwardDistances = data.forwardDistances.data() + data.forwardOffsets[fromIndex];
+    const size_t forwardSize = data.forwardOffsets[fromIndex + 1] - data.forwardOffsets[fromIndex];
+    const uint32_t *backwardHubs = data.backwardHubs.data() + data.backwardOffsets[toIndex];
+    const uint32_t *backwardDistances = data.backwardDistances.data() + data.backwardOffsets[toIndex];
+    const size_t backwardSize = data.backwardOffsets[toIndex + 1] - data.backwardOffsets[toIndex];
+
+    // Sorted merge: both cursors advance without data-dependent branches, except on a common hub
+    uint64_t best = kNoDistance;
+    uint32_t bestHub = 0;
+    size_t i = 0, j = 0;
+    while (i < forwardSize && j < backwardSize)
+    {
+        uint32_t a = forwardHubs[i], b = backwardHubs[j];
+        if (a == b)
+        {
+            uint64_t through = static_cast<uint64_t>(forwardDistances[i]) + backwardDistances[j];
+            bestHub = through < best ? a : bestHub;
+            best = std::min(best, through);
+        }
+        i += a <= b;
+        j += b <= a;
+    }
+    return {best, bestHub};
+}
+
+double HubLabels::distance(uint32_t fromIndex, uint32_t toIndex) const
+{
+    uint64_t centimeters = intersect(fromIndex, toIndex).first;
+    return centimeters == kNoDistance ? std::numeric_limits<double>::infinity() : centimeters / 100.0;
+}
+
+std::vector<uint32_t> HubLabels::path(uint32_t fromIndex, uint32_t toIndex) const
+{
+    if (!hierarchy)
+        throw std::runtime_error("Error: these hub labels were built without paths.");
+
+    auto [centimeters, hub] = intersect(fromIndex, toIndex);
+    std::vector<uint32_t> indices;
+    if (centimeters == kNoDistance)
+        return indices;
+    const uint32_t hubIndex = vertexOfRank[hub];
+
+    // Position of the hub in a label, which holds it by construction along the path
+    auto find = [&](std::span<const uint64_t> offsets, std::span<const uint32_t> hubs, uint32_t index)
+    {
+        auto begin = hubs.begin() + offsets[index], end = hubs.begin() + offsets[index + 1];
+        return static_cast<size_t>(std::lower_bound(begin, end, hub) - hubs.begin());
+    };
+
+    // Up from the start to the hub, then down from the hub to the end, unpacking every hierarchy edge
+    indices.push_back(fromIndex);
+    for (uint32_t u = fromIndex; u != hubIndex;)
+    {
+        uint32_t w = forwardNext[find(data.forwardOffsets, data.forwardHubs, u)];
+        hierarchy->unpack(u, w, indices);
+        u = w;
+    }
+    std::vector<uint32_t> down = {toIndex};
+    for (uint32_t u = toIndex; u != hubIndex;)
+    {
+        u = backwardNext[find(data.backwardOffsets, data.backwardHubs, u)];
+        down.push_back(u);
+    }
+    for (size_t i = down.size() - 1; i > 0; --i)
+        hierarchy->unpack(down[i], down[i - 1], indices);
+    return indices;
+}
+
+size_t HubLabels::memoryUsage() const
+{
+    return data.forwardOffsets.size_bytes() + data.forwardHubs.size_bytes() + data.forwardDistances.size_bytes() +
+           data.backwardOffsets.size_bytes() + data.backwardHubs.size_bytes() + data.backwardDistances.size_bytes() +
+           (forwardNext.size() + backwardNext.size() + vertexOfRank.size()) * sizeof(uint32_t);
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#ifndef HUBLABELS_H
+#define HUBLABELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+#include "ContractionHierarchy.h"
+
+/**
+ * Hub labels for distance queries that only intersect two sorted arrays.
+ *
+ * Every vertex v gets a forward label of hubs h with d(v, h) and a backward label of hubs
+ * with d(h, v), such that every shortest path contains a hub of both labels. Labels are the
+ * upward and downward search spaces of a ContractionHierarchy, built in decreasing rank
+ * order from the labels of the higher ranked neighbors and pruned of every entry that
+ * the other labels already cover with a shorter distance.
+ *
+ * Labels are compressed into parallel arrays of 32-bit hub ranks (sorted) and 32-bit
+ * centimeter distances, so that a query is a branch-light merge over contiguous integers;
+ * distances are exact to about a centimeter. With paths enabled, every entry also keeps
+ * the next vertex towards its hub, and paths are unpacked through the hierarchy.
+ * Like CompactGraph, the arrays are read through spans so that they can be mapped from a
+ * snapshot; labels loaded that way answer distance queries only.
+ */
+class HubLabels
+{
+public:
+    /* Views over the label arrays, in snapshot order */
+    struct Arrays
+    {
+        std::span<const uint64_t> forwardOffsets;    // vertexCount() + 1 entries into the forward arrays
+        std::span<const uint32_t> forwardHubs;       // Hub ranks, increasing within every label
+        std::span<const uint32_t> forwardDistances;  // d(v, hub) in centimeters
+        std::span<const uint64_t> backwardOffsets;   // vertexCount() + 1 entries into the backward arrays
+        std::span<const uint32_t> backwardHubs;
+        std::span<const uint32_t> backwardDistances; // d(hub, v) in centimeters
+    };
+
+    /* Constructor & destructor */
+    HubLabels() = default;
+    ~HubLabels() = default;
+
+    /**
+     * Builds the labels from a contraction hierarchy.
+     * Throws an exception if a distance cannot be stored in centimeters.
+     *
+     * @param source The hierarchy providing the vertex order and the search graphs.
+     * @param withPaths True to also keep what path() needs; the hierarchy is then kept alive.
+     */
+    HubLabels(std::shared_ptr<const ContractionHierarchy> source, bool withPaths);
+
+    /**
+     * Wraps externally owned label arrays without copying them, e.g. from a snapshot.
+     *
+     * @param storage The object owning the memory the arrays point into.
+     * @param arrays The views over the labels.
+     * @param version The weight version of the graph the labels were computed on.
+     */
+    HubLabels(std::shared_ptr<const void> storage, const Arrays &arrays, uint64_t version);
+
+    /**
+     * Computes the shortest distance between two vertices by intersecting their labels.
+     *
+     * @param fromIndex The dense index of the start vertex.
+     * @param toIndex The dense index of the end vertex.
+     * @return The distance in meters, infinity if there is no path.
+     */
+    double distance(uint32_t fromIndex, uint32_t toIndex) const;
+
+    /**
+     * Computes a shortest path between two vertices. Throws an exception if the labels
+     * were built without paths.
+     *
+     * @param fromIndex The dense index of the start vertex.
+     * @param toIndex The dense index of the end vertex.
+     * @return The dense indices of the path from fromIndex to toIndex, empty if there is none.
+     */
+    std::vector<uint32_t> path(uint32_t fromIndex, uint32_t toIndex) const;
+
+    /* True if path() is available */
+    bool hasPaths() const { return hierarchy != nullptr; }
+
+    /* Number of vertices, weight version and total number of label entries */
+    uint32_t vertexCount() const { return data.forwardOffsets.empty() ? 0 : static_cast<uint32_t>(data.forwardOffsets.size() - 1); }
+    uint64_t version() const { return weightVersion; }
+    size_t entryCount() const { return data.forwardHubs.size() + data.backwardHubs.size(); }
+
+    /**
+     * Gets the number of bytes held by the labels, including the path data if any.
+     *
+     * @return The memory footprint in bytes.
+     */
+    size_t memoryUsage() const;
+
+    /* Raw views over the labels, e.g. for serialization */
+    const Arrays &arrays() const { return data; }
+
+private:
+    std::shared_ptr<const void> storage; // Keeps the memory behind the spans alive
+    std::shared_ptr<const ContractionHierarchy> hierarchy; // Only set with paths
+    std::vector<uint32_t> forwardNext;   // Per forward entry: next vertex on the path to the hub
+    std::vector<uint32_t> backwardNext;  // Per backward entry: previous vertex on the path from the hub
+    std::vector<uint32_t> vertexOfRank;  // Dense index of every hub rank, with paths only
+    uint64_t weightVersion = 0;
+    Arrays data;
+
+    /**
+     * Intersects the forward label of a vertex with the backward label of another.
+     *
+     * @return {distance in centimeters, or UINT64_MAX, hub rank of the best meeting}.
+     */
+    std::pair<uint64_t, uint32_t> intersect(uint32_t fromIndex, uint32_t toIndex) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include "Isochrone.h"
+#include "DaryHeap.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace
+{
+    using Point = std::pair<double, double>;
+
+    // Budget-bounded Dijkstra from sourceIndex on the double weights
+    isochrone::Isochrone search(const CompactGraph &compact, uint32_t sourceIndex, double budget, SearchWorkspace &workspace)
+    {
+        isochrone::Isochrone area;
+        area.sourceId = compact.idOf(sourceIndex);
+        area.budget = budget;
+
+        DaryHeap<double> &queue = workspace.queue<DaryHeap<double>>();
+        workspace.begin<DoubleWeights>(compact.vertexCount());
+        queue.clear(compact.vertexCount());
+        workspace.reach(sourceIndex, 0.0, CompactGraph::kInvalidIndex);
+        queue.push(sourceIndex, 0.0);
+        while (!queue.empty())
+        {
+            uint32_t current = queue.pop();
+            double distance = workspace.distance<DoubleWeights>(current);
+            if (distance > budget)
+                break; // Every vertex still queued is beyond the budget
+            workspace.settle(current);
+            area.vertexIds.push_back(compact.idOf(current));
+            area.distances.push_back(distance);
+
+            compact.forEachEdge(current, [&](uint32_t neighbor, double weight)
+                                {
+                double updated = distance + weight;
+                if (updated > budget && weight != std::numeric_limits<double>::infinity()) // Closed roads lead nowhere
+                    area.boundary.push_back({compact.idOf(current), compact.idOf(neighbor), distance, (budget - distance) / weight});
+                if (updated < workspace.distance<DoubleWeights>(neighbor))
+                {
+                    workspace.reach(neighbor, updated, current);
+                    queue.push(neighbor, updated);
+                } });
+        }
+        return area;
+    }
+
+    // Cross product of (a - o) and (b - o): positive for a counter-clockwise turn
+    double cross(const Point &o, const Point &a, const Point &b)
+    {
+        return (a.first - o.first) * (b.second - o.second) - (a.second - o.second) * (b.first - o.first);
+    }
+}
+
+isochrone::Isochrone isochrone::compute(const Graph &graph, uint32_t sourceId, double budget, SearchWorkspace &workspace)
+{
+    Graph::SearchView view = graph.getSearchView(); // Pinned for the whole query, even if weights are updated
+    uint32_t sourceIndex = view.compact.indexOf(sourceId);
+    if (sourceIndex == CompactGraph::kInvalidIndex)
+        throw std::runtime_error("Error: vertex " + std::to_string(sourceId) + " not found in the graph.");
+    return search(view.compact, sourceIndex, budget, workspace);
+}
+
+std::vector<isochrone::Isochrone> isochrone::computeAll(const Graph &graph, const std::vector<uint32_t> &sourceIds,
+                                                        double budget, unsigned threadCount)
+{
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<Isochrone> areas(sourceIds.size());
+    std::atomic<size_t> next{0};
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+    auto worker = [&]()
+    {
+        SearchWorkspace workspace;
+        for (size_t i = next++; i < sourceIds.size(); i = next++)
+        {
+            try
+            {
+                areas[i] = compute(graph, sourceIds[i], budget, workspace);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure)
+                    failure = std::current_exception();
+                next = sourceIds.size(); // Stop every thread
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < threadCount && t < sourceIds.size(); ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread &thread : threads)
+        thread.join();
+
+    if (failure)
+        std::rethrow_exception(failure);
+    return areas;
+}
+
+std::vector<std::pair<double, double>> isochrone::outline(const Graph &graph, const Isochrone &area)
+{
+    CompactGraph compact = graph.getCompact();
+    std::vector<Point> points;
+    points.reserve(area.vertexIds.size() + area.boundary.size());
+    for (uint32_t id : area.vertexIds)
+    {
+        uint32_t index = compact.indexOf(id);
+        points.emplace_back(compact.longitude(index), compact.latitude(index));
+    }
+    for (const BoundaryEdge &edge : area.boundary)
+    {
+        uint32_t from = compact.indexOf(edge.fromId);
+        uint32_t to = compact.indexOf(edge.toId);
+        points.emplace_back(compact.longitude(from) + edge.fraction * (compact.longitude(to) - compact.longitude(from)),
+                            compact.latitude(from) + edge.fraction * (compact.latitude(to) - compact.latitude(from)));
+    }
+
+    // Andrew's monotone chain; the hull is affine invariant, so longitude and latitude need no projection
+    std::sort(points.begin(), points.end());
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    if (points.size() < 3)
+        return points;
+    std::vector<Point> hull(2 * points.size());
+    size_t size = 0;
+    for (const Point &point : points) // Lower hull
+    {
+        while (size >= 2 && cross(hull[size - 2], hull[size - 1], point) <= 0)
+            size--;
+        hull[size++] = point;
+    }
+    size_t lowerSize = size + 1;
+    for (size_t i = points.size() - 1; i-- > 0;) // Upper hull
+    {
+        while (size >= lowerSize && cross(hull[size - 2], hull[size - 1], points[i]) <= 0)
+            size--;
+        hull[size++] = points[i];
+    }
+    hull.resize(size - 1); // The last point is the first one again
+    return hull;
+}
+
+void isochrone::writeCsv(const std::vector<Isochrone> &areas, std::ostream &out)
+{
+    out << "source,kind,from,to,distance,fraction\n"
+        << std::fixed << std::setprecision(2);
+    for (const Isochrone &area : areas)
+    {
+        for (size_t i = 0; i < area.vertexIds.size(); ++i)
+            out << area.sourceId << ",vertex," << area.vertexIds[i] << ",," << area.distances[i] << ",\n";
+        for (const BoundaryEdge &edge : area.boundary)
+            out << area.sourceId << ",boundary," << edge.fromId << ',' << edge.toId << ',' << edge.fromDistance << ','
+                << std::setprecision(4) << edge.fraction << std::setprecision(2) << '\n';
+    }
+    out.flush();
+}
+
+void isochrone::writeGeoJson(const Graph &graph, const std::vector<Isochrone> &areas, std::ostream &out)
+{
+    out << "{\"type\":\"FeatureCollection\",\"features\":[" << std::fixed;
+    for (size_t a = 0; a < areas.size(); ++a)
+    {
+        std::vector<Point> corners = outline(graph, areas[a]);
+        out << (a > 0 ? "," : "") << "\n{\"type\":\"Feature\",\"properties\":{\"source\":" << areas[a].sourceId
+            << ",\"budget\":" << std::setprecision(2) << areas[a].budget << ",\"vertices\":" << areas[a].vertexIds.size()
+            << "},\"geometry\":" << std::setprecision(7);
+        if (corners.empty())
+        {
+            out << "null}";
+            continue;
+        }
+        if (corners.size() == 1)
+        {
+            out << "{\"type\":\"Point\",\"coordinates\":[" << corners[0].first << ',' << corners[0].second << "]}}";
+            continue;
+        }
+
+        // Collinear points only span a segment
+        bool polygon = corners.size() >= 3;
+        out << (polygon ? "{\"type\":\"Polygon\",\"coordinates\":[[" : "{\"type\":\"LineString\",\"coordinates\":[");
+        if (polygon)
+            corners.push_back(corners.front()); // GeoJSON rings are closed
+        for (size_t i = 0; i < corners.size(); ++i)
+            out << (i > 0 ? "," : "") << '[' << corners[i].first << ',' << corners[i].second << ']';
+        out << (polygon ? "]]}}" : "]}}");
+    }
+    out << "\n]}\n";
+    out.flush();
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#ifndef ISOCHRONE_H
+#define ISOCHRONE_H
+
+#include <cstdint>
+#include <ostream>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+#include "SearchWorkspace.h"
+
+/**
+ * Reachability within a distance budget ("everything within X meters of a vertex"), e.g. for
+ * service-area analysis.
+ *
+ * A Dijkstra search from the source stops as soon as the smallest queued distance exceeds the
+ * budget, so it only touches the area and its fringe. The result holds the reached vertices and
+ * the boundary edges: the edges leaving a reached vertex whose far end is beyond the budget,
+ * with the fraction of the edge that is still within it. Isochrones of several sources are
+ * computed in parallel, one search workspace per thread.
+ */
+namespace isochrone
+{
+    /* Edge crossed by the budget: from is reached, the budget runs out before to */
+    struct BoundaryEdge
+    {
+        uint32_t fromId;
+        uint32_t toId;
+        double fromDistance; // Distance of fromId from the source in meters
+        double fraction;     // Part of the edge within the budget, in [0, 1)
+    };
+
+    /* Area reachable from one source */
+    struct Isochrone
+    {
+        uint32_t sourceId = 0;
+        double budget = 0.0;
+        std::vector<uint32_t> vertexIds;  // Reached vertices, by increasing distance
+        std::vector<double> distances;    // Distance of every reached vertex in meters
+        std::vector<BoundaryEdge> boundary;
+    };
+
+    /**
+     * @brief Computes the area reachable from a vertex within a budget, on the double weights.
+     * Throws an exception if the vertex does not exist.
+     *
+     * @param graph The graph to search.
+     * @param sourceId The source vertex ID.
+     * @param budget The largest distance in meters.
+     * @param workspace The workspace to reuse; it must not be used by another query meanwhile.
+     * @return The reached vertices and boundary edges.
+     */
+    Isochrone compute(const Graph &graph, uint32_t sourceId, double budget, SearchWorkspace &workspace);
+
+    /**
+     * @brief Computes the isochrones of several sources with the same budget, in parallel.
+     * Throws an exception if a vertex does not exist.
+     *
+     * @param graph The graph to search.
+     * @param sourceIds The source vertex IDs.
+     * @param budget The largest distance in meters.
+     * @param threadCount The number of threads to use; 0 picks one per hardware thread.
+     * @return One isochrone per source, in the order of the sources.
+     */
+    std::vector<Isochrone> computeAll(const Graph &graph, const std::vector<uint32_t> &sourceIds, double budget,
+                                      unsigned threadCount = 0);
+
+    /**
+     * @brief Computes the outline of an isochrone: the convex hull of its reached vertices and of
+     * the points where the budget runs out along its boundary edges.
+     *
+     * @param graph The graph the isochrone was computed on.
+     * @param area The isochrone.
+     * @return The (longitude, latitude) corners, counter-clockwise, without repeating the first one;
+     *         a single point or the two ends of a segment when the area has no surface.
+     */
+    std::vector<std::pair<double, double>> outline(const Graph &graph, const Isochrone &area);
+
+    /**
+     * @brief Writes isochrones as CSV with the columns source, kind, from, to, distance, fraction:
+     * one "vertex" row per reached vertex (empty to and fraction) and one "boundary" row per
+     * boundary edge (distance of its from vertex).
+     *
+     * @param areas The isochrones.
+     * @param out The stream to write to.
+     */
+    void writeCsv(const std::vector<Isochrone> &areas, std::ostream &out);
+
+    /**
+     * @brief Writes the outlines of isochrones as a GeoJSON FeatureCollection of polygons,
+     * with the source and budget as properties. An outline with fewer than 3 corners is
+     * written as a Point or a LineString, since a polygon ring needs 4 positions.
+     *
+     * @param graph The graph the isochrones were computed on.
+     * @param areas The isochrones.
+     * @param out The stream to write to.
+     */
+    void writeGeoJson(const Graph &graph, const std::vector<Isochrone> &areas, std::ostream &out);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,293 @@
+#include "Landmarks.h"
+#include "DaryHeap.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    constexpr double kInfinity = std::numeric_limits<double>::infinity();
+    constexpr uint32_t kSeed = 20220311; // First root of the selection, for reproducible landmarks
+
+    // Owned tables of landmarks computed in memory
+    struct OwnedTables
+    {
+        std::vector<uint32_t> indices;
+        std::vector<double> fromLandmark;
+        std::vector<double> toLandmark;
+    };
+
+    /**
+     * One-to-all Dijkstra from source, on the outgoing edges or, with a reverse adjacency,
+     * on the incoming ones. Optionally records the shortest path tree.
+     */
+    void oneToAll(const CompactGraph &graph, const ReverseAdjacency *reverse, uint32_t source,
+                  std::vector<double> &distance, DaryHeap<double> &queue, std::vector<uint32_t> *parent = nullptr)
+    {
+        distance.assign(graph.vertexCount(), kInfinity);
+        if (parent)
+            parent->assign(graph.vertexCount(), CompactGraph::kInvalidIndex);
+        queue.clear(graph.vertexCount());
+
+        distance[source] = 0.0;
+        queue.push(source, 0.0);
+        while (!queue.empty())
+        {
+            uint32_t u = queue.pop();
+            auto relax = [&](uint32_t v, double weight)
+            {
+                double updated = distance[u] + weight;
+                if (updated < distance[v])
+                {
+                    distance[v] = updated;
+                    if (parent)
+                        (*parent)[v] = u;
+                    queue.push(v, updated);
+                }
+            };
+            if (reverse)
+                reverse->forEachEdge(graph, u, relax);
+            else
+                graph.forEachEdge(u, relax);
+        }
+    }
+
+    // Current landmark lower bound of d(from, to) over the selected landmarks, from the forward rows only
+    double selectionBound(const std::vector<std::vector<double>> &rows, uint32_t from, uint32_t to)
+    {
+        double bound = 0.0;
+        for (const std::vector<double> &row : rows)
+        {
+            if (std::isfinite(row[from]) && std::isfinite(row[to]))
+                bound = std::max(bound, row[to] - row[from]);
+        }
+        return bound;
+    }
+
+    /**
+     * Farthest selection: the first landmark is the vertex farthest from the root, every
+     * next one the reachable vertex whose distance to the nearest selected landmark is the largest.
+     */
+    std::vector<uint32_t> selectFarthest(const CompactGraph &graph, uint32_t count, uint32_t root)
+    {
+        std::vector<uint32_t> selected;
+        std::vector<double> nearest(graph.vertexCount(), kInfinity), distance;
+        DaryHeap<double> queue;
+
+        oneToAll(graph, nullptr, root, distance, queue);
+        uint32_t next = root;
+        for (uint32_t v = 0; v < graph.vertexCount(); ++v)
+        {
+            if (std::isfinite(distance[v]) && distance[v] > distance[next])
+                next = v;
+        }
+
+        while (selected.size() < count)
+        {
+            selected.push_back(next);
+            oneToAll(graph, nullptr, next, distance, queue);
+
+            double farthest = 0.0;
+            for (uint32_t v = 0; v < graph.vertexCount(); ++v)
+            {
+                nearest[v] = std::min(nearest[v], distance[v]);
+                if (std::isfinite(nearest[v]) && nearest[v] > farthest)
+                {
+                    farthest = nearest[v];
+                    next = v;
+                }
+            }
+            if (farthest == 0.0)
+                break; // Every reachable vertex is already a landmark
+        }
+        return selected;
+    }
+
+    /**
+     * Avoid selection (Goldberg and Werneck): grow a shortest path tree from a root, weight
+     * every vertex by how much the current bound underestimates its distance from the root,
+     * and pick the leaf at the end of the heaviest branch not yet covered by a landmark.
+     */
+    std::vector<uint32_t> selectAvoid(const CompactGraph &graph, uint32_t count, uint32_t root)
+    {
+        const uint32_t n = graph.vertexCount();
+        std::vector<uint32_t> selected = selectFarthest(graph, 1, root);
+        std::vector<std::vector<double>> rows; // Forward distances of the selected landmarks
+        std::vector<double> distance;
+        std::vector<uint32_t> parent, order;
+        std::vector<double> size(n);
+        DaryHeap<double> queue;
+
+        for (uint32_t landmark : selected)
+        {
+            oneToAll(graph, nullptr, landmark, distance, queue);
+            rows.push_back(distance);
+        }
+
+        while (selected.size() < count && !selected.empty())
+        {
+            oneToAll(graph, nullptr, root, distance, queue, &parent);
+
+            // Children after parents: by increasing distance from the root
+            order.clear();
+            for (uint32_t v = 0; v < n; ++v)
+            {
+                if (std::isfinite(distance[v]))
+                    order.push_back(v);
+            }
+            std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+                      { return distance[a] < distance[b] || (distance[a] == distance[b] && a < b); });
+
+            // Subtree sizes in reverse order; subtrees containing a landmark weigh nothing
+            std::vector<char> covered(n, 0);
+            for (uint32_t landmark : selected)
+                covered[landmark] = 1;
+            for (uint32_t v : order)
+                size[v] = distance[v] - selectionBound(rows, root, v);
+            for (auto it = order.rbegin(); it != order.rend(); ++it)
+            {
+                uint32_t v = *it, p = parent[v];
+                if (covered[v])
+                    size[v] = 0.0;
+                if (p != CompactGraph::kInvalidIndex)
+                {
+                    if (covered[v])
+                        covered[p] = 1;
+                    size[p] += size[v];
+                }
+            }
+
+            // Walk down the heaviest branch to a leaf
+            uint32_t best = CompactGraph::kInvalidIndex;
+            for (uint32_t v : order)
+            {
+                if (size[v] > 0.0 && (best == CompactGraph::kInvalidIndex || size[v] > size[best]))
+                    best = v;
+            }
+            if (best == CompactGraph::kInvalidIndex)
+                break; // Bounds are already exact from this root
+            while (true)
+            {
+                uint32_t heaviest = CompactGraph::kInvalidIndex;
+                for (uint32_t edge = graph.edgeBegin(best); edge < graph.edgeEnd(best); ++edge)
+                {
+                    uint32_t child = graph.target(edge);
+                    if (parent[child] == best && size[child] > 0.0 &&
+                        (heaviest == CompactGraph::kInvalidIndex || size[child] > size[heaviest]))
+                        heaviest = child;
+                }
+                if (heaviest == CompactGraph::kInvalidIndex)
+                    break;
+                best = heaviest;
+            }
+
+            selected.push_back(best);
+            oneToAll(graph, nullptr, best, distance, queue);
+            rows.push_back(distance);
+
+            // Next root: a pseudo-random vertex, so that landmarks spread over the graph
+            root = static_cast<uint32_t>((static_cast<uint64_t>(root) * 2654435761u + selected.size()) % n);
+        }
+        return selected;
+    }
+}
+
+Landmarks::Landmarks(const CompactGraph &graph, const ReverseAdjacency &reverse, uint32_t count,
+                     const std::string &strategy, unsigned threadCount)
+    : weightVersion(graph.version())
+{
+    auto owned = std::make_shared<OwnedTables>();
+    const uint32_t n = graph.vertexCount();
+    if (n > 0 && count > 0)
+    {
+        uint32_t first = kSeed % n;
+        if (strategy == "farthest")
+            owned->indices = selectFarthest(graph, count, first);
+        else if (strategy == "avoid")
+            owned->indices = selectAvoid(graph, count, first);
+        else
+            throw std::runtime_error("Error: Unknown landmark strategy '" + strategy + "'. Use farthest or avoid.");
+    }
+
+    // One Dijkstra run per landmark and direction, spread over the threads
+    const uint32_t k = static_cast<uint32_t>(owned->indices.size());
+    owned->fromLandmark.assign(static_cast<size_t>(n) * k, kInfinity);
+    owned->toLandmark.assign(static_cast<size_t>(n) * k, kInfinity);
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min<unsigned>(threadCount, std::max<uint32_t>(1, 2 * k));
+
+    std::atomic<uint32_t> nextRun{0};
+    auto worker = [&]()
+    {
+        std::vector<double> distance;
+        DaryHeap<double> queue;
+        for (uint32_t run = nextRun++; run < 2 * k; run = nextRun++)
+        {
+            uint32_t landmark = run / 2;
+            bool backward = run % 2 == 1;
+            oneToAll(graph, backward ? &reverse : nullptr, owned->indices[landmark], distance, queue);
+            std::vector<double> &table = backward ? owned->toLandmark : owned->fromLandmark;
+            for (uint32_t v = 0; v < n; ++v)
+                table[static_cast<size_t>(v) * k + landmark] = distance[v];
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread &thread : threads)
+        thread.join();
+
+    data = Arrays{owned->indices, owned->fromLandmark, owned->toLandmark};
+    storage = std::move(owned);
+}
+
+Landmarks::Landmarks(std::shared_ptr<const void> storage, const Arrays &arrays, uint64_t version)
+    : storage(std::move(storage)), weightVersion(version), data(arrays)
+{
+}
+
+std::vector<uint32_t> Landmarks::selectActive(uint32_t fromIndex, uint32_t toIndex, uint32_t activeCount) const
+{
+    std::vector<std::pair<double, uint32_t>> bounds; // {-bound, landmark} so that the best come first
+    for (uint32_t k = 0; k < count(); ++k)
+    {
+        uint32_t single[] = {k};
+        bounds.emplace_back(-lowerBound(fromIndex, toIndex, single), k);
+    }
+    std::sort(bounds.begin(), bounds.end());
+
+    std::vector<uint32_t> active;
+    for (size_t i = 0; i < bounds.size() && active.size() < activeCount; ++i)
+        active.push_back(bounds[i].second);
+    return active;
+}
+
+double Landmarks::lowerBound(uint32_t fromIndex, uint32_t toIndex, std::span<const uint32_t> active) const
+{
+    const size_t k = count();
+    const double *fromRow = data.fromLandmark.data() + fromIndex * k;
+    const double *toRow = data.fromLandmark.data() + toIndex * k;
+    const double *fromRowBackward = data.toLandmark.data() + fromIndex * k;
+    const double *toRowBackward = data.toLandmark.data() + toIndex * k;
+
+    // Infinite entries (unreachable landmarks) give no usable bound and are skipped
+    double bound = 0.0;
+    for (uint32_t landmark : active)
+    {
+        if (std::isfinite(toRow[landmark]) && std::isfinite(fromRow[landmark]))
+            bound = std::max(bound, toRow[landmark] - fromRow[landmark]); // d(L, t) - d(L, v)
+        if (std::isfinite(fromRowBackward[landmark]) && std::isfinite(toRowBackward[landmark]))
+            bound = std::max(bound, fromRowBackward[landmark] - toRowBackward[landmark]); // d(v, L) - d(t, L)
+    }
+    return bound;
+}
+
+size_t Landmarks::memoryUsage() const
+{
+    return data.indices.size_bytes() + data.fromLandmark.size_bytes() + data.toLandmark.size_bytes();
+}
\ No newline at end of file
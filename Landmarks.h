@@ -0,0 +1,107 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#include "CompactGraph.h"
+#include "ReverseAdjacency.h"
+
+/**
+ * Landmark distance tables for ALT (A*, Landmarks, Triangle inequality) queries.
+ *
+ * For every landmark L the shortest distances d(L, v) from it and d(v, L) to it are
+ * stored for every vertex. By the triangle inequality, max(d(L, t) - d(L, v), d(v, L) - d(t, L))
+ * is a lower bound of d(v, t), usually much tighter than the straight-line distance on
+ * road networks with rivers, bridges and one-way streets.
+ *
+ * Tables are vertex-major (the entries of all landmarks for one vertex are contiguous)
+ * and, like the CompactGraph arrays, read through spans so that they can point into a
+ * memory-mapped snapshot. They are only valid for the weight version they were built from.
+ */
+class Landmarks
+{
+public:
+    /* Views over the landmark tables, in snapshot order */
+    struct Arrays
+    {
+        std::span<const uint32_t> indices;    // Dense index of every landmark
+        std::span<const double> fromLandmark; // d(L_k, v) at [v * count() + k], infinity if unreachable
+        std::span<const double> toLandmark;   // d(v, L_k) at [v * count() + k], infinity if unreachable
+    };
+
+    /* Constructor & destructor */
+    Landmarks() = default;
+    ~Landmarks() = default;
+
+    /**
+     * Selects landmarks and computes their distance tables with parallel Dijkstra runs.
+     * Throws an exception for an unknown selection strategy.
+     *
+     * @param graph The compact graph.
+     * @param reverse The reverse adjacency of the graph, for distances to the landmarks.
+     * @param count The number of landmarks.
+     * @param strategy "farthest" (each landmark is the vertex farthest from the previous ones)
+     *                 or "avoid" (landmarks are placed where the current bounds are weakest).
+     * @param threadCount The number of threads to use; 0 picks one per hardware thread.
+     */
+    Landmarks(const CompactGraph &graph, const ReverseAdjacency &reverse, uint32_t count,
+              const std::string &strategy, unsigned threadCount = 0);
+
+    /**
+     * Wraps externally owned tables without copying them, e.g. from a snapshot.
+     *
+     * @param storage The object owning the memory the arrays point into.
+     * @param arrays The views over the tables.
+     * @param version The weight version of the graph the tables were computed on.
+     */
+    Landmarks(std::shared_ptr<const void> storage, const Arrays &arrays, uint64_t version);
+
+    /* Number of landmarks and weight version of the tables */
+    uint32_t count() const { return static_cast<uint32_t>(data.indices.size()); }
+    uint64_t version() const { return weightVersion; }
+
+    /* Number of vertices covered by the tables */
+    uint32_t vertexCount() const { return count() > 0 ? static_cast<uint32_t>(data.fromLandmark.size() / count()) : 0; }
+
+    /**
+     * Picks the landmarks giving the best bound between two vertices, for use as the
+     * active set of a query.
+     *
+     * @param fromIndex The dense index of the start vertex.
+     * @param toIndex The dense index of the target vertex.
+     * @param activeCount The maximum number of landmarks to pick.
+     * @return The landmark numbers (0 to count() - 1), best first.
+     */
+    std::vector<uint32_t> selectActive(uint32_t fromIndex, uint32_t toIndex, uint32_t activeCount) const;
+
+    /**
+     * Computes the landmark lower bound of the distance between two vertices.
+     *
+     * @param fromIndex The dense index of the vertex.
+     * @param toIndex The dense index of the target vertex.
+     * @param active The landmark numbers to use.
+     * @return The lower bound in meters, 0 if no landmark gives one.
+     */
+    double lowerBound(uint32_t fromIndex, uint32_t toIndex, std::span<const uint32_t> active) const;
+
+    /**
+     * Gets the number of bytes held by the tables.
+     *
+     * @return The memory footprint in bytes.
+     */
+    size_t memoryUsage() const;
+
+    /* Raw views over the tables, e.g. for serialization */
+    const Arrays &arrays() const { return data; }
+
+private:
+    std::shared_ptr<const void> storage; // Keeps the memory behind the spans alive
+    uint64_t weightVersion = 0;
+    Arrays data;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef LAZYBINARYHEAP_H
+#define LAZYBINARYHEAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * Binary min-heap of dense vertex indices with lazy deletion.
+ *
+ * There is no decrease-key: push() always inserts, and the outdated entries of a vertex
+ * stay in the heap until they are popped. Searches skip them because the vertex is
+ * already settled by then. The heap is a plain vector, so operations never allocate
+ * once it has grown to the size of the frontier.
+ */
+template <typename Key>
+class LazyBinaryHeap
+{
+public:
+    /* Constructor & destructor */
+    LazyBinaryHeap() = default;
+    ~LazyBinaryHeap() = default;
+
+    /* Empties the heap; the graph size is not needed without a position index */
+    void clear(uint32_t) { heap.clear(); }
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+
+    /**
+     * Inserts a vertex, possibly a second time with a smaller key.
+     *
+     * @param index The dense index of the vertex.
+     * @param key The priority of the vertex.
+     */
+    void push(uint32_t index, Key key)
+    {
+        heap.emplace_back(key, index);
+        std::push_heap(heap.begin(), heap.end(), std::greater<>());
+    }
+
+    /**
+     * Removes the entry with the smallest key (ties by smallest index).
+     *
+     * @return The dense index of its vertex, which may already be settled.
+     */
+    uint32_t pop()
+    {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+        uint32_t index = heap.back().second;
+        heap.pop_back();
+        return index;
+    }
+
+private:
+    std::vector<std::pair<Key, uint32_t>> heap; // {key, vertexIndex}
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string &filename)
+{
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Error: could not open file " + filename);
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Error: could not stat file " + filename);
+    }
+    mappedSize = static_cast<size_t>(info.st_size);
+
+    if (mappedSize > 0)
+    {
+        void *address = ::mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED)
+        {
+            ::close(fd);
+            throw std::runtime_error("Error: could not map file " + filename);
+        }
+        mappedData = static_cast<const char *>(address);
+    }
+    ::close(fd); // The mapping stays valid after closing the descriptor
+}
+
+MappedFile::~MappedFile()
+{
+    if (mappedData)
+    {
+        ::munmap(const_cast<char *>(mappedData), mappedSize);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Read-only memory mapping of a whole file.
+ * The mapping is released when the object is destroyed; it cannot be copied.
+ */
+class MappedFile
+{
+private:
+    const char *mappedData = nullptr;
+    size_t mappedSize = 0;
+
+public:
+    /**
+     * Maps the given file into memory.
+     * Throws an exception if the file cannot be opened or mapped.
+     *
+     * @param filename The name of the file to map.
+     */
+    explicit MappedFile(const std::string &filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /* Getters */
+    const char *data() const { return mappedData; }
+    size_t size() const { return mappedSize; }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "MultiLevelOverlay.h"
+#include "DaryHeap.h"
+#include "SearchWorkspace.h"
+#include "utils.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+MultiLevelOverlay::MultiLevelOverlay(const CompactGraph &graph, const ReverseAdjacency &reverse, uint32_t levelCount,
+                                     uint32_t fanout, unsigned threadCount)
+{
+    auto start = Clock::now();
+    auto shared = std::make_shared<Topology>();
+    const uint32_t n = graph.vertexCount();
+    shared->levels = std::max<uint32_t>(1, levelCount);
+    shared->fanoutBits = static_cast<uint32_t>(std::countr_zero(std::bit_ceil(std::max<uint32_t>(2, fanout))));
+
+    // One recursive bisection along small cuts into level 1 cells of kCellSize / 2 to kCellSize vertices on
+    // average; the cells of level l are the prefixes of their numbers. A level with fewer cells than the
+    // fanout is dropped: nearly every vertex would share a cell with the start or the end there
+    uint32_t levelOneCells = std::bit_ceil(std::max<uint32_t>(1, n / kCellSize));
+    while (shared->levels > 1 && (levelOneCells >> (shared->fanoutBits * (shared->levels - 1))) < (1u << shared->fanoutBits))
+        shared->levels--;
+    shared->cells = utils::flowPartition(graph, reverse, levelOneCells);
+    topology = shared;
+
+    for (uint32_t level = 1; level <= shared->levels; ++level)
+    {
+        Level &data = shared->levelData.emplace_back();
+        uint32_t cells = levelOneCells >> (shared->fanoutBits * (level - 1));
+
+        // A vertex is on the boundary if it has an outgoing or incoming edge to another cell
+        std::vector<uint32_t> boundaryCells;
+        std::vector<uint32_t> counts(cells, 0);
+        data.position.assign(n, CompactGraph::kInvalidIndex);
+        for (uint32_t v = 0; v < n; ++v)
+        {
+            uint32_t cell = cellOf(level, v);
+            bool boundary = false;
+            for (uint32_t e = graph.edgeBegin(v); e < graph.edgeEnd(v) && !boundary; ++e)
+                boundary = cellOf(level, graph.target(e)) != cell;
+            for (uint32_t r = reverse.edgeBegin(v); r < reverse.edgeEnd(v) && !boundary; ++r)
+                boundary = cellOf(level, reverse.source(r)) != cell;
+            if (boundary)
+            {
+                data.position[v] = counts[cell]++;
+                boundaryCells.push_back(v);
+            }
+        }
+
+        data.cellOffsets.assign(cells + 1, 0);
+        data.weightOffsets.assign(cells + 1, 0);
+        for (uint32_t c = 0; c < cells; ++c)
+        {
+            data.cellOffsets[c + 1] = data.cellOffsets[c] + counts[c];
+            data.weightOffsets[c + 1] = data.weightOffsets[c] + static_cast<uint64_t>(counts[c]) * counts[c];
+        }
+        data.boundary.resize(data.cellOffsets.back());
+        for (uint32_t v : boundaryCells)
+            data.boundary[data.cellOffsets[cellOf(level, v)] + data.position[v]] = v;
+    }
+    shared->partitionTime = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+
+    customize(graph, threadCount, nullptr);
+}
+
+MultiLevelOverlay MultiLevelOverlay::customized(const CompactGraph &graph, const CompactGraph &previous, unsigned threadCount) const
+{
+    MultiLevelOverlay overlay;
+    overlay.topology = topology;
+    overlay.weights = weights;
+    overlay.customize(graph, threadCount, &previous);
+    return overlay;
+}
+
+void MultiLevelOverlay::customize(const CompactGraph &graph, unsigned threadCount, const CompactGraph *previous)
+{
+    auto start = Clock::now();
+    const uint32_t n = graph.vertexCount();
+    weightVersion = graph.version();
+    if (!previous)
+        weights.assign(topology->levels, {});
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    // A cell needs new cliques if it holds the tail of a changed edge: the edges inside it at level 1,
+    // and at the levels above the cut edges and the cliques of its subcells all come from such edges
+    std::vector<std::vector<uint8_t>> changed(topology->levels);
+    if (previous)
+    {
+        for (uint32_t level = 1; level <= topology->levels; ++level)
+            changed[level - 1].assign(cellCount(level), 0);
+        for (uint32_t v = 0; v < n; ++v)
+        {
+            for (uint32_t e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e)
+            {
+                if (graph.weight(e) != previous->weight(e))
+                {
+                    for (uint32_t level = 1; level <= topology->levels; ++level)
+                        changed[level - 1][cellOf(level, v)] = 1;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Bottom-up: the cliques of a level are searched over the cliques of the level below
+    for (uint32_t level = 1; level <= topology->levels; ++level)
+    {
+        const Level &data = topology->levelData[level - 1];
+        std::vector<uint32_t> pending; // Cells to customize
+        for (uint32_t cell = 0; cell < cellCount(level); ++cell)
+        {
+            if (!previous || changed[level - 1][cell])
+                pending.push_back(cell);
+        }
+        const uint32_t cells = static_cast<uint32_t>(pending.size());
+        if (!previous)
+            weights[level - 1].assign(data.weightOffsets.back(), std::numeric_limits<double>::infinity());
+
+        std::atomic<uint32_t> nextCell{0};
+        auto worker = [&]()
+        {
+            SearchWorkspace workspace;
+            DaryHeap<double> queue;
+            for (uint32_t task = nextCell++; task < cells; task = nextCell++)
+            {
+                uint32_t cell = pending[task];
+                uint32_t first = data.cellOffsets[cell];
+                uint32_t size = data.cellOffsets[cell + 1] - first;
+                for (uint32_t i = 0; i < size; ++i)
+                {
+                    workspace.begin<DoubleWeights>(n);
+                    queue.clear(n);
+                    workspace.reach(data.boundary[first + i], 0.0, CompactGraph::kInvalidIndex);
+                    queue.push(data.boundary[first + i], 0.0);
+                    uint32_t remaining = size; // Boundary vertices of the cell not settled yet
+                    while (!queue.empty() && remaining > 0)
+                    {
+                        uint32_t u = queue.pop();
+                        double distance = workspace.distance<DoubleWeights>(u);
+                        workspace.settle(u);
+                        if (data.position[u] != CompactGraph::kInvalidIndex && cellOf(level, u) == cell)
+                            remaining--;
+
+                        auto relax = [&](uint32_t v, double weight)
+                        {
+                            double updated = distance + weight;
+                            if (updated < workspace.distance<DoubleWeights>(v))
+                            {
+                                workspace.reach(v, updated, u);
+                                queue.push(v, updated);
+                            }
+                        };
+                        if (level == 1)
+                        {
+                            graph.forEachEdge(u, [&](uint32_t v, double weight)
+                                              {
+                                if (cellOf(1, v) == cell)
+                                    relax(v, weight); });
+                        }
+                        else
+                        {
+                            // Clique of the cell of u one level down, then the cut edges between such cells inside this cell
+                            forEachCliqueEdge(level - 1, u, relax);
+                            graph.forEachEdge(u, [&](uint32_t v, double weight)
+                                              {
+                                if (cellOf(level - 1, v) != cellOf(level - 1, u) && cellOf(level, v) == cell)
+                                    relax(v, weight); });
+                        }
+                    }
+
+                    double *row = weights[level - 1].data() + data.weightOffsets[cell] + static_cast<size_t>(i) * size;
+                    for (uint32_t j = 0; j < size; ++j)
+                        row[j] = workspace.distance<DoubleWeights>(data.boundary[first + j]);
+                }
+            }
+        };
+        std::vector<std::thread> threads;
+        for (unsigned t = 1; t < threadCount && t < cells; ++t)
+            threads.emplace_back(worker);
+        worker();
+        for (std::thread &thread : threads)
+            thread.join();
+    }
+    customizeTime = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+}
+
+size_t MultiLevelOverlay::boundaryCount() const
+{
+    size_t count = 0;
+    for (const Level &data : topology->levelData)
+        count += data.boundary.size();
+    return count;
+}
+
+size_t MultiLevelOverlay::cliqueEntryCount() const
+{
+    size_t count = 0;
+    for (const std::vector<double> &level : weights)
+        count += level.size();
+    return count;
+}
+
+size_t MultiLevelOverlay::memoryUsage() const
+{
+    size_t bytes = topology->cells.size() * sizeof(uint32_t);
+    for (const Level &data : topology->levelData)
+    {
+        bytes += (data.cellOffsets.size() + data.boundary.size() + data.position.size()) * sizeof(uint32_t) +
+                 data.weightOffsets.size() * sizeof(uint64_t);
+    }
+    return bytes + cliqueEntryCount() * sizeof(double);
+}
\ No newline at end of file
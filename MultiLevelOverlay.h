@@ -0,0 +1,185 @@
+#ifndef MULTILEVELOVERLAY_H
+#define MULTILEVELOVERLAY_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "CompactGraph.h"
+#include "ReverseAdjacency.h"
+
+/**
+ * Multi-level overlay for customizable route planning (CRP): preprocessing split into a
+ * metric-independent part, run once, and a customization that only depends on the weights.
+ *
+ * The metric-independent part partitions the vertices into nested cells with one recursive
+ * bisection along small edge cuts (utils::flowPartition()), so that cells have few boundary
+ * vertices: level 1 has cells of at most kCellSize vertices on average, and every cell of level
+ * l + 1 is the union of fanout cells of level l. The boundary vertices of a cell are those with an edge to or from another cell of the
+ * same level. The customization computes, for every cell, the clique of shortest distances inside
+ * the cell between all its boundary vertices: on the original edges at level 1, and on the
+ * cliques and cut edges of level l - 1 above it. The cells of a level are customized in parallel.
+ *
+ * A query is a bidirectional Dijkstra search where a vertex in a cell of level l that holds
+ * neither the start nor the end only relaxes the clique of that cell and its edges leaving the
+ * cell, so that far away regions are crossed in a few hops. Weight changes only need a new
+ * customization (see customized()), which reads the weights of the compact graph and only
+ * recomputes the cells, at every level, that hold an edge whose weight changed.
+ */
+class MultiLevelOverlay
+{
+public:
+    /* Largest average number of vertices of a level 1 cell */
+    static constexpr uint32_t kCellSize = 256;
+
+    /**
+     * Partitions the graph and customizes the overlay for its weights.
+     *
+     * @param graph The compact graph.
+     * @param reverse The reverse adjacency of the graph, to partition it and find the boundary vertices.
+     * @param levelCount The largest number of overlay levels, at least 1; levels that would have fewer cells than the fanout are dropped.
+     * @param fanout The number of cells of a level grouped into a cell of the level above, a power of two.
+     * @param threadCount The number of threads to use; 0 picks one per hardware thread.
+     */
+    MultiLevelOverlay(const CompactGraph &graph, const ReverseAdjacency &reverse, uint32_t levelCount,
+                      uint32_t fanout = 8, unsigned threadCount = 0);
+
+    /**
+     * Customizes the overlay for new weights of the same graph, reusing the partition and the
+     * cliques of the cells where no weight changed.
+     *
+     * @param graph The compact graph with the new weights; its topology must be the one partitioned.
+     * @param previous The compact graph this overlay was customized for.
+     * @param threadCount The number of threads to use; 0 picks one per hardware thread.
+     * @return The overlay for the new weights.
+     */
+    MultiLevelOverlay customized(const CompactGraph &graph, const CompactGraph &previous, unsigned threadCount = 0) const;
+
+    /* Number of levels, cells grouped per cell above, weight version of the cliques and number of cells of a level (1 to levelCount()) */
+    uint32_t levelCount() const { return topology->levels; }
+    uint32_t fanout() const { return 1u << topology->fanoutBits; }
+    uint64_t version() const { return weightVersion; }
+    uint32_t cellCount(uint32_t level) const { return static_cast<uint32_t>(topology->levelData[level - 1].cellOffsets.size() - 1); }
+
+    /* Cell of a vertex at a level */
+    uint32_t cellOf(uint32_t level, uint32_t index) const { return topology->cells[index] >> (topology->fanoutBits * (level - 1)); }
+
+    /**
+     * Gets the level a query from start to end explores a vertex at: the highest level where the
+     * cell of the vertex holds neither the start nor the end, 0 if there is none.
+     *
+     * @param index The dense index of the vertex.
+     * @param startIndex The dense index of the start vertex.
+     * @param endIndex The dense index of the end vertex.
+     * @return The query level, from 0 to levelCount().
+     */
+    uint32_t queryLevel(uint32_t index, uint32_t startIndex, uint32_t endIndex) const
+    {
+        for (uint32_t level = topology->levels; level >= 1; --level)
+        {
+            uint32_t cell = cellOf(level, index);
+            if (cell != cellOf(level, startIndex) && cell != cellOf(level, endIndex))
+                return level;
+        }
+        return 0;
+    }
+
+    /* True if the vertex is a boundary vertex of its cell at the level */
+    bool isBoundary(uint32_t level, uint32_t index) const
+    {
+        return topology->levelData[level - 1].position[index] != CompactGraph::kInvalidIndex;
+    }
+
+    /**
+     * Visits the clique edges from a boundary vertex to the other boundary vertices of its cell.
+     *
+     * @param level The level of the cell.
+     * @param index The dense index of a boundary vertex at that level.
+     * @param visit Callable invoked as visit(targetIndex, distance) for every boundary vertex of the cell.
+     */
+    template <typename Visitor>
+    void forEachCliqueEdge(uint32_t level, uint32_t index, Visitor &&visit) const
+    {
+        const Level &data = topology->levelData[level - 1];
+        uint32_t cell = cellOf(level, index);
+        uint32_t first = data.cellOffsets[cell];
+        uint32_t size = data.cellOffsets[cell + 1] - first;
+        const double *row = weights[level - 1].data() + data.weightOffsets[cell] + static_cast<size_t>(data.position[index]) * size;
+        for (uint32_t j = 0; j < size; ++j)
+            visit(data.boundary[first + j], row[j]);
+    }
+
+    /**
+     * Visits the clique edges to a boundary vertex from the other boundary vertices of its cell.
+     *
+     * @param level The level of the cell.
+     * @param index The dense index of a boundary vertex at that level.
+     * @param visit Callable invoked as visit(sourceIndex, distance) for every boundary vertex of the cell.
+     */
+    template <typename Visitor>
+    void forEachCliqueEdgeBackward(uint32_t level, uint32_t index, Visitor &&visit) const
+    {
+        const Level &data = topology->levelData[level - 1];
+        uint32_t cell = cellOf(level, index);
+        uint32_t first = data.cellOffsets[cell];
+        uint32_t size = data.cellOffsets[cell + 1] - first;
+        const double *column = weights[level - 1].data() + data.weightOffsets[cell] + data.position[index];
+        for (uint32_t i = 0; i < size; ++i)
+            visit(data.boundary[first + i], column[static_cast<size_t>(i) * size]);
+    }
+
+    /* Number of boundary vertices and clique entries over all levels */
+    size_t boundaryCount() const;
+    size_t cliqueEntryCount() const;
+
+    /* Time taken by the partition and by the last customization */
+    std::chrono::milliseconds partitionTime() const { return topology->partitionTime; }
+    std::chrono::milliseconds customizationTime() const { return customizeTime; }
+
+    /**
+     * Gets the number of bytes held by the partition and the cliques.
+     *
+     * @return The memory footprint in bytes.
+     */
+    size_t memoryUsage() const;
+
+private:
+    /* Boundary vertices and clique layout of the cells of one level */
+    struct Level
+    {
+        std::vector<uint32_t> cellOffsets;   // Boundary vertices of cell c are boundary[cellOffsets[c]..cellOffsets[c + 1]]
+        std::vector<uint32_t> boundary;      // Dense indices, grouped by cell
+        std::vector<uint32_t> position;      // Position of every vertex among the boundary vertices of its cell, or kInvalidIndex
+        std::vector<uint64_t> weightOffsets; // The size x size clique of cell c starts at weightOffsets[c], row-major
+    };
+
+    /* Metric-independent part, shared by all the customizations */
+    struct Topology
+    {
+        uint32_t levels = 0;
+        uint32_t fanoutBits = 0;
+        std::vector<uint32_t> cells; // Cell of every vertex at level 1
+        std::vector<Level> levelData;
+        std::chrono::milliseconds partitionTime{0};
+    };
+
+    MultiLevelOverlay() = default;
+
+    /**
+     * Computes the cliques of every level, bottom-up, for the weights of the graph.
+     *
+     * @param graph The compact graph.
+     * @param threadCount The number of threads to use; 0 picks one per hardware thread.
+     * @param previous The graph the current cliques were computed for, to only recompute the cells
+     *                 holding a changed edge, or nullptr to compute them all.
+     */
+    void customize(const CompactGraph &graph, unsigned threadCount, const CompactGraph *previous);
+
+    std::shared_ptr<const Topology> topology;
+    std::vector<std::vector<double>> weights; // Clique distances of every level
+    uint64_t weightVersion = 0;
+    std::chrono::milliseconds customizeTime{0};
+};
+
+#endif
\ No newline at end of file
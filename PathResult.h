@@ -0,0 +1,54 @@
+#ifndef PATHRESULT_H
+#define PATHRESULT_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Outcome of a point-to-point search, returned by the algorithms instead of being
+ * printed from inside the search loop (see algorithms::printResult()).
+ */
+struct PathResult
+{
+    /* How the query ended */
+    enum class Status
+    {
+        Found,       // path holds the route
+        SameVertex,  // Start and end are the same vertex
+        NoNeighbors, // Start or end vertex has no outgoing edge
+        NotFound,    // Start or end vertex does not exist
+        NoPath       // The end vertex is unreachable
+    };
+
+    /* Algorithm that produced the result, it decides the wording of the report */
+    enum class Algorithm
+    {
+        Bfs,
+        Dijkstra,
+        AStar,
+        BidirectionalDijkstra,
+        BidirectionalAStar,
+        Alt,
+        ContractionHierarchy,
+        HubLabels,
+        ArcFlags,
+        MultiLevelOverlay
+    };
+
+    Status status = Status::NoPath;
+    Algorithm algorithm = Algorithm::Dijkstra;
+    uint32_t startVertexId = 0;
+    uint32_t endVertexId = 0;
+    std::vector<uint32_t> path;         // Vertex IDs from start to end
+    std::vector<double> lengths;        // Cumulative length in meters at every path vertex
+    double cost = 0.0;                  // Length of the whole path in meters
+    uint32_t visitedCount = 0;          // Number of vertices visited (settled) by the search
+    std::chrono::microseconds setupTime{0};  // Preparing the workspace
+    std::chrono::microseconds searchTime{0}; // Search and path reconstruction
+
+    /* True if a path was found */
+    bool found() const { return status == Status::Found; }
+};
+
+#endif
\ No newline at end of file
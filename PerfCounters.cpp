@@ -0,0 +1,79 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <cstring>
+#include <initializer_list>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+    int openCounter(uint64_t config)
+    {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.size = sizeof(attributes);
+        attributes.config = config;
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+
+    uint64_t readCounter(int fd)
+    {
+        uint64_t value = 0;
+        if (fd < 0 || ::read(fd, &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value)))
+            return 0;
+        return value;
+    }
+}
+
+PerfCounters::PerfCounters()
+{
+    cacheMissesFd = openCounter(PERF_COUNT_HW_CACHE_MISSES);
+    if (cacheMissesFd >= 0)
+        cacheReferencesFd = openCounter(PERF_COUNT_HW_CACHE_REFERENCES);
+}
+
+PerfCounters::~PerfCounters()
+{
+    if (cacheMissesFd >= 0)
+        ::close(cacheMissesFd);
+    if (cacheReferencesFd >= 0)
+        ::close(cacheReferencesFd);
+}
+
+void PerfCounters::start()
+{
+    for (int fd : {cacheMissesFd, cacheReferencesFd})
+    {
+        if (fd >= 0)
+        {
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+PerfCounters::Reading PerfCounters::stop()
+{
+    for (int fd : {cacheMissesFd, cacheReferencesFd})
+    {
+        if (fd >= 0)
+            ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+    return Reading{readCounter(cacheMissesFd), readCounter(cacheReferencesFd)};
+}
+
+#else
+
+PerfCounters::PerfCounters() {}
+PerfCounters::~PerfCounters() {}
+void PerfCounters::start() {}
+PerfCounters::Reading PerfCounters::stop() { return Reading{}; }
+
+#endif
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <cstdint>
+
+/**
+ * Hardware cache counters of the calling thread, read through Linux perf events.
+ * When perf events are not available (other platforms, containers, restrictive
+ * perf_event_paranoid settings) available() is false and every reading is zero.
+ */
+class PerfCounters
+{
+private:
+    int cacheMissesFd = -1;
+    int cacheReferencesFd = -1;
+
+public:
+    /* Counter values between start() and stop() */
+    struct Reading
+    {
+        uint64_t cacheMisses = 0;
+        uint64_t cacheReferences = 0;
+    };
+
+    /* Constructor & destructor */
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    /**
+     * Checks whether the hardware counters could be opened.
+     *
+     * @return True if readings are meaningful.
+     */
+    bool available() const { return cacheMissesFd >= 0; }
+
+    /* Resets and enables the counters */
+    void start();
+
+    /**
+     * Disables the counters and reads them.
+     *
+     * @return The counts since the last start().
+     */
+    Reading stop();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,161 @@
+#ifndef PRIORITYQUEUE_H
+#define PRIORITYQUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Priority queues of dense vertex indices used by Dijkstra and A*.
+ *
+ * Every implementation has the same interface: clear(vertexCount) before a query,
+ * empty(), push(index, key) to insert a vertex or lower its key, and pop() to remove
+ * the vertex with the smallest key. Queues without decrease-key (LazyBinaryHeap,
+ * RadixHeap) may pop outdated entries of already settled vertices, which the searches
+ * skip. The queue of a search is a template parameter; QueueType selects it at runtime.
+ */
+enum class QueueType
+{
+    Set,        // SetQueue: the original red-black tree
+    DaryHeap,   // DaryHeap: indexed 4-ary heap with decrease-key
+    BinaryHeap, // LazyBinaryHeap: binary heap with lazy deletion
+    Radix       // RadixHeap: monotone bucket queue, integer weights only
+};
+
+/**
+ * @brief Parses a queue name as accepted on the command line.
+ * Throws an exception for unknown names.
+ *
+ * @param name One of "set", "dary", "binary" or "radix".
+ * @return The queue type.
+ */
+inline QueueType queueTypeFromName(const std::string &name)
+{
+    if (name == "set")
+        return QueueType::Set;
+    if (name == "dary")
+        return QueueType::DaryHeap;
+    if (name == "binary")
+        return QueueType::BinaryHeap;
+    if (name == "radix")
+        return QueueType::Radix;
+    throw std::runtime_error("Error: Unknown queue '" + name + "'. Use set, dary, binary, or radix.");
+}
+
+/**
+ * @brief Gets the command line name of a queue type.
+ *
+ * @param type The queue type.
+ * @return Its name.
+ */
+inline const char *queueTypeName(QueueType type)
+{
+    switch (type)
+    {
+    case QueueType::Set:
+        return "set";
+    case QueueType::DaryHeap:
+        return "dary";
+    case QueueType::BinaryHeap:
+        return "binary";
+    case QueueType::Radix:
+        return "radix";
+    }
+    return "";
+}
+
+/**
+ * Reference queue: a std::set of {key, index} pairs, where lowering a key erases the
+ * old pair and inserts the new one. Every operation allocates or frees a tree node.
+ */
+template <typename Key>
+class SetQueue
+{
+public:
+    /* Constructor & destructor */
+    SetQueue() = default;
+    ~SetQueue() = default;
+
+    void clear(uint32_t vertexCount)
+    {
+        if (queued.size() != vertexCount)
+        {
+            queued.assign(vertexCount, false);
+            queuedKey.resize(vertexCount);
+        }
+        else
+        {
+            for (const auto &entry : entries)
+                queued[entry.second] = false;
+        }
+        entries.clear();
+    }
+
+    bool empty() const { return entries.empty(); }
+    size_t size() const { return entries.size(); }
+
+    void push(uint32_t index, Key key)
+    {
+        if (queued[index])
+        {
+            if (!(key < queuedKey[index]))
+                return; // Not a decrease
+            entries.erase({queuedKey[index], index});
+        }
+        entries.insert({key, index});
+        queued[index] = true;
+        queuedKey[index] = key;
+    }
+
+    uint32_t pop()
+    {
+        uint32_t index = entries.begin()->second;
+        entries.erase(entries.begin());
+        queued[index] = false;
+        return index;
+    }
+
+private:
+    std::set<std::pair<Key, uint32_t>> entries; // {key, vertexIndex}
+    std::vector<bool> queued;
+    std::vector<Key> queuedKey;
+};
+
+/**
+ * First-in first-out queue with the same interface, for breadth-first searches: keys are
+ * ignored and vertices are popped in the order they were pushed. A vertex must be pushed
+ * at most once per query, so the search treats the first distance it reaches as final.
+ */
+class FifoQueue
+{
+public:
+    /* Tells the search kernel that the first reach of a vertex is final */
+    static constexpr bool kFirstReachFinal = true;
+
+    void clear(uint32_t)
+    {
+        entries.clear();
+        head = 0;
+    }
+
+    bool empty() const { return head == entries.size(); }
+    size_t size() const { return entries.size() - head; }
+
+    template <typename Key>
+    void push(uint32_t index, Key)
+    {
+        entries.push_back(index);
+    }
+
+    uint32_t pop() { return entries[head++]; }
+
+private:
+    std::vector<uint32_t> entries; // Pushed vertex indices, the buffer is kept across queries
+    size_t head = 0;               // Next entry to pop
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef QUANTIZEDGRAPH_H
+#define QUANTIZEDGRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CompactGraph.h"
+#include "WeightTraits.h"
+
+/**
+ * Integer variant of a CompactGraph, selected at compile time by its weight traits
+ * (CentimeterWeights or DecimeterWeights).
+ *
+ * Weights are stored as uint32_t multiples of the traits step, halving the bytes a
+ * search streams per edge weight. The graph adds to the compact graph rather than
+ * replacing it: the double weights stay resident for updates, snapshots and the
+ * preprocessing, so total memory grows by 4 bytes per edge. Coordinates are not
+ * quantized: the A* heuristics read the sphere coordinates built from the compact
+ * graph in every mode. The topology (offsets and targets) is shared with the compact
+ * graph it was built from, so dense indices and ID translation are the same.
+ * Path lengths match the double-precision graph within the quantization error.
+ */
+template <typename WeightTraits>
+class QuantizedGraph
+{
+public:
+    using Traits = WeightTraits;
+
+    /* Constructor & destructor */
+    QuantizedGraph() = default;
+    ~QuantizedGraph() = default;
+
+    /**
+     * Quantizes the weights of a compact graph.
+     * Throws an exception if a weight is negative or too large for the traits.
+     *
+     * @param graph The compact graph to quantize.
+     */
+    explicit QuantizedGraph(const CompactGraph &graph) : topology(graph)
+    {
+        const CompactGraph::Arrays &arrays = graph.arrays();
+        weights.reserve(arrays.weights.size());
+        for (double weight : arrays.weights)
+            weights.push_back(Traits::quantize(weight));
+    }
+
+    /* Weight version of the compact graph the quantized graph was built from */
+    uint64_t version() const { return topology.version(); }
+
+    /**
+     * Visits the outgoing edges of a vertex in storage order.
+     *
+     * @param index The dense index of the vertex.
+     * @param visit Callable invoked as visit(targetIndex, weight) with a quantized weight.
+     */
+    template <typename Visitor>
+    void forEachEdge(uint32_t index, Visitor &&visit) const
+    {
+        const CompactGraph::Arrays &arrays = topology.arrays();
+        for (uint32_t edge = arrays.offsets[index]; edge < arrays.offsets[index + 1]; ++edge)
+            visit(arrays.targets[edge], weights[edge]);
+    }
+
+    /* Quantized weight of an edge, by forward edge index */
+    typename Traits::Weight weight(uint32_t edge) const { return weights[edge]; }
+
+    /**
+     * Gets the number of bytes a search reads: shared offsets and targets plus the
+     * quantized weights.
+     *
+     * @return The memory footprint in bytes.
+     */
+    size_t memoryUsage() const
+    {
+        const CompactGraph::Arrays &arrays = topology.arrays();
+        return arrays.offsets.size_bytes() + arrays.targets.size_bytes() + weights.size() * sizeof(typename Traits::Weight);
+    }
+
+private:
+    CompactGraph topology; // Shares the offsets and targets arrays
+    std::vector<typename Traits::Weight> weights;
+};
+
+#endif
\ No newline at end of file
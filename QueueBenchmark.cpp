@@ -0,0 +1,179 @@
+#include "QueueBenchmark.h"
+#include "Graph.h"
+#include "algorithms.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t kSeed = 20220311; // Fixed, so that runs are comparable
+
+    struct RunTotals
+    {
+        uint64_t microseconds = 0;
+        uint64_t visited = 0;
+        uint32_t found = 0;
+        double costSum = 0.0;
+    };
+
+    // Random pairs of vertices with outgoing edges, by original ID
+    std::vector<std::pair<uint32_t, uint32_t>> randomQueries(const CompactGraph &compact, uint32_t queryCount)
+    {
+        std::vector<uint32_t> candidates;
+        for (uint32_t i = 0; i < compact.vertexCount(); ++i)
+        {
+            if (compact.degree(i) > 0)
+                candidates.push_back(compact.idOf(i));
+        }
+        std::vector<std::pair<uint32_t, uint32_t>> queries;
+        if (candidates.empty())
+            return queries;
+
+        std::mt19937 random(kSeed);
+        std::uniform_int_distribution<size_t> pick(0, candidates.size() - 1);
+        for (uint32_t i = 0; i < queryCount; ++i)
+        {
+            uint32_t start = candidates[pick(random)];
+            uint32_t end = candidates[pick(random)];
+            queries.emplace_back(start, end);
+        }
+        return queries;
+    }
+
+    RunTotals run(const Graph &graph, bool aStar, QueueType queueType, const std::vector<std::pair<uint32_t, uint32_t>> &queries)
+    {
+        SearchWorkspace workspace;
+        RunTotals totals;
+        for (const auto &[start, end] : queries)
+        {
+            PathResult result = aStar ? algorithms::aStar(graph, start, end, workspace, queueType)
+                                      : algorithms::dijkstra(graph, start, end, workspace, queueType);
+            totals.microseconds += result.searchTime.count();
+            totals.visited += result.visitedCount;
+            if (result.found())
+            {
+                totals.found++;
+                totals.costSum += result.cost;
+            }
+        }
+        return totals;
+    }
+}
+
+void benchmark::compareQueues(const CompactGraph &compact, uint32_t queryCount, std::ostream &out)
+{
+    Graph doubleGraph(compact);
+    Graph integerGraph(compact);
+    integerGraph.quantize<CentimeterWeights>();
+
+    std::vector<std::pair<uint32_t, uint32_t>> queries = randomQueries(compact, queryCount);
+    const QueueType queueTypes[] = {QueueType::Set, QueueType::DaryHeap, QueueType::BinaryHeap, QueueType::Radix};
+
+    out << "Queue benchmark: " << queries.size() << " random queries (A* heuristic kernel: " << SphereCoordinates::kernelName() << ")" << std::endl;
+    for (bool aStar : {false, true})
+    {
+        for (const Graph *graph : {&doubleGraph, &integerGraph})
+        {
+            for (QueueType queueType : queueTypes)
+            {
+                out << std::left << std::setw(9) << (aStar ? "astar" : "dijkstra") << std::setw(8)
+                    << (graph == &doubleGraph ? "double" : "cm") << std::setw(7) << queueTypeName(queueType) << std::right;
+                try
+                {
+                    RunTotals totals = run(*graph, aStar, queueType, queries);
+                    double perQuery = queries.empty() ? 0.0 : 1.0 / queries.size();
+                    out << std::fixed << std::setprecision(1)
+                        << " time = " << std::setw(10) << totals.microseconds << "us"
+                        << ", per query = " << std::setw(8) << totals.microseconds * perQuery << "us"
+                        << ", visited/query = " << std::setw(8) << totals.visited * perQuery
+                        << ", found = " << totals.found
+                        << ", cost sum = " << std::setprecision(2) << totals.costSum << std::endl;
+                }
+                catch (const std::runtime_error &e)
+                {
+                    out << " skipped: " << e.what() << std::endl;
+                }
+            }
+        }
+    }
+}
+
+void benchmark::reportHubLabels(const CompactGraph &compact, uint32_t queryCount, std::ostream &out)
+{
+    using Clock = std::chrono::steady_clock;
+    auto elapsed = [](Clock::time_point since)
+    { return std::chrono::duration<double, std::micro>(Clock::now() - since).count(); };
+
+    Graph graph(compact);
+    auto start = Clock::now();
+    graph.contract();
+    double contractTime = elapsed(start);
+    start = Clock::now();
+    graph.buildHubLabels(true);
+    double labelTime = elapsed(start);
+
+    std::shared_ptr<const HubLabels> labels = graph.getHubLabels();
+    std::shared_ptr<const ContractionHierarchy> hierarchy = graph.getHierarchy();
+    const HubLabels::Arrays &arrays = labels->arrays();
+    size_t largest = 0;
+    for (uint32_t v = 0; v < labels->vertexCount(); ++v)
+    {
+        largest = std::max<size_t>(largest, arrays.forwardOffsets[v + 1] - arrays.forwardOffsets[v]);
+        largest = std::max<size_t>(largest, arrays.backwardOffsets[v + 1] - arrays.backwardOffsets[v]);
+    }
+    double perVertex = 1.0 / std::max<uint32_t>(1, labels->vertexCount());
+
+    out << std::fixed << std::setprecision(1);
+    out << "Hub labels: built in " << contractTime / 1000 << "ms (contraction) + " << labelTime / 1000 << "ms (labels)" << std::endl;
+    out << "  entries = " << labels->entryCount() << ", mean label = " << labels->entryCount() * perVertex / 2
+        << ", largest label = " << largest << std::endl;
+    out << "  memory: labels = " << labels->memoryUsage() << " bytes (" << labels->memoryUsage() * perVertex
+        << " bytes/vertex), hierarchy = " << hierarchy->memoryUsage() << " bytes, graph = " << compact.memoryUsage()
+        << " bytes" << std::endl;
+
+    std::vector<std::pair<uint32_t, uint32_t>> queries = randomQueries(compact, queryCount);
+    double perQuery = queries.empty() ? 0.0 : 1.0 / queries.size();
+
+    // Raw label intersections, without the ID lookups and result bookkeeping of a PathResult
+    std::vector<std::pair<uint32_t, uint32_t>> indices;
+    for (const auto &[from, to] : queries)
+        indices.emplace_back(compact.indexOf(from), compact.indexOf(to));
+    double checksum = 0.0;
+    start = Clock::now();
+    for (const auto &[from, to] : indices)
+    {
+        double distance = labels->distance(from, to);
+        checksum += std::isfinite(distance) ? distance : 0.0;
+    }
+    out << "  distance query = " << std::setprecision(3) << elapsed(start) * perQuery << "us (cost sum = "
+        << std::setprecision(2) << checksum << ")" << std::endl;
+
+    // Full queries: labels with paths, CH and Dijkstra, checked against each other
+    SearchWorkspace workspace;
+    uint32_t mismatches = 0;
+    double times[3] = {};
+    for (const auto &[from, to] : queries)
+    {
+        start = Clock::now();
+        PathResult labelResult = algorithms::hubLabelQuery(graph, from, to, true);
+        times[0] += elapsed(start);
+        start = Clock::now();
+        PathResult hierarchyResult = algorithms::contractionHierarchy(graph, from, to, workspace);
+        times[1] += elapsed(start);
+        start = Clock::now();
+        PathResult dijkstraResult = algorithms::dijkstra(graph, from, to, workspace);
+        times[2] += elapsed(start);
+        if (labelResult.found() != dijkstraResult.found() || hierarchyResult.found() != dijkstraResult.found() ||
+            (dijkstraResult.found() && (std::abs(labelResult.cost - dijkstraResult.cost) > 0.01 ||
+                                        std::abs(hierarchyResult.cost - dijkstraResult.cost) > 0.01)))
+            mismatches++;
+    }
+    out << std::setprecision(3) << "  path query: labels = " << times[0] * perQuery << "us, ch = " << times[1] * perQuery
+        << "us, dijkstra = " << times[2] * perQuery << "us (" << queries.size() << " queries, " << mismatches
+        << " cost mismatches)" << std::endl;
+}
\ No newline at end of file
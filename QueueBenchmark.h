@@ -0,0 +1,39 @@
+#ifndef QUEUEBENCHMARK_H
+#define QUEUEBENCHMARK_H
+
+#include <cstdint>
+#include <ostream>
+#include "CompactGraph.h"
+
+/**
+ * Benchmark of the priority queue implementations (see PriorityQueue.h).
+ *
+ * The same random queries are answered by Dijkstra and A* with every queue, on the
+ * double-precision graph and on its centimeter QuantizedGraph (the radix heap only
+ * supports the latter). Costs are summed per run so that results can be compared.
+ * The hub label report uses the same random queries.
+ */
+namespace benchmark
+{
+    /**
+     * @brief Runs the queue benchmark and prints one line per algorithm, precision and queue.
+     *
+     * @param compact The compact graph to query.
+     * @param queryCount The number of random start/end pairs.
+     * @param out The stream to print to.
+     */
+    void compareQueues(const CompactGraph &compact, uint32_t queryCount, std::ostream &out);
+
+    /**
+     * @brief Builds the contraction hierarchy and hub labels of the graph and prints their
+     * memory footprint and the latency of label distance and path queries, next to CH and
+     * Dijkstra queries on the same random pairs.
+     *
+     * @param compact The compact graph to query.
+     * @param queryCount The number of random start/end pairs.
+     * @param out The stream to print to.
+     */
+    void reportHubLabels(const CompactGraph &compact, uint32_t queryCount, std::ostream &out);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,101 @@
+#ifndef RADIXHEAP_H
+#define RADIXHEAP_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Radix heap (monotone bucket queue) of dense vertex indices for integer keys.
+ *
+ * A key lives in the bucket given by the highest bit in which it differs from the last
+ * extracted key, so push() is O(1) and every entry is redistributed at most once per
+ * bit. It requires monotone keys, as produced by Dijkstra with non-negative integer
+ * weights: pushing a key below the last extracted one throws an exception.
+ * Like LazyBinaryHeap it has no decrease-key and leaves outdated entries behind.
+ * Entries with equal keys are not popped in index order.
+ */
+template <typename Key>
+class RadixHeap
+{
+    static_assert(std::is_unsigned_v<Key>, "RadixHeap needs unsigned integer keys");
+
+public:
+    /* Constructor & destructor */
+    RadixHeap() = default;
+    ~RadixHeap() = default;
+
+    /* Empties the heap; the graph size is not needed without a position index */
+    void clear(uint32_t)
+    {
+        for (auto &bucket : buckets)
+            bucket.clear();
+        last = 0;
+        count = 0;
+    }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    /**
+     * Inserts a vertex, possibly a second time with a smaller key.
+     * Throws an exception if the key is below the last extracted key.
+     *
+     * @param index The dense index of the vertex.
+     * @param key The priority of the vertex.
+     */
+    void push(uint32_t index, Key key)
+    {
+        if (key < last)
+        {
+            throw std::runtime_error("Radix heap keys must not decrease below the last extracted key");
+        }
+        buckets[bucketOf(key)].emplace_back(key, index);
+        count++;
+    }
+
+    /**
+     * Removes an entry with the smallest key.
+     *
+     * @return The dense index of its vertex, which may already be settled.
+     */
+    uint32_t pop()
+    {
+        if (buckets[0].empty())
+        {
+            // Move the first non-empty bucket down around its minimum, which becomes the new last key
+            size_t i = 1;
+            while (buckets[i].empty())
+                i++;
+            Key minimum = buckets[i].front().first;
+            for (const auto &entry : buckets[i])
+                minimum = std::min(minimum, entry.first);
+            last = minimum;
+            for (const auto &entry : buckets[i])
+                buckets[bucketOf(entry.first)].push_back(entry);
+            buckets[i].clear();
+        }
+        uint32_t index = buckets[0].back().second;
+        buckets[0].pop_back();
+        count--;
+        return index;
+    }
+
+private:
+    std::array<std::vector<std::pair<Key, uint32_t>>, sizeof(Key) * 8 + 1> buckets; // {key, vertexIndex}
+    Key last = 0;
+    size_t count = 0;
+
+    size_t bucketOf(Key key) const
+    {
+        return key == last ? 0 : sizeof(Key) * 8 - std::countl_zero(static_cast<Key>(key ^ last));
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "Reordering.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+
+namespace
+{
+    constexpr uint32_t kHilbertSide = 1u << 16; // Grid resolution of the curve per axis
+    constexpr uint32_t kReportSearches = 16;    // Full searches run on each layout by printReport
+
+    // Position of cell (x, y) along the Hilbert curve filling a kHilbertSide x kHilbertSide grid
+    uint64_t hilbertIndex(uint32_t x, uint32_t y)
+    {
+        uint64_t index = 0;
+        for (uint32_t s = kHilbertSide / 2; s > 0; s /= 2)
+        {
+            uint32_t rx = (x & s) > 0;
+            uint32_t ry = (y & s) > 0;
+            index += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+            if (ry == 0)
+            {
+                if (rx == 1)
+                {
+                    x = kHilbertSide - 1 - x;
+                    y = kHilbertSide - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return index;
+    }
+
+    // Graph traversal order; the frontier is a queue for BFS and a stack for DFS
+    std::vector<uint32_t> traversalOrder(const CompactGraph &graph, bool depthFirst)
+    {
+        const uint32_t n = graph.vertexCount();
+        std::vector<uint32_t> order;
+        std::vector<bool> visited(n);
+        std::deque<uint32_t> frontier;
+        order.reserve(n);
+
+        for (uint32_t root = 0; root < n; ++root)
+        {
+            if (visited[root])
+                continue;
+            frontier.push_back(root);
+            if (!depthFirst)
+                visited[root] = true;
+
+            while (!frontier.empty())
+            {
+                uint32_t current;
+                if (depthFirst)
+                {
+                    current = frontier.back();
+                    frontier.pop_back();
+                    if (visited[current])
+                        continue;
+                    visited[current] = true;
+                }
+                else
+                {
+                    current = frontier.front();
+                    frontier.pop_front();
+                }
+                order.push_back(current);
+
+                // Push in reverse for DFS so that neighbors are visited in edge order
+                uint32_t begin = graph.edgeBegin(current), end = graph.edgeEnd(current);
+                for (uint32_t i = 0; i < end - begin; ++i)
+                {
+                    uint32_t neighbor = graph.target(depthFirst ? end - 1 - i : begin + i);
+                    if (visited[neighbor])
+                        continue;
+                    if (!depthFirst)
+                        visited[neighbor] = true;
+                    frontier.push_back(neighbor);
+                }
+            }
+        }
+        return order;
+    }
+
+    // Full single-source Dijkstra; returns the sum of the finite distances as a layout-independent checksum
+    double sweep(const CompactGraph &graph, uint32_t source)
+    {
+        std::vector<double> distance(graph.vertexCount(), std::numeric_limits<double>::infinity());
+        std::priority_queue<std::pair<double, uint32_t>, std::vector<std::pair<double, uint32_t>>, std::greater<>> pq;
+        distance[source] = 0.0;
+        pq.push({0.0, source});
+        double total = 0.0;
+
+        while (!pq.empty())
+        {
+            auto [d, u] = pq.top();
+            pq.pop();
+            if (d > distance[u])
+                continue;
+            total += d;
+            for (uint32_t edge = graph.edgeBegin(u); edge < graph.edgeEnd(u); ++edge)
+            {
+                uint32_t v = graph.target(edge);
+                double updated = d + graph.weight(edge);
+                if (updated < distance[v])
+                {
+                    distance[v] = updated;
+                    pq.push({updated, v});
+                }
+            }
+        }
+        return total;
+    }
+
+    struct LayoutMeasure
+    {
+        double meanEdgeGap;
+        double microseconds;
+        double checksum;
+        PerfCounters::Reading counters;
+    };
+
+    LayoutMeasure measure(const CompactGraph &graph, const std::vector<uint32_t> &sourceIds, PerfCounters &counters)
+    {
+        LayoutMeasure result{0.0, 0.0, 0.0, {}};
+        double gapSum = 0.0;
+        for (uint32_t u = 0; u < graph.vertexCount(); ++u)
+        {
+            for (uint32_t edge = graph.edgeBegin(u); edge < graph.edgeEnd(u); ++edge)
+                gapSum += std::abs(static_cast<double>(graph.target(edge)) - u);
+        }
+        result.meanEdgeGap = graph.edgeCount() > 0 ? gapSum / graph.edgeCount() : 0.0;
+
+        auto start = std::chrono::steady_clock::now();
+        counters.start();
+        for (uint32_t id : sourceIds)
+            result.checksum += sweep(graph, graph.indexOf(id));
+        result.counters = counters.stop();
+        auto end = std::chrono::steady_clock::now();
+        result.microseconds = std::chrono::duration<double, std::micro>(end - start).count();
+        return result;
+    }
+}
+
+std::vector<uint32_t> reordering::hilbertOrder(const CompactGraph &graph)
+{
+    const uint32_t n = graph.vertexCount();
+    if (n == 0)
+        return {};
+
+    double minLon = graph.longitude(0), maxLon = minLon;
+    double minLat = graph.latitude(0), maxLat = minLat;
+    for (uint32_t i = 1; i < n; ++i)
+    {
+        minLon = std::min(minLon, graph.longitude(i));
+        maxLon = std::max(maxLon, graph.longitude(i));
+        minLat = std::min(minLat, graph.latitude(i));
+        maxLat = std::max(maxLat, graph.latitude(i));
+    }
+    double lonScale = maxLon > minLon ? (kHilbertSide - 1) / (maxLon - minLon) : 0.0;
+    double latScale = maxLat > minLat ? (kHilbertSide - 1) / (maxLat - minLat) : 0.0;
+
+    std::vector<uint64_t> keys(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        uint32_t x = static_cast<uint32_t>((graph.longitude(i) - minLon) * lonScale);
+        uint32_t y = static_cast<uint32_t>((graph.latitude(i) - minLat) * latScale);
+        keys[i] = hilbertIndex(x, y);
+    }
+
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b)
+                     { return keys[a] < keys[b]; });
+    return order;
+}
+
+std::vector<uint32_t> reordering::bfsOrder(const CompactGraph &graph)
+{
+    return traversalOrder(graph, false);
+}
+
+std::vector<uint32_t> reordering::dfsOrder(const CompactGraph &graph)
+{
+    return traversalOrder(graph, true);
+}
+
+std::vector<uint32_t> reordering::computeOrder(const CompactGraph &graph, const std::string &strategy)
+{
+    if (strategy == "hilbert")
+        return hilbertOrder(graph);
+    if (strategy == "bfs")
+        return bfsOrder(graph);
+    if (strategy == "dfs")
+        return dfsOrder(graph);
+    throw std::runtime_error("Error: Unknown reordering '" + strategy + "'. Use hilbert, bfs, or dfs.");
+}
+
+void reordering::printReport(const CompactGraph &before, const CompactGraph &after, std::ostream &out)
+{
+    // The same sources, by original ID, on both layouts
+    std::vector<uint32_t> sourceIds;
+    for (uint32_t i = 0; i < kReportSearches && before.vertexCount() > 0; ++i)
+        sourceIds.push_back(before.idOf(static_cast<uint32_t>(static_cast<uint64_t>(i) * before.vertexCount() / kReportSearches)));
+
+    PerfCounters counters;
+    sweep(before, before.indexOf(sourceIds.empty() ? 0 : sourceIds[0])); // Warm up caches and page mappings
+    LayoutMeasure original = measure(before, sourceIds, counters);
+    LayoutMeasure reordered = measure(after, sourceIds, counters);
+
+    auto line = [&](const char *name, const LayoutMeasure &m)
+    {
+        out << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(1)
+            << " mean edge gap = " << std::setw(10) << m.meanEdgeGap
+            << ", " << sourceIds.size() << " full searches = " << std::setw(10) << m.microseconds << "us";
+        if (counters.available())
+        {
+            out << ", cache misses = " << m.counters.cacheMisses << " / " << m.counters.cacheReferences << " references";
+        }
+        out << std::endl;
+    };
+
+    out << "Layout report:" << std::endl;
+    line("original", original);
+    line("reordered", reordered);
+    if (counters.available() && original.counters.cacheMisses > 0)
+    {
+        out << "Cache miss reduction = " << std::setprecision(1)
+            << 100.0 * (1.0 - static_cast<double>(reordered.counters.cacheMisses) / original.counters.cacheMisses) << "%" << std::endl;
+    }
+    else
+    {
+        out << "Hardware cache counters unavailable (perf events not permitted on this system)" << std::endl;
+    }
+    if (std::abs(original.checksum - reordered.checksum) > 1e-6 * std::max(1.0, std::abs(original.checksum)))
+    {
+        out << "WARNING: distances differ between layouts" << std::endl;
+    }
+}
\ No newline at end of file
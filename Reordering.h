@@ -0,0 +1,68 @@
+#ifndef REORDERING_H
+#define REORDERING_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "CompactGraph.h"
+
+/**
+ * Locality-preserving vertex orders for CompactGraph::reordered().
+ *
+ * Input IDs are arbitrary, so road neighbors usually end up far apart in the CSR
+ * arrays. Renumbering vertices so that neighbors get close indices makes the
+ * distance/visited arrays and the adjacency of a search hit the same cache lines.
+ * Every function returns the old dense index of every new dense index.
+ */
+namespace reordering
+{
+    /**
+     * @brief Orders vertices along a Hilbert space-filling curve over longitude/latitude.
+     *
+     * @param graph The compact graph to reorder.
+     * @return The new vertex order.
+     */
+    std::vector<uint32_t> hilbertOrder(const CompactGraph &graph);
+
+    /**
+     * @brief Orders vertices by breadth-first traversal of the outgoing edges,
+     * restarting from the lowest unvisited index for every weakly reached component.
+     *
+     * @param graph The compact graph to reorder.
+     * @return The new vertex order.
+     */
+    std::vector<uint32_t> bfsOrder(const CompactGraph &graph);
+
+    /**
+     * @brief Orders vertices by depth-first (preorder) traversal of the outgoing edges.
+     *
+     * @param graph The compact graph to reorder.
+     * @return The new vertex order.
+     */
+    std::vector<uint32_t> dfsOrder(const CompactGraph &graph);
+
+    /**
+     * @brief Computes the vertex order of a named strategy.
+     * Throws an exception for unknown strategies.
+     *
+     * @param graph The compact graph to reorder.
+     * @param strategy One of "hilbert", "bfs" or "dfs".
+     * @return The new vertex order.
+     */
+    std::vector<uint32_t> computeOrder(const CompactGraph &graph, const std::string &strategy);
+
+    /**
+     * @brief Compares the memory locality of two layouts of the same graph.
+     * Prints the mean index distance between edge endpoints and the time of a fixed set
+     * of full single-source searches on each layout, together with the cache misses
+     * measured by the hardware counters when they are available.
+     *
+     * @param before The original layout.
+     * @param after The reordered layout.
+     * @param out The stream to print the report to.
+     */
+    void printReport(const CompactGraph &before, const CompactGraph &after, std::ostream &out);
+}
+
+#endif
\ No newline at end of file
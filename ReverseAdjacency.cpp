@@ -0,0 +1,35 @@
+#include "ReverseAdjacency.h"
+
+ReverseAdjacency::ReverseAdjacency(const CompactGraph &graph)
+{
+    const uint32_t n = graph.vertexCount();
+
+    // Counting sort of the edges by target
+    offsets.assign(n + 1, 0);
+    for (uint32_t edge = 0; edge < graph.edgeCount(); ++edge)
+    {
+        offsets[graph.target(edge) + 1]++;
+    }
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        offsets[v + 1] += offsets[v];
+    }
+
+    sources.resize(graph.edgeCount());
+    forwardEdges.resize(graph.edgeCount());
+    std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+    for (uint32_t u = 0; u < n; ++u)
+    {
+        for (uint32_t edge = graph.edgeBegin(u); edge < graph.edgeEnd(u); ++edge)
+        {
+            uint32_t slot = next[graph.target(edge)]++;
+            sources[slot] = u;
+            forwardEdges[slot] = edge;
+        }
+    }
+}
+
+size_t ReverseAdjacency::memoryUsage() const
+{
+    return (offsets.size() + sources.size() + forwardEdges.size()) * sizeof(uint32_t);
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef REVERSEADJACENCY_H
+#define REVERSEADJACENCY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CompactGraph.h"
+
+/**
+ * Incoming edges of every vertex of a CompactGraph, for backward searches.
+ *
+ * The reverse CSR arrays only hold the topology: every reverse edge points back to
+ * the forward edge it mirrors, and weights are read from the forward graph. Weight
+ * updates therefore apply to both directions at once and the reverse adjacency only
+ * has to be rebuilt when the topology or the vertex order changes.
+ */
+class ReverseAdjacency
+{
+public:
+    /* Constructor & destructor */
+    ReverseAdjacency() = default;
+    ~ReverseAdjacency() = default;
+
+    /**
+     * Builds the incoming edge lists of a compact graph. The incoming edges of a vertex
+     * keep the order of their sources.
+     *
+     * @param graph The compact graph to reverse.
+     */
+    explicit ReverseAdjacency(const CompactGraph &graph);
+
+    /* Incoming edge range of a vertex: [edgeBegin(v), edgeEnd(v)) */
+    uint32_t edgeBegin(uint32_t index) const { return offsets[index]; }
+    uint32_t edgeEnd(uint32_t index) const { return offsets[index + 1]; }
+
+    /* Start vertex of a reverse edge and the forward edge it mirrors */
+    uint32_t source(uint32_t reverseEdge) const { return sources[reverseEdge]; }
+    uint32_t forwardEdge(uint32_t reverseEdge) const { return forwardEdges[reverseEdge]; }
+
+    /**
+     * Visits the incoming edges of a vertex.
+     *
+     * @param forward The forward graph providing the weights, e.g. a CompactGraph or QuantizedGraph.
+     * @param index The dense index of the vertex.
+     * @param visit Callable invoked as visit(sourceIndex, weight) for every incoming edge.
+     */
+    template <typename Forward, typename Visitor>
+    void forEachEdge(const Forward &forward, uint32_t index, Visitor &&visit) const
+    {
+        for (uint32_t edge = offsets[index]; edge < offsets[index + 1]; ++edge)
+            visit(sources[edge], forward.weight(forwardEdges[edge]));
+    }
+
+    /**
+     * Gets the number of bytes held by the reverse arrays.
+     *
+     * @return The memory footprint in bytes.
+     */
+    size_t memoryUsage() const;
+
+private:
+    std::vector<uint32_t> offsets;      // vertexCount + 1 entries into sources/forwardEdges
+    std::vector<uint32_t> sources;      // Dense index of the start vertex of every incoming edge
+    std::vector<uint32_t> forwardEdges; // Index of the mirrored edge in the forward graph
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,145 @@
+#ifndef SEARCHKERNEL_H
+#define SEARCHKERNEL_H
+
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include "CompactGraph.h"
+#include "SearchWorkspace.h"
+
+/**
+ * Search loop shared by BFS, Dijkstra and A* (and the searches built on them, ALT and arc flags).
+ * What tells them apart are compile-time policies, inlined into one loop per combination with
+ * no virtual call or runtime switch left in the relaxation loop:
+ * - the adjacency, whose forEachEdge() yields the edges and whose Traits select the weight type;
+ * - the queue, a priority queue of PriorityQueue.h, or FifoQueue for breadth-first order;
+ * - the heuristic, a potential added to the key of every vertex, or NoHeuristic; a heuristic
+ *   with a prepare(index) member is told before the edges of a vertex are relaxed, so that it
+ *   can evaluate all the neighbors at once;
+ * - the stopping condition, checked when a vertex is popped and once it is settled;
+ * - the hooks, called when a vertex is settled and when a label improves (NoHooks does nothing),
+ *   so counters and instrumented variants need no copy of the loop.
+ */
+namespace search
+{
+    /* Heuristic of Dijkstra and BFS: the key of a vertex is its distance */
+    struct NoHeuristic
+    {
+    };
+
+    /* Stops when the target is popped, before settling it (Dijkstra: the target is not visited) */
+    struct StopWhenPopped
+    {
+        uint32_t target;
+        bool onPop(uint32_t index) const { return index == target; }
+        bool onSettle(uint32_t) const { return false; }
+    };
+
+    /* Stops once the target is settled (A*, BFS: the target is visited) */
+    struct StopWhenSettled
+    {
+        uint32_t target;
+        bool onPop(uint32_t) const { return false; }
+        bool onSettle(uint32_t index) const { return index == target; }
+    };
+
+    /* Hooks that do nothing; derive from it to override some of them */
+    struct NoHooks
+    {
+        template <typename Distance>
+        void onSettle(uint32_t, Distance) {}
+
+        template <typename Distance>
+        void onRelax(uint32_t, uint32_t, Distance) {}
+    };
+
+    /* True for queues that pop vertices in the order they were reached (FifoQueue) */
+    template <typename Queue>
+    constexpr bool kFirstReachFinal = requires { requires Queue::kFirstReachFinal; };
+
+    /**
+     * Runs the search from a vertex until the stopping condition holds or the queue runs out.
+     * The workspace must have been started for the query (SearchWorkspace::begin()); the queue
+     * is cleared here. Distances and predecessors are left in the workspace.
+     * Throws an exception on a negative edge weight.
+     *
+     * @param adjacency The edges to relax, with the weight traits of the search.
+     * @param workspace The per-vertex state of the query.
+     * @param queue The queue of the search.
+     * @param vertexCount The number of vertices of the graph.
+     * @param startIndex The dense index of the start vertex.
+     * @param heuristic Callable giving the potential of a vertex in distance units, or NoHeuristic.
+     * @param stop The stopping condition.
+     * @param hooks The hooks called from the loop.
+     * @return True if the stopping condition ended the search.
+     */
+    template <typename Adjacency, typename Queue, typename Heuristic, typename Stop, typename Hooks>
+    bool run(const Adjacency &adjacency, SearchWorkspace &workspace, Queue &queue, uint32_t vertexCount, uint32_t startIndex,
+             Heuristic &heuristic, const Stop &stop, Hooks &hooks)
+    {
+        using Traits = typename Adjacency::Traits;
+        using Distance = typename Traits::Distance;
+
+        auto key = [&](uint32_t index, Distance distance) -> Distance
+        {
+            if constexpr (std::is_same_v<Heuristic, NoHeuristic>)
+                return distance;
+            else
+                return distance + heuristic(index);
+        };
+
+        queue.clear(vertexCount);
+        workspace.reach(startIndex, Distance{}, CompactGraph::kInvalidIndex); // No previous vertex for the start vertex
+        queue.push(startIndex, key(startIndex, Distance{}));
+
+        while (!queue.empty())
+        {
+            uint32_t currentIndex = queue.pop();
+            if (stop.onPop(currentIndex))
+                return true;
+            if (workspace.settled(currentIndex))
+                continue; // Outdated entry of a queue without decrease-key
+            workspace.settle(currentIndex);
+
+            Distance currentDistance = workspace.distance<Traits>(currentIndex);
+            hooks.onSettle(currentIndex, currentDistance);
+            if (stop.onSettle(currentIndex))
+                return true;
+            if constexpr (requires { heuristic.prepare(currentIndex); })
+                heuristic.prepare(currentIndex);
+
+            adjacency.forEachEdge(currentIndex, [&](uint32_t neighbor, typename Traits::Weight weight)
+                                  {
+                if constexpr (kFirstReachFinal<Queue>)
+                {
+                    // Breadth-first: a vertex is queued once, when it is first reached
+                    if (workspace.reached(neighbor))
+                        return;
+                    Distance updatedDistance = Traits::add(currentDistance, weight);
+                    workspace.reach(neighbor, updatedDistance, currentIndex);
+                    hooks.onRelax(currentIndex, neighbor, updatedDistance);
+                    queue.push(neighbor, updatedDistance);
+                }
+                else
+                {
+                    if constexpr (std::is_signed_v<typename Traits::Weight>)
+                    {
+                        if (weight < 0)
+                            throw std::runtime_error("Negative edge weight detected"); // Stops if it finds negative weights
+                    }
+                    Distance updatedDistance = Traits::add(currentDistance, weight);
+                    if (updatedDistance < workspace.distance<Traits>(neighbor))
+                    {
+                        workspace.reach(neighbor, updatedDistance, currentIndex);
+                        hooks.onRelax(currentIndex, neighbor, updatedDistance);
+                        // Only queued if not settled yet; lowers the key if already queued
+                        if (!workspace.settled(neighbor))
+                            queue.push(neighbor, key(neighbor, updatedDistance));
+                    }
+                } });
+        }
+        return false;
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,194 @@
+#ifndef SEARCHWORKSPACE_H
+#define SEARCHWORKSPACE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "DaryHeap.h"
+#include "LazyBinaryHeap.h"
+#include "PriorityQueue.h"
+#include "RadixHeap.h"
+
+/**
+ * Per-vertex state of a search (distance, predecessor, settled flag), kept in flat
+ * arrays indexed by dense vertex index and reused across queries, together with the
+ * priority queues of the searches so that their buffers are reused too.
+ *
+ * Instead of clearing the arrays, every query starts a new generation: an entry only
+ * counts as set if its stamp equals the current generation. Starting a query is O(1)
+ * except when the graph size changes or the generation counter wraps around.
+ * A workspace must not be shared by concurrent queries.
+ */
+class SearchWorkspace
+{
+public:
+    /* Constructor & destructor */
+    SearchWorkspace() = default;
+    ~SearchWorkspace() = default;
+
+    /**
+     * Starts a new query on a graph of the given size: every vertex becomes unreached
+     * and unsettled.
+     *
+     * @tparam Traits The weight traits of the query, selecting its distance type.
+     * @param vertexCount The number of vertices of the graph.
+     */
+    template <typename Traits>
+    void begin(uint32_t vertexCount)
+    {
+        if (reachedStamp.size() != vertexCount)
+        {
+            reachedStamp.assign(vertexCount, 0);
+            settledStamp.assign(vertexCount, 0);
+            potentialStamp.assign(vertexCount, 0);
+            previousIndex.resize(vertexCount);
+            potentials.resize(vertexCount);
+            generation = 0;
+        }
+        distances<typename Traits::Distance>().resize(vertexCount);
+        if (++generation == 0)
+        {
+            // Wrapped around: stamps of old queries could look current again
+            std::fill(reachedStamp.begin(), reachedStamp.end(), 0);
+            std::fill(settledStamp.begin(), settledStamp.end(), 0);
+            std::fill(potentialStamp.begin(), potentialStamp.end(), 0);
+            generation = 1;
+        }
+    }
+
+    /* True if the vertex got a tentative distance during the current query */
+    bool reached(uint32_t index) const { return reachedStamp[index] == generation; }
+
+    /* Settled (visited) flag of the current query */
+    bool settled(uint32_t index) const { return settledStamp[index] == generation; }
+    void settle(uint32_t index) { settledStamp[index] = generation; }
+
+    /**
+     * Gets the tentative distance of a vertex.
+     *
+     * @param index The dense index of the vertex.
+     * @return The distance, or Traits::kInfinity if the vertex was not reached.
+     */
+    template <typename Traits>
+    typename Traits::Distance distance(uint32_t index) const
+    {
+        return reached(index) ? distances<typename Traits::Distance>()[index] : Traits::kInfinity;
+    }
+
+    /**
+     * Records a (better) tentative distance and the predecessor it comes from.
+     *
+     * @param index The dense index of the vertex.
+     * @param distance The new distance.
+     * @param previous The dense index of the predecessor, kInvalidIndex for the start vertex.
+     */
+    template <typename Distance>
+    void reach(uint32_t index, Distance distance, uint32_t previous)
+    {
+        reachedStamp[index] = generation;
+        distances<Distance>()[index] = distance;
+        previousIndex[index] = previous;
+    }
+
+    /**
+     * Gets the potential (heuristic value) of a vertex, computed at most once per query.
+     *
+     * @param index The dense index of the vertex.
+     * @param compute Callable returning the potential of the vertex in meters, called on a cache miss.
+     * @return The potential in meters.
+     */
+    template <typename Compute>
+    double potential(uint32_t index, Compute &&compute)
+    {
+        if (potentialStamp[index] != generation)
+        {
+            potentials[index] = compute(index);
+            potentialStamp[index] = generation;
+        }
+        return potentials[index];
+    }
+
+    /* True if the potential of the vertex was computed during the current query */
+    bool hasPotential(uint32_t index) const { return potentialStamp[index] == generation; }
+
+    /* Stores a potential computed outside potential(), e.g. for a batch of vertices */
+    void setPotential(uint32_t index, double value)
+    {
+        potentials[index] = value;
+        potentialStamp[index] = generation;
+    }
+
+    /* Predecessor of a reached vertex */
+    uint32_t previous(uint32_t index) const { return previousIndex[index]; }
+
+    /**
+     * Gets the priority queue of the given type owned by the workspace.
+     * The search is responsible for clearing it.
+     *
+     * @tparam Queue SetQueue, DaryHeap, LazyBinaryHeap or RadixHeap over double or uint64_t keys, or FifoQueue.
+     * @return The queue.
+     */
+    template <typename Queue>
+    Queue &queue() { return std::get<Queue>(queues); }
+
+    /**
+     * Gets the workspace of the backward half of a bidirectional search, created on first use.
+     *
+     * @return The backward workspace.
+     */
+    SearchWorkspace &backward()
+    {
+        if (!backwardWorkspace)
+            backwardWorkspace = std::make_unique<SearchWorkspace>();
+        return *backwardWorkspace;
+    }
+
+    /**
+     * Gets the number of bytes held by the workspace arrays (queues excluded).
+     *
+     * @return The memory footprint in bytes.
+     */
+    size_t memoryUsage() const
+    {
+        return (reachedStamp.size() + settledStamp.size() + potentialStamp.size() + previousIndex.size()) * sizeof(uint32_t) +
+               (doubleDistances.size() + potentials.size()) * sizeof(double) + integerDistances.size() * sizeof(uint64_t);
+    }
+
+private:
+    uint32_t generation = 0;
+    std::vector<uint32_t> reachedStamp;  // Generation in which the distance was last set
+    std::vector<uint32_t> settledStamp;  // Generation in which the vertex was settled
+    std::vector<uint32_t> potentialStamp; // Generation in which the potential was computed
+    std::vector<uint32_t> previousIndex; // Predecessor on the best known path
+    std::vector<double> potentials;      // Cached heuristic values, in meters
+    std::vector<double> doubleDistances; // Distances of DoubleWeights queries
+    std::vector<uint64_t> integerDistances; // Distances of fixed-point queries
+    std::tuple<SetQueue<double>, SetQueue<uint64_t>, DaryHeap<double>, DaryHeap<uint64_t>,
+               LazyBinaryHeap<double>, LazyBinaryHeap<uint64_t>, RadixHeap<uint64_t>, FifoQueue>
+        queues;
+    std::unique_ptr<SearchWorkspace> backwardWorkspace;
+
+    template <typename Distance>
+    std::vector<Distance> &distances()
+    {
+        if constexpr (std::is_same_v<Distance, double>)
+            return doubleDistances;
+        else
+            return integerDistances;
+    }
+
+    template <typename Distance>
+    const std::vector<Distance> &distances() const
+    {
+        if constexpr (std::is_same_v<Distance, double>)
+            return doubleDistances;
+        else
+            return integerDistances;
+    }
+};
+
+#endif
\ No newline at end of file
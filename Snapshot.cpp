@@ -0,0 +1,426 @@
+#include "Snapshot.h"
+#include "MappedFile.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+    constexpr char kMagic[8] = {'M', 'P', 'F', 'S', 'N', 'A', 'P', '\0'};
+    constexpr uint32_t kByteOrderMark = 0x01020304;
+    constexpr uint64_t kAlignment = 64;
+
+    enum class SectionTag : uint32_t
+    {
+        Ids = 1,
+        IdOrder = 2,
+        Offsets = 3,
+        Targets = 4,
+        Weights = 5,
+        Longitudes = 6,
+        Latitudes = 7,
+        WeightVersion = 8,
+        LandmarkIndices = 9, // Optional landmark sections
+        LandmarkFrom = 10,
+        LandmarkTo = 11,
+        LabelForwardOffsets = 12, // Optional hub label sections
+        LabelForwardHubs = 13,
+        LabelForwardDistances = 14,
+        LabelBackwardOffsets = 15,
+        LabelBackwardHubs = 16,
+        LabelBackwardDistances = 17,
+        ArcFlagCellCount = 18, // Optional arc flag sections
+        ArcFlagCells = 19,
+        ArcFlagBits = 20,
+    };
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;      // kByteOrderMark as written by the producer
+        uint64_t fileSize;       // Total size of the snapshot file
+        uint64_t sourceSize;     // Size of the text graph file the snapshot was built from
+        int64_t sourceTime;      // Modification time of that file
+        uint32_t sectionCount;
+        uint32_t reserved;
+        uint64_t tableChecksum;  // Checksum of the section table
+        uint64_t headerChecksum; // Checksum of all the header fields above
+    };
+
+    struct SectionEntry
+    {
+        uint32_t tag;
+        uint32_t elementSize;
+        uint64_t offset; // From the start of the file, aligned to kAlignment
+        uint64_t count;  // Number of elements
+        uint64_t checksum;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header> && sizeof(Header) == 64);
+    static_assert(std::is_trivially_copyable_v<SectionEntry> && sizeof(SectionEntry) == 32);
+
+    // Section about to be written: tag plus the bytes it covers
+    struct PendingSection
+    {
+        SectionTag tag;
+        uint32_t elementSize;
+        const void *data;
+        uint64_t count;
+    };
+
+    template <typename T>
+    PendingSection pending(SectionTag tag, std::span<const T> values)
+    {
+        return {tag, sizeof(T), values.data(), values.size()};
+    }
+
+    uint64_t alignUp(uint64_t value)
+    {
+        return (value + kAlignment - 1) / kAlignment * kAlignment;
+    }
+
+    // Size and modification time of a source file, used to detect stale snapshots
+    std::pair<uint64_t, int64_t> sourceStamp(const std::string &sourceFilename)
+    {
+        std::error_code error;
+        uint64_t size = std::filesystem::file_size(sourceFilename, error);
+        if (error)
+            return {0, 0};
+        auto time = std::filesystem::last_write_time(sourceFilename, error);
+        if (error)
+            return {size, 0};
+        return {size, static_cast<int64_t>(time.time_since_epoch().count())};
+    }
+
+    uint64_t headerChecksum(const Header &header)
+    {
+        return snapshot::checksum(&header, offsetof(Header, headerChecksum));
+    }
+
+    bool hasSection(const std::vector<SectionEntry> &table, SectionTag tag)
+    {
+        for (const SectionEntry &entry : table)
+        {
+            if (entry.tag == static_cast<uint32_t>(tag))
+                return true;
+        }
+        return false;
+    }
+
+    template <typename T>
+    std::span<const T> sectionView(const MappedFile &file, const std::vector<SectionEntry> &table,
+                                   SectionTag tag, const std::string &filename)
+    {
+        for (const SectionEntry &entry : table)
+        {
+            if (entry.tag != static_cast<uint32_t>(tag))
+                continue;
+
+            if (entry.elementSize != sizeof(T) || entry.offset % kAlignment != 0 ||
+                entry.offset > file.size() || entry.count > (file.size() - entry.offset) / sizeof(T))
+            {
+                throw std::runtime_error("Error: snapshot " + filename + " has a malformed section table.");
+            }
+
+            const char *begin = file.data() + entry.offset;
+            if (snapshot::checksum(begin, entry.count * sizeof(T)) != entry.checksum)
+            {
+                throw std::runtime_error("Error: snapshot " + filename + " is corrupt (checksum mismatch in section " +
+                                         std::to_string(entry.tag) + ").");
+            }
+            return {reinterpret_cast<const T *>(begin), static_cast<size_t>(entry.count)};
+        }
+        throw std::runtime_error("Error: snapshot " + filename + " is missing section " +
+                                 std::to_string(static_cast<uint32_t>(tag)) + ".");
+    }
+}
+
+uint64_t snapshot::checksum(const void *data, size_t size)
+{
+    // Word-at-a-time multiply/rotate hash; fast enough to verify large sections at memory speed
+    constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+    auto rotate = [](uint64_t value, int bits)
+    { return (value << bits) | (value >> (64 - bits)); };
+
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    uint64_t hash = kPrime2 ^ (size * kPrime1);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash ^= rotate(word * kPrime2, 31) * kPrime1;
+        hash = rotate(hash, 27) * kPrime1 + kPrime2;
+    }
+    for (; i < size; ++i)
+    {
+        hash ^= bytes[i] * kPrime1;
+        hash = rotate(hash, 11) * kPrime2;
+    }
+
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    return hash;
+}
+
+void snapshot::save(const CompactGraph &graph, const std::string &filename, const std::string &sourceFilename,
+                    const Landmarks *landmarks, const HubLabels *hubLabels, const ArcFlags *arcFlags)
+{
+    const CompactGraph::Arrays &arrays = graph.arrays();
+    const uint64_t version = graph.version();
+    std::vector<PendingSection> sections = {
+        pending(SectionTag::Ids, arrays.ids),
+        pending(SectionTag::IdOrder, arrays.idOrder),
+        pending(SectionTag::Offsets, arrays.offsets),
+        pending(SectionTag::Targets, arrays.targets),
+        pending(SectionTag::Weights, arrays.weights),
+        pending(SectionTag::Longitudes, arrays.longitudes),
+        pending(SectionTag::Latitudes, arrays.latitudes),
+        pending(SectionTag::WeightVersion, std::span<const uint64_t>(&version, 1)),
+    };
+    if (landmarks && landmarks->count() > 0)
+    {
+        if (landmarks->version() != version || landmarks->vertexCount() != graph.vertexCount())
+        {
+            throw std::runtime_error("Error: the landmarks were computed on another version of the graph.");
+        }
+        const Landmarks::Arrays &tables = landmarks->arrays();
+        sections.push_back(pending(SectionTag::LandmarkIndices, tables.indices));
+        sections.push_back(pending(SectionTag::LandmarkFrom, tables.fromLandmark));
+        sections.push_back(pending(SectionTag::LandmarkTo, tables.toLandmark));
+    }
+    if (hubLabels)
+    {
+        if (hubLabels->version() != version || hubLabels->vertexCount() != graph.vertexCount())
+        {
+            throw std::runtime_error("Error: the hub labels were computed on another version of the graph.");
+        }
+        const HubLabels::Arrays &labels = hubLabels->arrays();
+        sections.push_back(pending(SectionTag::LabelForwardOffsets, labels.forwardOffsets));
+        sections.push_back(pending(SectionTag::LabelForwardHubs, labels.forwardHubs));
+        sections.push_back(pending(SectionTag::LabelForwardDistances, labels.forwardDistances));
+        sections.push_back(pending(SectionTag::LabelBackwardOffsets, labels.backwardOffsets));
+        sections.push_back(pending(SectionTag::LabelBackwardHubs, labels.backwardHubs));
+        sections.push_back(pending(SectionTag::LabelBackwardDistances, labels.backwardDistances));
+    }
+    const uint32_t cellCount = arcFlags ? arcFlags->cellCount() : 0; // Referenced by its section until written
+    if (arcFlags)
+    {
+        if (arcFlags->version() != version || arcFlags->vertexCount() != graph.vertexCount() ||
+            arcFlags->edgeCount() != graph.edgeCount())
+        {
+            throw std::runtime_error("Error: the arc flags were computed on another version of the graph.");
+        }
+        const ArcFlags::Arrays &flags = arcFlags->arrays();
+        sections.push_back(pending(SectionTag::ArcFlagCellCount, std::span<const uint32_t>(&cellCount, 1)));
+        sections.push_back(pending(SectionTag::ArcFlagCells, flags.cells));
+        sections.push_back(pending(SectionTag::ArcFlagBits, flags.flags));
+    }
+
+    // Lay out the sections after the header and the table
+    std::vector<SectionEntry> table;
+    uint64_t offset = alignUp(sizeof(Header) + sections.size() * sizeof(SectionEntry));
+    for (const PendingSection &section : sections)
+    {
+        uint64_t bytes = section.count * section.elementSize;
+        table.push_back({static_cast<uint32_t>(section.tag), section.elementSize, offset, section.count,
+                         checksum(section.data, bytes)});
+        offset = alignUp(offset + bytes);
+    }
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrderMark;
+    header.fileSize = offset;
+    auto [sourceSize, sourceTime] = sourceStamp(sourceFilename);
+    header.sourceSize = sourceSize;
+    header.sourceTime = sourceTime;
+    header.sectionCount = static_cast<uint32_t>(table.size());
+    header.tableChecksum = checksum(table.data(), table.size() * sizeof(SectionEntry));
+    header.headerChecksum = headerChecksum(header);
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Error: could not open file " + filename + " for writing");
+    }
+
+    static const char kPadding[kAlignment] = {};
+    uint64_t written = 0;
+    auto writeBytes = [&](const void *data, uint64_t size)
+    {
+        file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+        written += size;
+    };
+
+    writeBytes(&header, sizeof(header));
+    writeBytes(table.data(), table.size() * sizeof(SectionEntry));
+    for (size_t i = 0; i < sections.size(); ++i)
+    {
+        writeBytes(kPadding, table[i].offset - written);
+        writeBytes(sections[i].data, sections[i].count * sections[i].elementSize);
+    }
+    writeBytes(kPadding, header.fileSize - written);
+
+    if (!file)
+    {
+        throw std::runtime_error("Error: could not write snapshot " + filename);
+    }
+}
+
+CompactGraph snapshot::load(const std::string &filename, const std::string &sourceFilename)
+{
+    return loadContents(filename, sourceFilename).graph;
+}
+
+snapshot::Contents snapshot::loadContents(const std::string &filename, const std::string &sourceFilename)
+{
+    auto file = std::make_shared<MappedFile>(filename);
+
+    Header header;
+    if (file->size() < sizeof(Header))
+    {
+        throw std::runtime_error("Error: " + filename + " is not a graph snapshot (file too small).");
+    }
+    std::memcpy(&header, file->data(), sizeof(Header));
+
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+    {
+        throw std::runtime_error("Error: " + filename + " is not a graph snapshot.");
+    }
+    if (header.byteOrder != kByteOrderMark)
+    {
+        throw std::runtime_error("Error: snapshot " + filename + " was written on a machine with a different byte order.");
+    }
+    if (header.version != kVersion)
+    {
+        throw std::runtime_error("Error: snapshot " + filename + " has version " + std::to_string(header.version) +
+                                 ", expected " + std::to_string(kVersion) + ". Please regenerate it.");
+    }
+    if (header.headerChecksum != headerChecksum(header) || header.fileSize != file->size())
+    {
+        throw std::runtime_error("Error: snapshot " + filename + " is corrupt or truncated.");
+    }
+
+    if (!sourceFilename.empty())
+    {
+        auto [sourceSize, sourceTime] = sourceStamp(sourceFilename);
+        if (sourceSize != header.sourceSize || sourceTime != header.sourceTime)
+        {
+            throw std::runtime_error("Error: snapshot " + filename + " is stale, " + sourceFilename +
+                                     " changed since it was written. Please regenerate it.");
+        }
+    }
+
+    uint64_t tableBytes = static_cast<uint64_t>(header.sectionCount) * sizeof(SectionEntry);
+    if (tableBytes > file->size() - sizeof(Header))
+    {
+        throw std::runtime_error("Error: snapshot " + filename + " has a malformed section table.");
+    }
+    std::vector<SectionEntry> table(header.sectionCount);
+    std::memcpy(table.data(), file->data() + sizeof(Header), tableBytes);
+    if (checksum(table.data(), tableBytes) != header.tableChecksum)
+    {
+        throw std::runtime_error("Error: snapshot " + filename + " is corrupt (checksum mismatch in section table).");
+    }
+
+    CompactGraph::Arrays arrays;
+    arrays.ids = sectionView<uint32_t>(*file, table, SectionTag::Ids, filename);
+    arrays.idOrder = sectionView<uint32_t>(*file, table, SectionTag::IdOrder, filename);
+    arrays.offsets = sectionView<uint32_t>(*file, table, SectionTag::Offsets, filename);
+    arrays.targets = sectionView<uint32_t>(*file, table, SectionTag::Targets, filename);
+    arrays.weights = sectionView<double>(*file, table, SectionTag::Weights, filename);
+    arrays.longitudes = sectionView<double>(*file, table, SectionTag::Longitudes, filename);
+    arrays.latitudes = sectionView<double>(*file, table, SectionTag::Latitudes, filename);
+    std::span<const uint64_t> version = sectionView<uint64_t>(*file, table, SectionTag::WeightVersion, filename);
+
+    size_t vertexCount = arrays.ids.size();
+    if (arrays.idOrder.size() != vertexCount || arrays.offsets.size() != vertexCount + 1 ||
+        arrays.longitudes.size() != vertexCount || arrays.latitudes.size() != vertexCount ||
+        arrays.weights.size() != arrays.targets.size() || arrays.offsets.back() != arrays.targets.size() ||
+        version.size() != 1)
+    {
+        throw std::runtime_error("Error: snapshot " + filename + " has inconsistent array sizes.");
+    }
+
+    Contents contents;
+    if (hasSection(table, SectionTag::LandmarkIndices))
+    {
+        Landmarks::Arrays tables;
+        tables.indices = sectionView<uint32_t>(*file, table, SectionTag::LandmarkIndices, filename);
+        tables.fromLandmark = sectionView<double>(*file, table, SectionTag::LandmarkFrom, filename);
+        tables.toLandmark = sectionView<double>(*file, table, SectionTag::LandmarkTo, filename);
+
+        size_t entryCount = vertexCount * tables.indices.size();
+        if (tables.fromLandmark.size() != entryCount || tables.toLandmark.size() != entryCount)
+        {
+            throw std::runtime_error("Error: snapshot " + filename + " has inconsistent landmark tables.");
+        }
+        for (uint32_t index : tables.indices)
+        {
+            if (index >= vertexCount)
+                throw std::runtime_error("Error: snapshot " + filename + " has inconsistent landmark tables.");
+        }
+        contents.landmarks = std::make_shared<const Landmarks>(file, tables, version[0]);
+    }
+
+    if (hasSection(table, SectionTag::LabelForwardOffsets))
+    {
+        HubLabels::Arrays labels;
+        labels.forwardOffsets = sectionView<uint64_t>(*file, table, SectionTag::LabelForwardOffsets, filename);
+        labels.forwardHubs = sectionView<uint32_t>(*file, table, SectionTag::LabelForwardHubs, filename);
+        labels.forwardDistances = sectionView<uint32_t>(*file, table, SectionTag::LabelForwardDistances, filename);
+        labels.backwardOffsets = sectionView<uint64_t>(*file, table, SectionTag::LabelBackwardOffsets, filename);
+        labels.backwardHubs = sectionView<uint32_t>(*file, table, SectionTag::LabelBackwardHubs, filename);
+        labels.backwardDistances = sectionView<uint32_t>(*file, table, SectionTag::LabelBackwardDistances, filename);
+
+        // Offsets must be non-decreasing and end at the entry count, so that no query reads out of bounds
+        auto consistent = [&](std::span<const uint64_t> offsets, std::span<const uint32_t> hubs, std::span<const uint32_t> distances)
+        {
+            if (offsets.size() != vertexCount + 1 || hubs.size() != distances.size() || offsets.front() != 0 ||
+                offsets.back() != hubs.size())
+                return false;
+            for (size_t i = 1; i < offsets.size(); ++i)
+            {
+                if (offsets[i] < offsets[i - 1])
+                    return false;
+            }
+            return true;
+        };
+        if (!consistent(labels.forwardOffsets, labels.forwardHubs, labels.forwardDistances) ||
+            !consistent(labels.backwardOffsets, labels.backwardHubs, labels.backwardDistances))
+        {
+            throw std::runtime_error("Error: snapshot " + filename + " has inconsistent hub labels.");
+        }
+        contents.hubLabels = std::make_shared<const HubLabels>(file, labels, version[0]);
+    }
+
+    if (hasSection(table, SectionTag::ArcFlagCellCount))
+    {
+        std::span<const uint32_t> cellCount = sectionView<uint32_t>(*file, table, SectionTag::ArcFlagCellCount, filename);
+        ArcFlags::Arrays flags;
+        flags.cells = sectionView<uint32_t>(*file, table, SectionTag::ArcFlagCells, filename);
+        flags.flags = sectionView<uint64_t>(*file, table, SectionTag::ArcFlagBits, filename);
+
+        // Out-of-range cells would make queries read flags past the end of an edge
+        bool consistent = cellCount.size() == 1 && cellCount[0] > 0 && flags.cells.size() == vertexCount &&
+                          flags.flags.size() == arrays.targets.size() * ((static_cast<size_t>(cellCount[0]) + 63) / 64);
+        for (size_t i = 0; consistent && i < flags.cells.size(); ++i)
+            consistent = flags.cells[i] < cellCount[0];
+        if (!consistent)
+        {
+            throw std::runtime_error("Error: snapshot " + filename + " has inconsistent arc flags.");
+        }
+        contents.arcFlags = std::make_shared<const ArcFlags>(file, flags, cellCount[0], version[0]);
+    }
+
+    contents.graph = CompactGraph(std::move(file), arrays, version[0]);
+    return contents;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "CompactGraph.h"
+#include "Landmarks.h"
+#include "HubLabels.h"
+#include "ArcFlags.h"
+
+/**
+ * Versioned binary snapshot of a CompactGraph.
+ *
+ * Layout: a fixed header, a table of sections and the raw CSR arrays, each one
+ * aligned to 64 bytes. Loading maps the file and points the CompactGraph spans
+ * straight into the mapping, so startup costs page faults instead of parsing.
+ * The header records the size and modification time of the text file the
+ * snapshot was built from, and every section carries a checksum. The weight
+ * version of the graph is stored too, so that weight updates applied before saving
+ * are not mistaken for the original weights. Landmark tables for ALT queries, hub
+ * labels and arc flags are stored in optional sections, so snapshots without them keep loading.
+ */
+namespace snapshot
+{
+    /* Format version, bumped whenever the layout changes */
+    constexpr uint32_t kVersion = 2;
+
+    /**
+     * @brief Writes the compact graph to a binary snapshot file.
+     *
+     * @param graph The compact graph to serialize.
+     * @param filename The name of the snapshot file to write.
+     * @param sourceFilename The text graph file the graph was loaded from, recorded for staleness checks.
+     * @param landmarks The landmarks computed on the graph to store along with it, if any.
+     * @param hubLabels The hub labels computed on the graph to store along with it, if any (without path data).
+     * @param arcFlags The arc flags computed on the graph to store along with it, if any.
+     */
+    void save(const CompactGraph &graph, const std::string &filename, const std::string &sourceFilename,
+              const Landmarks *landmarks = nullptr, const HubLabels *hubLabels = nullptr, const ArcFlags *arcFlags = nullptr);
+
+    /* Everything a snapshot holds */
+    struct Contents
+    {
+        CompactGraph graph;
+        std::shared_ptr<const Landmarks> landmarks; // nullptr if the snapshot has no landmark tables
+        std::shared_ptr<const HubLabels> hubLabels; // nullptr if the snapshot has no hub labels
+        std::shared_ptr<const ArcFlags> arcFlags;   // nullptr if the snapshot has no arc flags
+    };
+
+    /**
+     * @brief Maps a binary snapshot file and wraps the graph, landmark tables, hub labels and arc flags it holds.
+     * Throws the same exceptions as load().
+     *
+     * @param filename The name of the snapshot file to load.
+     * @param sourceFilename The text graph file to check the snapshot against; empty to skip the check.
+     * @return The graph, landmarks, labels and arc flags, all backed by the mapped file.
+     */
+    Contents loadContents(const std::string &filename, const std::string &sourceFilename = "");
+
+    /**
+     * @brief Maps a binary snapshot file and wraps its arrays without copying them.
+     * Throws an exception if the file is not a snapshot, has another version, is corrupt
+     * or, when a source file is given, was built from a different version of that file.
+     *
+     * @param filename The name of the snapshot file to load.
+     * @param sourceFilename The text graph file to check the snapshot against; empty to skip the check.
+     * @return A CompactGraph backed by the mapped file.
+     */
+    CompactGraph load(const std::string &filename, const std::string &sourceFilename = "");
+
+    /**
+     * @brief Computes the 64-bit checksum used for snapshot sections.
+     *
+     * @param data Pointer to the bytes to hash.
+     * @param size The number of bytes.
+     * @return The checksum.
+     */
+    uint64_t checksum(const void *data, size_t size);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "SphereCoordinates.h"
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+SphereCoordinates::SphereCoordinates(const CompactGraph &graph)
+{
+    constexpr double kDegreesToRadians = 3.14159265358979323846 / 180.0;
+    const uint32_t n = graph.vertexCount();
+    xs.resize(n);
+    ys.resize(n);
+    zs.resize(n);
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        double latitude = graph.latitude(v) * kDegreesToRadians;
+        double longitude = graph.longitude(v) * kDegreesToRadians;
+        xs[v] = std::cos(latitude) * std::cos(longitude);
+        ys[v] = std::cos(latitude) * std::sin(longitude);
+        zs[v] = std::sin(latitude);
+    }
+}
+
+void SphereCoordinates::lowerBounds(std::span<const uint32_t> indices, uint32_t to, std::span<double> bounds) const
+{
+    const size_t count = indices.size();
+    size_t i = 0;
+    // The vector kernels multiply and add separately, like lowerBound(), so every lane gives the scalar result
+#if defined(__AVX2__)
+    const __m256d toX = _mm256_set1_pd(xs[to]), toY = _mm256_set1_pd(ys[to]), toZ = _mm256_set1_pd(zs[to]);
+    const __m256d radius = _mm256_set1_pd(kEarthRadius);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i lanes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(indices.data() + i));
+        __m256d dx = _mm256_sub_pd(_mm256_i32gather_pd(xs.data(), lanes, 8), toX);
+        __m256d dy = _mm256_sub_pd(_mm256_i32gather_pd(ys.data(), lanes, 8), toY);
+        __m256d dz = _mm256_sub_pd(_mm256_i32gather_pd(zs.data(), lanes, 8), toZ);
+        __m256d squared = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz));
+        _mm256_storeu_pd(bounds.data() + i, _mm256_mul_pd(radius, _mm256_sqrt_pd(squared)));
+    }
+#elif defined(__SSE2__)
+    const __m128d toX = _mm_set1_pd(xs[to]), toY = _mm_set1_pd(ys[to]), toZ = _mm_set1_pd(zs[to]);
+    const __m128d radius = _mm_set1_pd(kEarthRadius);
+    for (; i + 2 <= count; i += 2)
+    {
+        uint32_t a = indices[i], b = indices[i + 1];
+        __m128d dx = _mm_sub_pd(_mm_set_pd(xs[b], xs[a]), toX);
+        __m128d dy = _mm_sub_pd(_mm_set_pd(ys[b], ys[a]), toY);
+        __m128d dz = _mm_sub_pd(_mm_set_pd(zs[b], zs[a]), toZ);
+        __m128d squared = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)), _mm_mul_pd(dz, dz));
+        _mm_storeu_pd(bounds.data() + i, _mm_mul_pd(radius, _mm_sqrt_pd(squared)));
+    }
+#endif
+    for (; i < count; ++i)
+        bounds[i] = lowerBound(indices[i], to);
+}
+
+double SphereCoordinates::admissibleScale(const CompactGraph &graph) const
+{
+    double scale = 1.0;
+    for (uint32_t v = 0; v < graph.vertexCount(); ++v)
+    {
+        graph.forEachEdge(v, [&](uint32_t target, double weight)
+                          {
+            double chord = lowerBound(v, target);
+            if (weight < scale * chord)
+                scale = weight / chord; });
+    }
+    return scale;
+}
+
+const char *SphereCoordinates::kernelName()
+{
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+size_t SphereCoordinates::memoryUsage() const
+{
+    return (xs.size() + ys.size() + zs.size()) * sizeof(double);
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#ifndef SPHERECOORDINATES_H
+#define SPHERECOORDINATES_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "CompactGraph.h"
+
+/**
+ * Vertex positions of a CompactGraph as unit vectors on the Earth sphere, in
+ * struct-of-arrays form, for the heuristics of A* and bidirectional A*.
+ *
+ * The straight-line (chord) distance between two points of the sphere never exceeds
+ * their great-circle distance and is a metric, so R * chord is a consistent lower bound
+ * on graphs whose edges are at least as long as the chord of their ends. Weight updates
+ * can break that, so the searches scale the bounds by admissibleScale() of the weights.
+ * The sines and cosines of the coordinates are computed once per graph: a bound costs
+ * three differences and a square root, and lowerBounds() evaluates several vertices at
+ * a time with the AVX2 or SSE2 kernel the build targets, or a scalar loop.
+ */
+class SphereCoordinates
+{
+public:
+    /* Constructor & destructor */
+    SphereCoordinates() = default;
+    ~SphereCoordinates() = default;
+
+    /**
+     * Computes the unit vectors of the vertices of a compact graph.
+     *
+     * @param graph The compact graph.
+     */
+    explicit SphereCoordinates(const CompactGraph &graph);
+
+    /**
+     * Gets the lower bound of the distance between two vertices.
+     *
+     * @param from The dense index of the first vertex.
+     * @param to The dense index of the second vertex.
+     * @return The chord distance in meters.
+     */
+    double lowerBound(uint32_t from, uint32_t to) const
+    {
+        double dx = xs[from] - xs[to];
+        double dy = ys[from] - ys[to];
+        double dz = zs[from] - zs[to];
+        return kEarthRadius * std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    /**
+     * Computes the lower bounds of the distances from several vertices to one vertex,
+     * equal to the ones of lowerBound().
+     *
+     * @param indices The dense indices of the vertices.
+     * @param to The dense index of the vertex they are bounded to.
+     * @param bounds Output array of the same length, receiving the bounds in meters.
+     */
+    void lowerBounds(std::span<const uint32_t> indices, uint32_t to, std::span<double> bounds) const;
+
+    /**
+     * Gets the largest factor, at most 1, by which the bounds can be multiplied and stay a
+     * consistent lower bound on the weights of a graph with these vertices: the smallest
+     * ratio of an edge weight to the chord of its ends. It is 0 when an edge between two
+     * distinct points has a zero weight, which turns the heuristics off.
+     *
+     * @param graph The compact graph the coordinates were computed from, with its current weights.
+     * @return The scale factor, between 0 and 1.
+     */
+    double admissibleScale(const CompactGraph &graph) const;
+
+    /**
+     * Gets the kernel lowerBounds() was compiled with.
+     *
+     * @return "avx2", "sse2" or "scalar".
+     */
+    static const char *kernelName();
+
+    /**
+     * Gets the number of bytes held by the coordinate arrays.
+     *
+     * @return The memory footprint in bytes.
+     */
+    size_t memoryUsage() const;
+
+private:
+    static constexpr double kEarthRadius = 6371000.0; // Meters, as utils::computeHaversineDistance()
+
+    std::vector<double> xs; // cos(latitude) * cos(longitude)
+    std::vector<double> ys; // cos(latitude) * sin(longitude)
+    std::vector<double> zs; // sin(latitude)
+};
+
+#endif
\ No newline at end of file
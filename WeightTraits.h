@@ -0,0 +1,82 @@
+#ifndef WEIGHTTRAITS_H
+#define WEIGHTTRAITS_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+/**
+ * Compile-time selection of how edge weights and path distances are represented.
+ *
+ * Every adjacency the searches run on exposes its traits as a nested Traits type:
+ * the search kernels take their distance type, infinity and arithmetic from it, so
+ * the double and fixed-point modes share one implementation.
+ */
+
+/* Weights and distances as double-precision meters (the reference mode) */
+struct DoubleWeights
+{
+    using Weight = double;
+    using Distance = double;
+
+    static constexpr Distance kInfinity = std::numeric_limits<double>::infinity();
+
+    /* Distance reached by following an edge of the given weight; infinite weights stay infinite */
+    static Distance add(Distance distance, Weight weight) { return distance + weight; }
+
+    /* Converts a distance in meters that must not be overestimated, e.g. a heuristic */
+    static Distance lowerBound(double meters) { return meters; }
+
+    /* Converts a distance back to meters for output */
+    static double toMeters(Distance distance) { return distance; }
+};
+
+/**
+ * Weights as uint32_t multiples of 1/Scale meter and distances as uint64_t, so that
+ * sums of road lengths never overflow. A weight of kClosed is an infinite (closed) edge.
+ */
+template <uint32_t Scale>
+struct FixedPointWeights
+{
+    using Weight = uint32_t;
+    using Distance = uint64_t;
+
+    static constexpr double kScale = Scale;
+    static constexpr Weight kClosed = std::numeric_limits<uint32_t>::max();
+    static constexpr Distance kInfinity = std::numeric_limits<uint64_t>::max();
+
+    /**
+     * Rounds a weight in meters to the nearest step.
+     * Throws an exception if the weight is negative or too large to be represented.
+     *
+     * @param meters The weight in meters; infinity closes the edge.
+     * @return The quantized weight.
+     */
+    static Weight quantize(double meters)
+    {
+        if (meters == std::numeric_limits<double>::infinity())
+            return kClosed;
+        if (meters >= 0 && meters * kScale < kClosed - 1)
+            return static_cast<Weight>(std::lround(meters * kScale));
+        throw std::runtime_error("Edge weight " + std::to_string(meters) + " cannot be quantized");
+    }
+
+    static Distance add(Distance distance, Weight weight)
+    {
+        return weight == kClosed || distance == kInfinity ? kInfinity : distance + weight;
+    }
+
+    static Distance lowerBound(double meters) { return static_cast<Distance>(std::floor(meters * kScale)); }
+
+    static double toMeters(Distance distance)
+    {
+        return distance == kInfinity ? std::numeric_limits<double>::infinity() : distance / kScale;
+    }
+};
+
+using CentimeterWeights = FixedPointWeights<100>;
+using DecimeterWeights = FixedPointWeights<10>;
+
+#endif
\ No newline at end of file
@@ -1,347 +1,1084 @@
 #include "algorithms.h"
-#include "utils.h"
 #include "GraphicGraph.h"
+#include "SearchKernel.h"
 #include <iomanip>
 #include <algorithm>
-#include <queue>
-#include <set>
 #include <limits>
 #include <chrono>
+#include <type_traits>
 
-void algorithms::bfs(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId)
+// The searches are templates over the adjacency they relax edges from: the plain CSR
+// arrays of the CompactGraph, a CompressedAdjacency or a QuantizedGraph, all exposing
+// forEachEdge(). The nested Traits of the adjacency select double or integer distances.
+// Per-vertex state lives in a reusable SearchWorkspace and results are returned as a
+// PathResult; nothing is printed from inside the searches. BFS, Dijkstra and A* are
+// instantiations of one search loop with compile-time policies (see SearchKernel.h);
+// they and the bidirectional searches are also templates over their priority queue
+// (see PriorityQueue.h).
+
+using Clock = std::chrono::steady_clock;
+
+// Unknown vertices (kInvalidIndex) have no neighbors either, as with the adjacency list lookup
+static bool hasNoNeighbors(const CompactGraph &compact, uint32_t index)
+{
+    return index == CompactGraph::kInvalidIndex || compact.degree(index) == 0;
+}
+
+// Checks the endpoints of a query; returns false with the result status set if the search cannot run
+static bool checkEndpoints(const CompactGraph &compact, uint32_t startIndex, uint32_t endIndex, PathResult &result)
+{
+    if (result.startVertexId == result.endVertexId)
+        result.status = PathResult::Status::SameVertex;
+    else if (hasNoNeighbors(compact, startIndex) || hasNoNeighbors(compact, endIndex))
+        result.status = PathResult::Status::NoNeighbors;
+    else if (startIndex == CompactGraph::kInvalidIndex || endIndex == CompactGraph::kInvalidIndex)
+        result.status = PathResult::Status::NotFound;
+    else
+        return true;
+    return false;
+}
+
+// Starts a new query in the workspace and records how long it took
+template <typename Traits>
+static void beginSearch(const CompactGraph &compact, SearchWorkspace &workspace, PathResult &result)
 {
-    if (startVertexId == endVertexId)
+    auto start = Clock::now();
+    workspace.begin<Traits>(compact.vertexCount());
+    result.setupTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+}
+
+// Reconstructs the path from the start vertex to endIndex by following the predecessors
+template <typename Traits>
+static void buildPath(const CompactGraph &compact, const SearchWorkspace &workspace, uint32_t endIndex, PathResult &result)
+{
+    std::vector<uint32_t> indices;
+    for (uint32_t u = endIndex; u != CompactGraph::kInvalidIndex; u = workspace.previous(u))
     {
-        std::cout << "Start and end vertices are the same." << std::endl;
-        return;
+        indices.push_back(u);
     }
-    else if (graph.getNeighbors(startVertexId).empty() || graph.getNeighbors(endVertexId).empty())
+    std::reverse(indices.begin(), indices.end());
+
+    result.path.reserve(indices.size());
+    result.lengths.reserve(indices.size());
+    for (uint32_t index : indices)
     {
-        std::cout << "Start or end vertex has no neighbors in the graph." << std::endl;
-        return;
+        result.path.push_back(compact.idOf(index));
+        result.lengths.push_back(Traits::toMeters(workspace.distance<Traits>(index)));
     }
-    else if (graph.getVertices().find(startVertexId) == graph.getVertices().end() || graph.getVertices().find(endVertexId) == graph.getVertices().end())
+    result.cost = result.lengths.back();
+    result.status = PathResult::Status::Found;
+}
+
+// Calls run with the adjacency selected for the view: quantized graph, compressed adjacency or compact graph
+template <typename Run>
+static void runOnAdjacency(const Graph::SearchView &view, Run &&run)
+{
+    if (view.quantized.index() != 0)
+        std::visit([&](const auto &quantized)
+                   {
+            if constexpr (!std::is_same_v<std::decay_t<decltype(quantized)>, std::monostate>)
+                run(*quantized); },
+                   view.quantized);
+    else if (view.compressed)
+        run(*view.compressed);
+    else
+        run(view.compact);
+}
+
+// Calls run with the workspace queue of the given type for the distance type of a search
+template <typename Distance, typename Run>
+static void runWithQueue(QueueType type, SearchWorkspace &workspace, Run &&run)
+{
+    switch (type)
     {
-        std::cout << "Start or end vertex not found in the graph." << std::endl;
-        return;
+    case QueueType::Set:
+        run(workspace.queue<SetQueue<Distance>>());
+        break;
+    case QueueType::DaryHeap:
+        run(workspace.queue<DaryHeap<Distance>>());
+        break;
+    case QueueType::BinaryHeap:
+        run(workspace.queue<LazyBinaryHeap<Distance>>());
+        break;
+    case QueueType::Radix:
+        if constexpr (std::is_unsigned_v<Distance>)
+            run(workspace.queue<RadixHeap<Distance>>());
+        else
+            throw std::runtime_error("Error: the radix queue needs integer weights (use --quantized).");
+        break;
     }
+}
+
+// Counts the settled vertices of a search in its result
+struct CountVisited : search::NoHooks
+{
+    PathResult &result;
+
+    template <typename Distance>
+    void onSettle(uint32_t, Distance) { result.visitedCount++; }
+};
+
+// BFS, Dijkstra and A*: checks the endpoints, runs the search kernel with the queue, the heuristic
+// returned by makeHeuristic(startIndex, endIndex) and the stopping condition Stop, and builds the path
+template <typename Stop, typename Adjacency, typename Queue, typename MakeHeuristic>
+static void pointToPointSearch(const CompactGraph &compact, const Adjacency &adjacency, SearchWorkspace &workspace, Queue &queue,
+                               PathResult &result, MakeHeuristic &&makeHeuristic)
+{
+    using Traits = typename Adjacency::Traits;
+
+    uint32_t startIndex = compact.indexOf(result.startVertexId);
+    uint32_t endIndex = compact.indexOf(result.endVertexId);
+    if (!checkEndpoints(compact, startIndex, endIndex, result))
+        return;
+
+    beginSearch<Traits>(compact, workspace, result);
+    auto start = Clock::now();
+    auto heuristic = makeHeuristic(startIndex, endIndex);
+    CountVisited hooks{{}, result};
+    if (search::run(adjacency, workspace, queue, compact.vertexCount(), startIndex, heuristic, Stop{endIndex}, hooks))
+        buildPath<Traits>(compact, workspace, endIndex, result);
     else
+        result.status = PathResult::Status::NoPath;
+    result.searchTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+}
+
+// Heuristic maker of the searches without one
+static search::NoHeuristic noHeuristic(uint32_t, uint32_t)
+{
+    return {};
+}
+
+// Compact graph restricted to the edges flagged for one target cell, so that Dijkstra prunes the others
+class FlaggedAdjacency
+{
+public:
+    using Traits = DoubleWeights;
+
+    FlaggedAdjacency(const CompactGraph &compact, const ArcFlags &flags, uint32_t cell) : compact(compact), flags(flags), cell(cell) {}
+
+    template <typename Visitor>
+    void forEachEdge(uint32_t index, Visitor &&visit) const
     {
-        auto start = std::chrono::steady_clock::now();
+        for (uint32_t edge = compact.edgeBegin(index); edge < compact.edgeEnd(index); ++edge)
+        {
+            if (flags.isSet(edge, cell))
+                visit(compact.target(edge), compact.weight(edge));
+        }
+    }
+
+private:
+    const CompactGraph &compact;
+    const ArcFlags &flags;
+    uint32_t cell;
+};
 
-        std::queue<uint32_t> queue;                    // Queue of vertex IDs to visit
-        std::unordered_set<uint32_t> visited;          // Set of visited vertex IDs
-        std::unordered_map<uint32_t, uint32_t> parent; // To reconstruct the path
-        std::unordered_map<uint32_t, double> distance; // To track cumulative distances
+// Great-circle heuristic of A* in the distance units of Traits, memoized in the workspace for the
+// query and scaled so that it stays admissible after weight updates (a zero scale turns A* into
+// Dijkstra). Before the edges of a vertex are relaxed, the bounds of all its neighbors seen for the first
+// time are computed at once with the batch kernel of the sphere coordinates.
+template <typename Traits>
+class GreatCircleHeuristic
+{
+public:
+    GreatCircleHeuristic(const CompactGraph &compact, const SphereCoordinates &sphere, double scale, SearchWorkspace &workspace,
+                         uint32_t goalIndex)
+        : compact(compact), sphere(sphere), scale(scale), workspace(workspace), goalIndex(goalIndex) {}
 
-        queue.push(startVertexId);
-        visited.insert(startVertexId);
+    typename Traits::Distance operator()(uint32_t index)
+    {
+        if (scale == 0.0)
+            return typename Traits::Distance{};
+        return Traits::lowerBound(workspace.potential(index, [&](uint32_t v)
+                                                      { return scale * sphere.lowerBound(v, goalIndex); }));
+    }
 
-        // Initialize parent and distance for the start vertex
-        // std::numeric_limits<uint32_t>::max() is used since the vertices ID are uint32_t
-        parent[startVertexId] = std::numeric_limits<uint32_t>::max(); // No parent for start vertex
-        distance[startVertexId] = 0.0;
+    void prepare(uint32_t index)
+    {
+        if (scale == 0.0)
+            return;
+        pending.clear();
+        for (uint32_t edge = compact.edgeBegin(index); edge < compact.edgeEnd(index); ++edge)
+        {
+            if (!workspace.hasPotential(compact.target(edge)))
+                pending.push_back(compact.target(edge));
+        }
+        if (pending.size() < 2)
+            return; // Left to operator()
+        bounds.resize(pending.size());
+        sphere.lowerBounds(pending, goalIndex, bounds);
+        for (size_t i = 0; i < pending.size(); ++i)
+            workspace.setPotential(pending[i], scale * bounds[i]);
+    }
 
-        int visitedCount = 0;
+private:
+    const CompactGraph &compact;
+    const SphereCoordinates &sphere;
+    double scale;
+    SearchWorkspace &workspace;
+    uint32_t goalIndex;
+    std::vector<uint32_t> pending; // Neighbors without a bound yet
+    std::vector<double> bounds;
+};
 
-        while (!queue.empty())
+// Smallest weight of the edges from u to v (parallel edges may differ), as relaxed by the searches
+template <typename Forward>
+static typename Forward::Traits::Weight edgeWeight(const Forward &forward, uint32_t u, uint32_t v)
+{
+    bool found = false;
+    typename Forward::Traits::Weight best{};
+    forward.forEachEdge(u, [&](uint32_t target, typename Forward::Traits::Weight weight)
+                        {
+        if (target == v && (!found || weight < best))
         {
-            uint32_t current = queue.front();
-            queue.pop();
-            visitedCount++;
+            best = weight;
+            found = true;
+        } });
+    return best;
+}
+
+// Joins the forward predecessors up to the meeting vertex with the backward ones leading to the end
+template <typename Forward>
+static void buildBidirectionalPath(const CompactGraph &compact, const Forward &forward, const SearchWorkspace &workspace,
+                                   const SearchWorkspace &backward, uint32_t meeting, PathResult &result)
+{
+    using Traits = typename Forward::Traits;
+
+    std::vector<uint32_t> indices;
+    for (uint32_t u = meeting; u != CompactGraph::kInvalidIndex; u = workspace.previous(u))
+        indices.push_back(u);
+    std::reverse(indices.begin(), indices.end());
+    for (uint32_t u = backward.previous(meeting); u != CompactGraph::kInvalidIndex; u = backward.previous(u))
+        indices.push_back(u);
+
+    // Cumulative lengths are summed along the path, like the unidirectional searches do
+    typename Traits::Distance length{};
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        if (i > 0)
+            length = Traits::add(length, edgeWeight(forward, indices[i - 1], indices[i]));
+        result.path.push_back(compact.idOf(indices[i]));
+        result.lengths.push_back(Traits::toMeters(length));
+    }
+    result.cost = result.lengths.back();
+    result.status = PathResult::Status::Found;
+}
+
+// Forward search from the start on the graph and backward search from the end on the reverse
+// adjacency, each with its own workspace and queue. The side with the smaller radius (distance
+// of its last settled vertex) advances, and the search stops once the two radii add up to at
+// least the best start-to-end distance seen through a vertex reached by both sides.
+template <typename Forward, typename Queue>
+static void bidirectionalDijkstraSearch(const CompactGraph &compact, const Forward &forward, const ReverseAdjacency &reverse,
+                                        SearchWorkspace &workspace, Queue &forwardQueue, Queue &backwardQueue, PathResult &result)
+{
+    using Traits = typename Forward::Traits;
+    using Distance = typename Traits::Distance;
+
+    uint32_t startIndex = compact.indexOf(result.startVertexId);
+    uint32_t endIndex = compact.indexOf(result.endVertexId);
+    if (!checkEndpoints(compact, startIndex, endIndex, result))
+        return;
+
+    SearchWorkspace &backward = workspace.backward();
+    beginSearch<Traits>(compact, workspace, result);
+    auto setupTime = result.setupTime;
+    beginSearch<Traits>(compact, backward, result);
+    result.setupTime += setupTime;
+    auto start = Clock::now();
+
+    forwardQueue.clear(compact.vertexCount());
+    backwardQueue.clear(compact.vertexCount());
+    workspace.reach(startIndex, Distance{}, CompactGraph::kInvalidIndex);
+    backward.reach(endIndex, Distance{}, CompactGraph::kInvalidIndex);
+    forwardQueue.push(startIndex, Distance{});
+    backwardQueue.push(endIndex, Distance{});
+
+    Distance best = Traits::kInfinity;            // Shortest start-to-end distance found so far
+    uint32_t meeting = CompactGraph::kInvalidIndex; // Vertex on that path reached by both sides
+    Distance forwardRadius{}, backwardRadius{};
+
+    while (!forwardQueue.empty() || !backwardQueue.empty())
+    {
+        bool isForward = backwardQueue.empty() || (!forwardQueue.empty() && forwardRadius <= backwardRadius);
+        SearchWorkspace &side = isForward ? workspace : backward;
+        SearchWorkspace &other = isForward ? backward : workspace;
+        Queue &queue = isForward ? forwardQueue : backwardQueue;
+
+        uint32_t currentIndex = queue.pop();
+        if (side.settled(currentIndex))
+            continue; // Outdated entry
+        Distance currentDistance = side.distance<Traits>(currentIndex);
+        (isForward ? forwardRadius : backwardRadius) = currentDistance;
+        if (forwardRadius + backwardRadius >= best)
+            break; // No path through an unsettled vertex can be shorter
+        side.settle(currentIndex);
+        result.visitedCount++;
 
-            if (current == endVertexId)
+        auto relax = [&](uint32_t neighbor, typename Traits::Weight weight)
+        {
+            Distance updatedDistance = Traits::add(currentDistance, weight);
+            if (updatedDistance == Traits::kInfinity)
+                return;
+            if (updatedDistance < side.distance<Traits>(neighbor))
             {
-                // Reconstruct the path from end to start using the parent map
-                std::vector<uint32_t> path;
-                uint32_t step = endVertexId;
-                while (step != std::numeric_limits<uint32_t>::max())
+                side.reach(neighbor, updatedDistance, currentIndex);
+                if (!side.settled(neighbor))
+                    queue.push(neighbor, updatedDistance);
+            }
+            if (other.reached(neighbor))
+            {
+                Distance through = updatedDistance + other.distance<Traits>(neighbor);
+                if (through < best)
                 {
-                    path.push_back(step);
-                    step = parent[step];
+                    best = through;
+                    meeting = neighbor;
                 }
-                std::reverse(path.begin(), path.end());
+            }
+        };
+        if (isForward)
+            forward.forEachEdge(currentIndex, relax);
+        else
+            reverse.forEachEdge(forward, currentIndex, relax);
+    }
 
-                // Output formatting
-                std::cout << "Total visited vertices = " << visitedCount << std::endl;
-                std::cout << "Total vertices on path from start to end = " << path.size() << std::endl;
-                for (size_t i = 0; i < path.size(); ++i)
-                {
-                    std::cout << "Vertex[" << std::setw(4) << (i + 1) << "] : id = " << std::setw(8) << path[i]
-                              << ", length = " << std::fixed << std::setprecision(2) << distance[path[i]] << std::endl;
-                }
+    if (best == Traits::kInfinity)
+        result.status = PathResult::Status::NoPath;
+    else
+        buildBidirectionalPath(compact, forward, workspace, backward, meeting, result);
+    result.searchTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+}
 
-                auto end = std::chrono::steady_clock::now();
-                auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-                std::string timeStr = std::to_string(duration);
-                if (timeStr.length() > 3)
-                {
-                    timeStr.insert(timeStr.length() - 3, ",");
-                }
-                std::cout << "INFO: path calculated in " << timeStr << "us" << std::endl;
-                graph.drawPath(path);
+// Bidirectional A* with the average potential pf(v) = (h(v, end) - h(v, start)) / 2 for the forward
+// search and pb = -pf for the backward one, where h is the scaled chord bound of SphereCoordinates. Both
+// searches then see the same reduced edge lengths l(u, v) - pf(u) + pf(v), which are non-negative
+// as h is consistent, so the bidirectional Dijkstra stopping criterion stays exact on the reduced
+// graph. Keys are in meters (potentials are fractional) and every potential is computed once per query.
+template <typename Forward, typename Queue>
+static void bidirectionalAStarSearch(const CompactGraph &compact, const Forward &forward, const ReverseAdjacency &reverse,
+                                     const SphereCoordinates &sphere, double scale,
+                                     SearchWorkspace &workspace, Queue &forwardQueue, Queue &backwardQueue, PathResult &result)
+{
+    using Traits = typename Forward::Traits;
+    using Distance = typename Traits::Distance;
+
+    uint32_t startIndex = compact.indexOf(result.startVertexId);
+    uint32_t goalIndex = compact.indexOf(result.endVertexId);
+    if (!checkEndpoints(compact, startIndex, goalIndex, result))
+        return;
+
+    SearchWorkspace &backward = workspace.backward();
+    beginSearch<Traits>(compact, workspace, result);
+    auto setupTime = result.setupTime;
+    beginSearch<Traits>(compact, backward, result);
+    result.setupTime += setupTime;
+    auto start = Clock::now();
+
+    auto potential = [&](uint32_t index)
+    {
+        return workspace.potential(index, [&](uint32_t v)
+                                   { return scale * (sphere.lowerBound(v, goalIndex) - sphere.lowerBound(v, startIndex)) / 2; });
+    };
+    const double startPotential = potential(startIndex);
+    const double goalPotential = potential(goalIndex);
+
+    forwardQueue.clear(compact.vertexCount());
+    backwardQueue.clear(compact.vertexCount());
+    workspace.reach(startIndex, Distance{}, CompactGraph::kInvalidIndex);
+    backward.reach(goalIndex, Distance{}, CompactGraph::kInvalidIndex);
+    forwardQueue.push(startIndex, startPotential);
+    backwardQueue.push(goalIndex, -goalPotential);
+
+    Distance best = Traits::kInfinity;
+    uint32_t meeting = CompactGraph::kInvalidIndex;
+    double forwardRadius = 0.0, backwardRadius = 0.0; // Reduced distances of the last settled vertices
+
+    while (!forwardQueue.empty() || !backwardQueue.empty())
+    {
+        bool isForward = backwardQueue.empty() || (!forwardQueue.empty() && forwardRadius <= backwardRadius);
+        SearchWorkspace &side = isForward ? workspace : backward;
+        SearchWorkspace &other = isForward ? backward : workspace;
+        Queue &queue = isForward ? forwardQueue : backwardQueue;
+        const double sign = isForward ? 1.0 : -1.0; // pb = -pf
+
+        uint32_t currentIndex = queue.pop();
+        if (side.settled(currentIndex))
+            continue; // Outdated entry
+        Distance currentDistance = side.distance<Traits>(currentIndex);
+        double reduced = Traits::toMeters(currentDistance) + sign * potential(currentIndex);
+        (isForward ? forwardRadius : backwardRadius) = isForward ? reduced - startPotential : reduced + goalPotential;
+
+        // Reduced length of the best path is best - pf(start) + pf(end)
+        if (best != Traits::kInfinity && forwardRadius + backwardRadius >= Traits::toMeters(best) - startPotential + goalPotential)
+            break;
+        side.settle(currentIndex);
+        result.visitedCount++;
+
+        auto relax = [&](uint32_t neighbor, typename Traits::Weight weight)
+        {
+            Distance updatedDistance = Traits::add(currentDistance, weight);
+            if (updatedDistance == Traits::kInfinity)
                 return;
+            if (updatedDistance < side.distance<Traits>(neighbor))
+            {
+                side.reach(neighbor, updatedDistance, currentIndex);
+                if (!side.settled(neighbor))
+                    queue.push(neighbor, Traits::toMeters(updatedDistance) + sign * potential(neighbor));
             }
-
-            const std::vector<Edge> &neighbors = graph.getNeighbors(current);
-            for (const Edge &edge : neighbors)
+            if (other.reached(neighbor))
             {
-                uint32_t neighbor = edge.getEndId();
-                double weight = edge.getWeight();
-
-                if (visited.find(neighbor) == visited.end())
+                Distance through = updatedDistance + other.distance<Traits>(neighbor);
+                if (through < best)
                 {
-                    queue.push(neighbor);
-                    visited.insert(neighbor);
-                    parent[neighbor] = current;
-                    distance[neighbor] = distance[current] + weight;
+                    best = through;
+                    meeting = neighbor;
                 }
             }
-        }
-        std::cout << "Total visited vertices = " << visitedCount << std::endl;
-        std::cout << "No path found from vertex " << startVertexId << " to vertex " << endVertexId << ".\n"
-                  << std::endl;
-        return;
+        };
+        if (isForward)
+            forward.forEachEdge(currentIndex, relax);
+        else
+            reverse.forEachEdge(forward, currentIndex, relax);
     }
+
+    if (best == Traits::kInfinity)
+        result.status = PathResult::Status::NoPath;
+    else
+        buildBidirectionalPath(compact, forward, workspace, backward, meeting, result);
+    result.searchTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
 }
 
-void algorithms::dijkstra(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId)
+// Contraction Hierarchy query: a forward search on the upward graph and a backward search on the
+// downward graph, both only climbing to higher ranks. The shortest path goes up and then down, so
+// its highest vertex is settled by both sides; a side stops once its queue cannot beat the best
+// meeting distance. The search graph path is then unpacked to original edges.
+template <typename Queue>
+static void contractionHierarchySearch(const CompactGraph &compact, const ContractionHierarchy &hierarchy,
+                                       SearchWorkspace &workspace, Queue &forwardQueue, Queue &backwardQueue, PathResult &result)
 {
-    if (startVertexId == endVertexId)
-    {
-        std::cout << "Start and end vertices are the same." << std::endl;
+    using Traits = DoubleWeights;
+
+    uint32_t startIndex = compact.indexOf(result.startVertexId);
+    uint32_t endIndex = compact.indexOf(result.endVertexId);
+    if (!checkEndpoints(compact, startIndex, endIndex, result))
         return;
-    }
-    else if (graph.getNeighbors(startVertexId).empty() || graph.getNeighbors(endVertexId).empty())
+
+    SearchWorkspace &backward = workspace.backward();
+    beginSearch<Traits>(compact, workspace, result);
+    auto setupTime = result.setupTime;
+    beginSearch<Traits>(compact, backward, result);
+    result.setupTime += setupTime;
+    auto start = Clock::now();
+
+    forwardQueue.clear(compact.vertexCount());
+    backwardQueue.clear(compact.vertexCount());
+    workspace.reach(startIndex, 0.0, CompactGraph::kInvalidIndex);
+    backward.reach(endIndex, 0.0, CompactGraph::kInvalidIndex);
+    forwardQueue.push(startIndex, 0.0);
+    backwardQueue.push(endIndex, 0.0);
+
+    double best = Traits::kInfinity;
+    uint32_t meeting = CompactGraph::kInvalidIndex;
+    bool isForward = false;
+    while (!forwardQueue.empty() || !backwardQueue.empty())
     {
-        std::cout << "Start or end vertex has no neighbors in the graph." << std::endl;
-        return;
+        // Alternate between the sides that can still improve the best distance
+        isForward = backwardQueue.empty() || (!forwardQueue.empty() && !isForward);
+        SearchWorkspace &side = isForward ? workspace : backward;
+        SearchWorkspace &other = isForward ? backward : workspace;
+        Queue &queue = isForward ? forwardQueue : backwardQueue;
+
+        uint32_t currentIndex = queue.pop();
+        if (side.settled(currentIndex))
+            continue; // Outdated entry
+        double currentDistance = side.distance<Traits>(currentIndex);
+        if (currentDistance >= best)
+        {
+            queue.clear(compact.vertexCount()); // Nothing left on this side can improve the path
+            continue;
+        }
+        side.settle(currentIndex);
+        result.visitedCount++;
+        if (other.reached(currentIndex) && currentDistance + other.distance<Traits>(currentIndex) < best)
+        {
+            best = currentDistance + other.distance<Traits>(currentIndex);
+            meeting = currentIndex;
+        }
+
+        (isForward ? hierarchy.upward() : hierarchy.downward()).forEachEdge(currentIndex, [&](uint32_t neighbor, double weight)
+                                                                           {
+            double updatedDistance = currentDistance + weight;
+            if (updatedDistance < side.distance<Traits>(neighbor))
+            {
+                side.reach(neighbor, updatedDistance, currentIndex);
+                queue.push(neighbor, updatedDistance);
+            } });
     }
-    else if (graph.getVertices().find(startVertexId) == graph.getVertices().end() || graph.getVertices().find(endVertexId) == graph.getVertices().end())
+
+    if (meeting == CompactGraph::kInvalidIndex)
     {
-        std::cout << "Start or end vertex not found in the graph." << std::endl;
+        result.status = PathResult::Status::NoPath;
+        result.searchTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
         return;
     }
-    else
-    {
-        auto start = std::chrono::steady_clock::now();
 
-        int visitedCount = 0;
-        std::unordered_set<uint32_t> visited;            // Set of visited vertex IDs
-        std::unordered_map<uint32_t, uint32_t> previous; // To reconstruct the path
-        std::unordered_map<uint32_t, double> distance;   // To track cumulative distances
-        std::set<std::pair<double, uint32_t>> pq;        // Min-heap priority queue {distance, vertexId}
+    // Search graph vertices from the start up to the meeting vertex and down to the end
+    std::vector<uint32_t> hops;
+    for (uint32_t u = meeting; u != CompactGraph::kInvalidIndex; u = workspace.previous(u))
+        hops.push_back(u);
+    std::reverse(hops.begin(), hops.end());
+    for (uint32_t u = backward.previous(meeting); u != CompactGraph::kInvalidIndex; u = backward.previous(u))
+        hops.push_back(u);
+
+    std::vector<uint32_t> indices = {hops.front()};
+    for (size_t i = 1; i < hops.size(); ++i)
+        hierarchy.unpack(hops[i - 1], hops[i], indices);
+
+    // Cumulative lengths are summed along the original edges, like the unidirectional searches do
+    double length = 0.0;
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        if (i > 0)
+            length += edgeWeight(compact, indices[i - 1], indices[i]);
+        result.path.push_back(compact.idOf(indices[i]));
+        result.lengths.push_back(length);
+    }
+    result.cost = result.lengths.back();
+    result.status = PathResult::Status::Found;
+    result.searchTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+}
 
-        for (const auto &pair : graph.getVertices())
+// Appends (without from) the original path that a clique edge from -> to of the level stands for. The
+// edge is searched inside its cell on the overlay of the level below (original edges at level 1), as the
+// customization built it, and the clique edges of the level below on that path are unpacked in turn
+static void unpackCliqueEdge(const CompactGraph &compact, const MultiLevelOverlay &overlay, uint32_t level, uint32_t from,
+                             uint32_t to, SearchWorkspace &workspace, std::vector<uint32_t> &indices)
+{
+    using Traits = DoubleWeights;
+    DaryHeap<double> &queue = workspace.queue<DaryHeap<double>>();
+    uint32_t cell = overlay.cellOf(level, from);
+    workspace.begin<Traits>(compact.vertexCount());
+    queue.clear(compact.vertexCount());
+    workspace.reach(from, 0.0, CompactGraph::kInvalidIndex);
+    queue.push(from, 0.0);
+    while (!queue.empty())
+    {
+        uint32_t current = queue.pop();
+        if (current == to)
+            break;
+        double currentDistance = workspace.distance<Traits>(current);
+        auto relax = [&](uint32_t neighbor, double weight)
         {
-            distance[pair.first] = std::numeric_limits<double>::infinity(); // All vertices initially at infinite distance
+            double updatedDistance = currentDistance + weight;
+            if (overlay.cellOf(level, neighbor) == cell && updatedDistance < workspace.distance<Traits>(neighbor))
+            {
+                workspace.reach(neighbor, updatedDistance, current);
+                queue.push(neighbor, updatedDistance);
+            }
+        };
+        if (level == 1)
+        {
+            compact.forEachEdge(current, relax);
+            continue;
         }
+        // Every vertex reached is a boundary vertex of its cell one level below
+        uint32_t subcell = overlay.cellOf(level - 1, current);
+        overlay.forEachCliqueEdge(level - 1, current, relax);
+        compact.forEachEdge(current, [&](uint32_t neighbor, double weight)
+                            {
+            if (overlay.cellOf(level - 1, neighbor) != subcell)
+                relax(neighbor, weight); });
+    }
+
+    std::vector<uint32_t> hops;
+    for (uint32_t u = to; u != from; u = workspace.previous(u))
+        hops.push_back(u);
+    hops.push_back(from);
+    std::reverse(hops.begin(), hops.end());
+    for (size_t i = 1; i < hops.size(); ++i)
+    {
+        if (level > 1 && overlay.cellOf(level - 1, hops[i - 1]) == overlay.cellOf(level - 1, hops[i]))
+            unpackCliqueEdge(compact, overlay, level - 1, hops[i - 1], hops[i], workspace, indices);
+        else
+            indices.push_back(hops[i]);
+    }
+}
 
-        distance[startVertexId] = 0.0;                                  // Distance to start vertex is 0
-        previous[startVertexId] = std::numeric_limits<uint32_t>::max(); // No previous vertex for start vertex
+// Multi-level overlay query: a bidirectional Dijkstra search where a vertex whose query level l is
+// at least 1 (its cell of level l holds neither the start nor the end) only relaxes the clique of that
+// cell and its original edges leaving the cell. The rule is the same seen from both ends of an edge, so
+// both sides search the same graph and the radius stopping criterion of bidirectional Dijkstra holds.
+// The clique edges of the path are then unpacked to original edges.
+template <typename Queue>
+static void multiLevelOverlaySearch(const CompactGraph &compact, const ReverseAdjacency &reverse, const MultiLevelOverlay &overlay,
+                                    SearchWorkspace &workspace, Queue &forwardQueue, Queue &backwardQueue, PathResult &result)
+{
+    using Traits = DoubleWeights;
 
-        pq.insert({0.0, startVertexId});
+    uint32_t startIndex = compact.indexOf(result.startVertexId);
+    uint32_t endIndex = compact.indexOf(result.endVertexId);
+    if (!checkEndpoints(compact, startIndex, endIndex, result))
+        return;
 
-        while (!pq.empty())
-        {
-            uint32_t currentVertexId = pq.begin()->second;
-            pq.erase(pq.begin());
+    SearchWorkspace &backward = workspace.backward();
+    beginSearch<Traits>(compact, workspace, result);
+    auto setupTime = result.setupTime;
+    beginSearch<Traits>(compact, backward, result);
+    result.setupTime += setupTime;
+    auto start = Clock::now();
 
-            if (currentVertexId == endVertexId)
-            {
-                break; // Found the shortest path to the end vertex
-            }
+    forwardQueue.clear(compact.vertexCount());
+    backwardQueue.clear(compact.vertexCount());
+    workspace.reach(startIndex, 0.0, CompactGraph::kInvalidIndex);
+    backward.reach(endIndex, 0.0, CompactGraph::kInvalidIndex);
+    forwardQueue.push(startIndex, 0.0);
+    backwardQueue.push(endIndex, 0.0);
 
-            if (visited.find(currentVertexId) != visited.end())
+    double best = Traits::kInfinity;
+    uint32_t meeting = CompactGraph::kInvalidIndex;
+    double forwardRadius = 0.0, backwardRadius = 0.0;
+    while (!forwardQueue.empty() || !backwardQueue.empty())
+    {
+        bool isForward = backwardQueue.empty() || (!forwardQueue.empty() && forwardRadius <= backwardRadius);
+        SearchWorkspace &side = isForward ? workspace : backward;
+        SearchWorkspace &other = isForward ? backward : workspace;
+        Queue &queue = isForward ? forwardQueue : backwardQueue;
+
+        uint32_t currentIndex = queue.pop();
+        if (side.settled(currentIndex))
+            continue; // Outdated entry
+        double currentDistance = side.distance<Traits>(currentIndex);
+        (isForward ? forwardRadius : backwardRadius) = currentDistance;
+        if (forwardRadius + backwardRadius >= best)
+            break; // No path through an unsettled vertex can be shorter
+        side.settle(currentIndex);
+        result.visitedCount++;
+
+        auto relax = [&](uint32_t neighbor, double weight)
+        {
+            double updatedDistance = currentDistance + weight;
+            if (updatedDistance == Traits::kInfinity)
+                return;
+            if (updatedDistance < side.distance<Traits>(neighbor))
             {
-                continue; // Already visited
+                side.reach(neighbor, updatedDistance, currentIndex);
+                if (!side.settled(neighbor))
+                    queue.push(neighbor, updatedDistance);
             }
-            visited.insert(currentVertexId);
-            visitedCount++;
-
-            const std::vector<Edge> &neighbors = graph.getNeighbors(currentVertexId);
-            for (const Edge &edge : neighbors)
+            if (other.reached(neighbor) && updatedDistance + other.distance<Traits>(neighbor) < best)
             {
-                uint32_t neighbor = edge.getEndId();
-                double weight = edge.getWeight() < 0 ? throw std::runtime_error("Negative edge weight detected") : edge.getWeight(); // Stops if it finds negative weights
-                double updatedDistance = distance[currentVertexId] + weight;
-
-                if (updatedDistance < distance[neighbor])
-                {
-                    // Removes the old distance if it exists
-                    if (distance[neighbor] != std::numeric_limits<double>::infinity())
-                    {
-                        pq.erase({distance[neighbor], neighbor});
-                    }
-                    distance[neighbor] = updatedDistance;
-                    previous[neighbor] = currentVertexId;
-                    // Only add to the priority queue if not visited
-                    if (visited.find(neighbor) == visited.end())
-                    {
-                        pq.insert({updatedDistance, neighbor});
-                    }
-                }
+                best = updatedDistance + other.distance<Traits>(neighbor);
+                meeting = neighbor;
             }
-        }
+        };
 
-        // Reconstruct the shortest path from endVertexId to startVertexId using the 'previous' map.
-        double shortestDistance = distance[endVertexId];
-        std::vector<uint32_t> path;
-        if (shortestDistance == std::numeric_limits<double>::infinity())
+        uint32_t level = overlay.queryLevel(currentIndex, startIndex, endIndex);
+        if (level == 0 || !overlay.isBoundary(level, currentIndex))
         {
-            // No path found if the shortest distance is infinity.
-            path.clear();
-            std::cout << "No path found from vertex " << startVertexId << " to vertex " << endVertexId << ".\n"
-                      << std::endl;
-            return;
+            if (isForward)
+                compact.forEachEdge(currentIndex, relax);
+            else
+                reverse.forEachEdge(compact, currentIndex, relax);
+            continue;
+        }
+        // Original edges inside the cell are covered by its clique
+        uint32_t cell = overlay.cellOf(level, currentIndex);
+        auto relaxLeaving = [&](uint32_t neighbor, double weight)
+        {
+            if (overlay.cellOf(level, neighbor) != cell)
+                relax(neighbor, weight);
+        };
+        if (isForward)
+        {
+            overlay.forEachCliqueEdge(level, currentIndex, relax);
+            compact.forEachEdge(currentIndex, relaxLeaving);
         }
         else
         {
-            // Build the path by following the 'previous' map from endVertexId to startVertexId.
-            path.clear();
-            uint32_t u = endVertexId;
-            while (u != std::numeric_limits<uint32_t>::max())
-            {
-                path.push_back(u);
-                u = previous[u];
-            }
-            std::reverse(path.begin(), path.end()); // Reverse to get path from start to end.
+            overlay.forEachCliqueEdgeBackward(level, currentIndex, relax);
+            reverse.forEachEdge(compact, currentIndex, relaxLeaving);
+        }
+    }
 
-            // Output formatting
-            std::cout << "Total visited vertices = " << visitedCount << std::endl;
-            std::cout << "Total vertices on path from start to end = " << path.size() << std::endl;
-            for (size_t i = 0; i < path.size(); ++i)
-            {
-                std::cout << "Vertex[" << std::setw(4) << (i + 1) << "] : id = " << std::setw(8) << path[i]
-                          << ", length = " << std::fixed << std::setprecision(2) << distance[path[i]] << std::endl;
-            }
+    if (meeting == CompactGraph::kInvalidIndex)
+    {
+        result.status = PathResult::Status::NoPath;
+        result.searchTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+        return;
+    }
 
-            auto end = std::chrono::steady_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-            std::string timeStr = std::to_string(duration);
-            if (timeStr.length() > 3)
-            {
-                timeStr.insert(timeStr.length() - 3, ",");
-            }
-            std::cout << "INFO: path calculated in " << timeStr << "us" << std::endl;
-            graph.drawPath(path);
-            return;
-        }
+    // Overlay vertices from the start to the meeting vertex and on to the end
+    std::vector<uint32_t> hops;
+    for (uint32_t u = meeting; u != CompactGraph::kInvalidIndex; u = workspace.previous(u))
+        hops.push_back(u);
+    std::reverse(hops.begin(), hops.end());
+    for (uint32_t u = backward.previous(meeting); u != CompactGraph::kInvalidIndex; u = backward.previous(u))
+        hops.push_back(u);
+
+    // A hop inside the cell of its query level is a clique edge; the searches are done, so the workspace is free
+    std::vector<uint32_t> indices = {hops.front()};
+    for (size_t i = 1; i < hops.size(); ++i)
+    {
+        uint32_t level = overlay.queryLevel(hops[i - 1], startIndex, endIndex);
+        if (level > 0 && overlay.cellOf(level, hops[i - 1]) == overlay.cellOf(level, hops[i]))
+            unpackCliqueEdge(compact, overlay, level, hops[i - 1], hops[i], workspace, indices);
+        else
+            indices.push_back(hops[i]);
     }
+
+    double length = 0.0;
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        if (i > 0)
+            length += edgeWeight(compact, indices[i - 1], indices[i]);
+        result.path.push_back(compact.idOf(indices[i]));
+        result.lengths.push_back(length);
+    }
+    result.cost = result.lengths.back();
+    result.status = PathResult::Status::Found;
+    result.searchTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
 }
 
-double heuristic(const Vertex &current, const Vertex &goal)
+// Workspace of the printing entry points, one per thread
+static SearchWorkspace &defaultWorkspace()
 {
-    return utils::computeHaversineDistance(current, goal);
+    thread_local SearchWorkspace workspace;
+    return workspace;
 }
 
-void algorithms::aStar(const Graph &graph, uint32_t startVertexId, uint32_t goalVertexId)
+// Prints the result and draws the path on graphs that support it
+static void report(const Graph &graph, const PathResult &result)
 {
-    if (startVertexId == goalVertexId)
+    algorithms::printResult(result, std::cout);
+    if (result.found())
+        graph.drawPath(result.path);
+}
+
+static PathResult newResult(PathResult::Algorithm algorithm, uint32_t startVertexId, uint32_t endVertexId)
+{
+    PathResult result;
+    result.algorithm = algorithm;
+    result.startVertexId = startVertexId;
+    result.endVertexId = endVertexId;
+    return result;
+}
+
+PathResult algorithms::bfs(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, SearchWorkspace &workspace)
+{
+    Graph::SearchView view = graph.getSearchView(); // Pinned for the whole query, even if weights are updated
+    PathResult result = newResult(PathResult::Algorithm::Bfs, startVertexId, endVertexId);
+    runOnAdjacency(view, [&](const auto &adjacency)
+                   { pointToPointSearch<search::StopWhenSettled>(view.compact, adjacency, workspace, workspace.queue<FifoQueue>(),
+                                                                 result, noHeuristic); });
+    return result;
+}
+
+PathResult algorithms::dijkstra(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, SearchWorkspace &workspace,
+                            QueueType queueType)
+{
+    Graph::SearchView view = graph.getSearchView(); // Pinned for the whole query, even if weights are updated
+    PathResult result = newResult(PathResult::Algorithm::Dijkstra, startVertexId, endVertexId);
+    runOnAdjacency(view, [&](const auto &adjacency)
+                   {
+        using Distance = typename std::decay_t<decltype(adjacency)>::Traits::Distance;
+        runWithQueue<Distance>(queueType, workspace, [&](auto &queue)
+                               { pointToPointSearch<search::StopWhenPopped>(view.compact, adjacency, workspace, queue, result,
+                                                                            noHeuristic); }); });
+    return result;
+}
+
+PathResult algorithms::aStar(const Graph &graph, uint32_t startVertexId, uint32_t goalVertexId, SearchWorkspace &workspace,
+                            QueueType queueType)
+{
+    Graph::SearchView view = graph.getSearchView(); // Pinned for the whole query, even if weights are updated
+    PathResult result = newResult(PathResult::Algorithm::AStar, startVertexId, goalVertexId);
+    runOnAdjacency(view, [&](const auto &adjacency)
+                   {
+        using Distance = typename std::decay_t<decltype(adjacency)>::Traits::Distance;
+        runWithQueue<Distance>(queueType, workspace, [&](auto &queue)
+                               {
+            using Traits = typename std::decay_t<decltype(adjacency)>::Traits;
+            pointToPointSearch<search::StopWhenSettled>(view.compact, adjacency, workspace, queue, result, [&](uint32_t, uint32_t goalIndex)
+                        { return GreatCircleHeuristic<Traits>(view.compact, *view.sphere, view.sphereScale, workspace, goalIndex); }); }); });
+    return result;
+}
+
+PathResult algorithms::alt(const Graph &graph, uint32_t startVertexId, uint32_t goalVertexId, SearchWorkspace &workspace,
+                           QueueType queueType, uint32_t activeLandmarks)
+{
+    Graph::SearchView view = graph.getSearchView(); // Pinned for the whole query, even if weights are updated
+    PathResult result = newResult(PathResult::Algorithm::Alt, startVertexId, goalVertexId);
+    if (!view.landmarks || view.landmarks->count() == 0)
+        throw std::runtime_error("Error: ALT needs landmarks, compute them first (--landmarks).");
+    if (queueType == QueueType::Radix)
+        throw std::runtime_error("Error: the radix queue does not support ALT (fractional keys).");
+
+    // The landmark tables hold exact meters of the double weights, so the search runs on the compact
+    // graph: against rounded weights (compressed or integer modes) the bounds would not stay consistent
+    const Landmarks &landmarks = *view.landmarks;
+    std::vector<uint32_t> active;
+    runWithQueue<double>(queueType, workspace, [&](auto &queue)
+                         {
+        pointToPointSearch<search::StopWhenSettled>(view.compact, view.compact, workspace, queue, result, [&](uint32_t startIndex, uint32_t goalIndex)
+                    {
+            active = landmarks.selectActive(startIndex, goalIndex, activeLandmarks);
+            return [&, goalIndex](uint32_t index)
+            {
+                return workspace.potential(index, [&](uint32_t v)
+                                           { return landmarks.lowerBound(v, goalIndex, active); });
+            }; }); });
+    return result;
+}
+
+PathResult algorithms::bidirectionalDijkstra(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId,
+                                             SearchWorkspace &workspace, QueueType queueType)
+{
+    Graph::SearchView view = graph.getSearchView(); // Pinned for the whole query, even if weights are updated
+    PathResult result = newResult(PathResult::Algorithm::BidirectionalDijkstra, startVertexId, endVertexId);
+
+    // The reverse adjacency reads weights by forward edge index, which the compressed adjacency lacks
+    auto search = [&](const auto &forward)
     {
-        std::cout << "Start and goal vertices are the same." << std::endl;
-        return;
-    }
-    else if (graph.getNeighbors(startVertexId).empty() || graph.getNeighbors(goalVertexId).empty())
+        using Distance = typename std::decay_t<decltype(forward)>::Traits::Distance;
+        runWithQueue<Distance>(queueType, workspace, [&](auto &forwardQueue)
+                               {
+            auto &backwardQueue = workspace.backward().queue<std::decay_t<decltype(forwardQueue)>>();
+            bidirectionalDijkstraSearch(view.compact, forward, *view.reverse, workspace, forwardQueue, backwardQueue, result); });
+    };
+    if (view.quantized.index() != 0)
+        std::visit([&](const auto &quantized)
+                   {
+            if constexpr (!std::is_same_v<std::decay_t<decltype(quantized)>, std::monostate>)
+                search(*quantized); },
+                   view.quantized);
+    else
+        search(view.compact);
+    return result;
+}
+
+PathResult algorithms::bidirectionalAStar(const Graph &graph, uint32_t startVertexId, uint32_t goalVertexId,
+                                          SearchWorkspace &workspace, QueueType queueType)
+{
+    Graph::SearchView view = graph.getSearchView(); // Pinned for the whole query, even if weights are updated
+    PathResult result = newResult(PathResult::Algorithm::BidirectionalAStar, startVertexId, goalVertexId);
+
+    // Keys are fractional meters whatever the weight precision, which rules out the radix heap
+    if (queueType == QueueType::Radix)
+        throw std::runtime_error("Error: the radix queue does not support bidirectional A* (fractional keys).");
+    auto search = [&](const auto &forward)
     {
-        std::cout << "Start or goal vertex has no neighbors in the graph." << std::endl;
-        return;
-    }
-    else if (graph.getVertices().find(startVertexId) == graph.getVertices().end() || graph.getVertices().find(goalVertexId) == graph.getVertices().end())
+        runWithQueue<double>(queueType, workspace, [&](auto &forwardQueue)
+                             {
+            auto &backwardQueue = workspace.backward().queue<std::decay_t<decltype(forwardQueue)>>();
+            bidirectionalAStarSearch(view.compact, forward, *view.reverse, *view.sphere, view.sphereScale, workspace, forwardQueue, backwardQueue, result); });
+    };
+    if (view.quantized.index() != 0)
+        std::visit([&](const auto &quantized)
+                   {
+            if constexpr (!std::is_same_v<std::decay_t<decltype(quantized)>, std::monostate>)
+                search(*quantized); },
+                   view.quantized);
+    else
+        search(view.compact);
+    return result;
+}
+
+PathResult algorithms::contractionHierarchy(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId,
+                                            SearchWorkspace &workspace, QueueType queueType)
+{
+    Graph::SearchView view = graph.getSearchView(); // Pinned for the whole query, even if weights are updated
+    PathResult result = newResult(PathResult::Algorithm::ContractionHierarchy, startVertexId, endVertexId);
+    if (!view.hierarchy)
+        throw std::runtime_error("Error: CH queries need a contraction hierarchy, build it first (Graph::contract()).");
+    if (queueType == QueueType::Radix)
+        throw std::runtime_error("Error: the radix queue does not support CH queries (double weights).");
+
+    // Like ALT, the hierarchy holds the double weights whatever the adjacency mode
+    runWithQueue<double>(queueType, workspace, [&](auto &forwardQueue)
+                         {
+        auto &backwardQueue = workspace.backward().queue<std::decay_t<decltype(forwardQueue)>>();
+        contractionHierarchySearch(view.compact, *view.hierarchy, workspace, forwardQueue, backwardQueue, result); });
+    return result;
+}
+
+PathResult algorithms::arcFlags(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, SearchWorkspace &workspace,
+                                QueueType queueType)
+{
+    Graph::SearchView view = graph.getSearchView(); // Pinned for the whole query, even if weights are updated
+    PathResult result = newResult(PathResult::Algorithm::ArcFlags, startVertexId, endVertexId);
+    if (!view.arcFlags)
+        throw std::runtime_error("Error: arc flag queries need arc flags, compute them first (--cells).");
+    if (queueType == QueueType::Radix)
+        throw std::runtime_error("Error: the radix queue does not support arc flag queries (double weights).");
+
+    // The flags were computed on the double weights: the search runs on the compact graph like ALT
+    uint32_t endIndex = view.compact.indexOf(endVertexId);
+    uint32_t cell = endIndex == CompactGraph::kInvalidIndex ? 0 : view.arcFlags->cellOf(endIndex);
+    FlaggedAdjacency adjacency(view.compact, *view.arcFlags, cell);
+    runWithQueue<double>(queueType, workspace, [&](auto &queue)
+                         { pointToPointSearch<search::StopWhenPopped>(view.compact, adjacency, workspace, queue, result, noHeuristic); });
+    return result;
+}
+
+PathResult algorithms::multiLevelOverlay(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, SearchWorkspace &workspace,
+                                         QueueType queueType)
+{
+    Graph::SearchView view = graph.getSearchView(); // Pinned for the whole query, even if weights are updated
+    PathResult result = newResult(PathResult::Algorithm::MultiLevelOverlay, startVertexId, endVertexId);
+    if (!view.overlay)
+        throw std::runtime_error("Error: overlay queries need a multi-level overlay, build it first (Graph::buildOverlay()).");
+    if (queueType == QueueType::Radix)
+        throw std::runtime_error("Error: the radix queue does not support overlay queries (double weights).");
+
+    // Like CH, the cliques hold the double weights whatever the adjacency mode
+    runWithQueue<double>(queueType, workspace, [&](auto &forwardQueue)
+                         {
+        auto &backwardQueue = workspace.backward().queue<std::decay_t<decltype(forwardQueue)>>();
+        multiLevelOverlaySearch(view.compact, *view.reverse, *view.overlay, workspace, forwardQueue, backwardQueue, result); });
+    return result;
+}
+
+PathResult algorithms::hubLabelQuery(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, bool withPath)
+{
+    Graph::SearchView view = graph.getSearchView(); // Pinned for the whole query, even if weights are updated
+    PathResult result = newResult(PathResult::Algorithm::HubLabels, startVertexId, endVertexId);
+    if (!view.hubLabels)
+        throw std::runtime_error("Error: hub label queries need labels, build them first (Graph::buildHubLabels()).");
+
+    uint32_t startIndex = view.compact.indexOf(startVertexId);
+    uint32_t endIndex = view.compact.indexOf(endVertexId);
+    if (!checkEndpoints(view.compact, startIndex, endIndex, result))
+        return result;
+
+    auto start = Clock::now();
+    const HubLabels &labels = *view.hubLabels;
+    double distance = labels.distance(startIndex, endIndex);
+    const HubLabels::Arrays &arrays = labels.arrays(); // The label entries merged stand for the visited vertices
+    result.visitedCount = arrays.forwardOffsets[startIndex + 1] - arrays.forwardOffsets[startIndex] +
+                          arrays.backwardOffsets[endIndex + 1] - arrays.backwardOffsets[endIndex];
+    if (distance == std::numeric_limits<double>::infinity())
+        result.status = PathResult::Status::NoPath;
+    else if (!withPath)
     {
-        std::cout << "Start or goal vertex not found in the graph." << std::endl;
-        return;
+        result.cost = distance; // Distance only: the path stays empty
+        result.status = PathResult::Status::Found;
     }
     else
     {
-        auto start = std::chrono::steady_clock::now();
+        // Cumulative lengths are summed along the original edges, like the other searches do
+        double length = 0.0;
+        std::vector<uint32_t> indices = labels.path(startIndex, endIndex);
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            if (i > 0)
+                length += edgeWeight(view.compact, indices[i - 1], indices[i]);
+            result.path.push_back(view.compact.idOf(indices[i]));
+            result.lengths.push_back(length);
+        }
+        result.cost = result.lengths.back();
+        result.status = PathResult::Status::Found;
+    }
+    result.searchTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+    return result;
+}
 
-        int visitedCount = 0;
-        std::unordered_set<uint32_t> visited;            // Set of visited vertex IDs
-        std::unordered_map<uint32_t, uint32_t> previous; // To reconstruct the path
-        std::unordered_map<uint32_t, double> distance;   // To track cumulative distances - g(n)
-        std::set<std::pair<double, uint32_t>> pq;        // Min-heap priority queue {f(n), vertexId}
+void algorithms::bfs(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId)
+{
+    report(graph, bfs(graph, startVertexId, endVertexId, defaultWorkspace()));
+}
 
-        const Vertex &goalVertex = graph.getVertex(goalVertexId);
+void algorithms::dijkstra(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, QueueType queueType)
+{
+    report(graph, dijkstra(graph, startVertexId, endVertexId, defaultWorkspace(), queueType));
+}
 
-        for (const auto &pair : graph.getVertices())
-        {
-            uint32_t vertexId = pair.first;
-            distance[vertexId] = std::numeric_limits<double>::infinity();
-        }
+void algorithms::aStar(const Graph &graph, uint32_t startVertexId, uint32_t goalVertexId, QueueType queueType)
+{
+    report(graph, aStar(graph, startVertexId, goalVertexId, defaultWorkspace(), queueType));
+}
 
-        distance[startVertexId] = 0.0;
-        previous[startVertexId] = std::numeric_limits<uint32_t>::max();
-        pq.insert({heuristic(graph.getVertex(startVertexId), goalVertex), startVertexId});
+void algorithms::alt(const Graph &graph, uint32_t startVertexId, uint32_t goalVertexId, QueueType queueType)
+{
+    report(graph, alt(graph, startVertexId, goalVertexId, defaultWorkspace(), queueType));
+}
 
-        while (!pq.empty())
-        {
-            uint32_t currentVertexId = pq.begin()->second;
-            pq.erase(pq.begin());
+void algorithms::bidirectionalDijkstra(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, QueueType queueType)
+{
+    report(graph, bidirectionalDijkstra(graph, startVertexId, endVertexId, defaultWorkspace(), queueType));
+}
 
-            if (visited.find(currentVertexId) != visited.end())
-                continue;
-            visited.insert(currentVertexId);
-            visitedCount++;
+void algorithms::bidirectionalAStar(const Graph &graph, uint32_t startVertexId, uint32_t goalVertexId, QueueType queueType)
+{
+    report(graph, bidirectionalAStar(graph, startVertexId, goalVertexId, defaultWorkspace(), queueType));
+}
 
-            if (currentVertexId == goalVertexId)
-                break;
+void algorithms::contractionHierarchy(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, QueueType queueType)
+{
+    report(graph, contractionHierarchy(graph, startVertexId, endVertexId, defaultWorkspace(), queueType));
+}
 
-            const std::vector<Edge> &neighbors = graph.getNeighbors(currentVertexId);
-            for (const Edge &edge : neighbors)
-            {
-                uint32_t neighbor = edge.getEndId();
-                double weight = edge.getWeight();
-                double g = distance[currentVertexId] + weight;
+void algorithms::arcFlags(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, QueueType queueType)
+{
+    report(graph, arcFlags(graph, startVertexId, endVertexId, defaultWorkspace(), queueType));
+}
 
-                if (g < distance[neighbor])
-                {
-                    if (distance[neighbor] != std::numeric_limits<double>::infinity())
-                        pq.erase({distance[neighbor] + heuristic(graph.getVertex(neighbor), goalVertex), neighbor});
-                    distance[neighbor] = g;
-                    previous[neighbor] = currentVertexId;
-                    double f = g + heuristic(graph.getVertex(neighbor), goalVertex);
-                    pq.insert({f, neighbor});
-                }
-            }
-        }
+void algorithms::multiLevelOverlay(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, QueueType queueType)
+{
+    report(graph, multiLevelOverlay(graph, startVertexId, endVertexId, defaultWorkspace(), queueType));
+}
 
-        double shortestDistance = distance[goalVertexId];
-        std::vector<uint32_t> path;
-        if (shortestDistance == std::numeric_limits<double>::infinity())
-        {
-            std::cout << "No path found from vertex " << startVertexId << " to vertex " << goalVertexId << ".\n"
-                      << std::endl;
-            return;
-        }
-        else
-        {
-            uint32_t u = goalVertexId;
-            while (u != std::numeric_limits<uint32_t>::max())
-            {
-                path.push_back(u);
-                u = previous[u];
-            }
-            std::reverse(path.begin(), path.end());
+void algorithms::hubLabels(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, bool withPath)
+{
+    report(graph, hubLabelQuery(graph, startVertexId, endVertexId, withPath));
+}
 
-            std::cout << "Total visited vertices = " << visitedCount << std::endl;
-            std::cout << "Total vertices on path from start to end = " << path.size() << std::endl;
-            for (size_t i = 0; i < path.size(); ++i)
-            {
-                std::cout << "Vertex[" << std::setw(4) << (i + 1) << "] : id = " << std::setw(8) << path[i]
-                          << ", length = " << std::fixed << std::setprecision(2) << distance[path[i]] << std::endl;
-            }
+void algorithms::printResult(const PathResult &result, std::ostream &out)
+{
+    const char *endName = result.algorithm == PathResult::Algorithm::AStar ||
+                                  result.algorithm == PathResult::Algorithm::BidirectionalAStar ||
+                                  result.algorithm == PathResult::Algorithm::Alt
+                              ? "goal"
+                              : "end";
+    switch (result.status)
+    {
+    case PathResult::Status::SameVertex:
+        out << "Start and " << endName << " vertices are the same." << std::endl;
+        return;
+    case PathResult::Status::NoNeighbors:
+        out << "Start or " << endName << " vertex has no neighbors in the graph." << std::endl;
+        return;
+    case PathResult::Status::NotFound:
+        out << "Start or " << endName << " vertex not found in the graph." << std::endl;
+        return;
+    case PathResult::Status::NoPath:
+        if (result.algorithm == PathResult::Algorithm::Bfs)
+            out << "Total visited vertices = " << result.visitedCount << std::endl;
+        out << "No path found from vertex " << result.startVertexId << " to vertex " << result.endVertexId << ".\n"
+            << std::endl;
+        return;
+    case PathResult::Status::Found:
+        break;
+    }
 
-            auto end = std::chrono::steady_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-            std::string timeStr = std::to_string(duration);
-            if (timeStr.length() > 3)
-            {
-                timeStr.insert(timeStr.length() - 3, ",");
-            }
-            std::cout << "INFO: path calculated in " << timeStr << "us" << std::endl;
-            graph.drawPath(path);
-            return;
-        }
+    // Output formatting
+    if (result.path.empty())
+    {
+        // Distance-only queries (hub labels without paths)
+        out << "Distance from vertex " << result.startVertexId << " to vertex " << result.endVertexId << " = "
+            << std::fixed << std::setprecision(2) << result.cost << std::endl;
+        return;
+    }
+    out << "Total visited vertices = " << result.visitedCount << std::endl;
+    out << "Total vertices on path from start to end = " << result.path.size() << std::endl;
+    for (size_t i = 0; i < result.path.size(); ++i)
+    {
+        out << "Vertex[" << std::setw(4) << (i + 1) << "] : id = " << std::setw(8) << result.path[i]
+            << ", length = " << std::fixed << std::setprecision(2) << result.lengths[i] << std::endl;
+    }
+
+    std::string timeStr = std::to_string(result.searchTime.count());
+    if (timeStr.length() > 3)
+    {
+        timeStr.insert(timeStr.end() - 3, ',');
     }
+    out << "INFO: path calculated in " << timeStr << "us" << std::endl;
 }
\ No newline at end of file
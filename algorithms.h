@@ -2,7 +2,11 @@
 #define ALGORITHMS_H
 
 #include "Graph.h"
+#include "PathResult.h"
+#include "PriorityQueue.h"
+#include "SearchWorkspace.h"
 #include <iostream>
+#include <ostream>
 #include <queue>
 #include <unordered_set>
 
@@ -25,8 +29,9 @@ namespace algorithms
      * @param graph The graph to search.
      * @param startVertexId The starting vertex ID.
      * @param endVertexId The ending vertex ID.
+     * @param queueType The priority queue implementation to use.
      */
-    void dijkstra(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId);
+    void dijkstra(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, QueueType queueType = QueueType::DaryHeap);
 
     /**
      * Performs the A* search algorithm on the graph,
@@ -36,8 +41,152 @@ namespace algorithms
      * @param graph The graph to search.
      * @param startVertexId The starting vertex ID.
      * @param goalVertexId The goal vertex ID.
+     * @param queueType The priority queue implementation to use.
      */
-    void aStar(const Graph &graph, uint32_t startVertexId, uint32_t goalVertexId);
+    void aStar(const Graph &graph, uint32_t startVertexId, uint32_t goalVertexId, QueueType queueType = QueueType::DaryHeap);
+
+    /**
+     * Performs a bidirectional Dijkstra search: a forward search from the start vertex and a
+     * backward search from the end vertex on the reverse adjacency, stopped as soon as no
+     * unsettled vertex can improve the best path through a vertex reached by both.
+     * Needs no preprocessing and settles roughly half as many vertices on long routes.
+     *
+     * @param graph The graph to search.
+     * @param startVertexId The starting vertex ID.
+     * @param endVertexId The ending vertex ID.
+     * @param queueType The priority queue implementation of both directions.
+     */
+    void bidirectionalDijkstra(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId,
+                               QueueType queueType = QueueType::DaryHeap);
+
+    /**
+     * Performs a bidirectional A* search with the average potential: the forward search uses
+     * (h(v, goal) - h(v, start)) / 2 and the backward search its opposite, so both are consistent
+     * and the bidirectional stopping criterion remains exact. Haversine values are computed at
+     * most once per vertex and query.
+     *
+     * @param graph The graph to search.
+     * @param startVertexId The starting vertex ID.
+     * @param goalVertexId The goal vertex ID.
+     * @param queueType The priority queue implementation of both directions (not the radix heap).
+     */
+    void bidirectionalAStar(const Graph &graph, uint32_t startVertexId, uint32_t goalVertexId,
+                            QueueType queueType = QueueType::DaryHeap);
+
+    /**
+     * Performs an ALT search (A*, Landmarks, Triangle inequality): A* whose potential is the
+     * landmark lower bound of the distance to the goal, over the few landmarks giving the best
+     * bound between the start and the goal. Runs on the double weights of the compact graph.
+     * Throws an exception if the graph has no landmarks (see Graph::computeLandmarks()).
+     *
+     * @param graph The graph to search.
+     * @param startVertexId The starting vertex ID.
+     * @param goalVertexId The goal vertex ID.
+     * @param queueType The priority queue implementation to use (not the radix heap).
+     */
+    void alt(const Graph &graph, uint32_t startVertexId, uint32_t goalVertexId, QueueType queueType = QueueType::DaryHeap);
+
+    /**
+     * Performs a Contraction Hierarchy query: bidirectional Dijkstra restricted to edges leading
+     * to higher ranked vertices, followed by the unpacking of the shortcuts on the path.
+     * Runs on the double weights of the compact graph.
+     * Throws an exception if the graph has no hierarchy (see Graph::contract()).
+     *
+     * @param graph The graph to search.
+     * @param startVertexId The starting vertex ID.
+     * @param endVertexId The ending vertex ID.
+     * @param queueType The priority queue implementation of both directions (not the radix heap).
+     */
+    void contractionHierarchy(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId,
+                              QueueType queueType = QueueType::DaryHeap);
+
+    /**
+     * Performs an arc flag query: Dijkstra that only relaxes the edges flagged for the cell of
+     * the end vertex. Runs on the double weights of the compact graph.
+     * Throws an exception if the graph has no arc flags (see Graph::computeArcFlags()).
+     *
+     * @param graph The graph to search.
+     * @param startVertexId The starting vertex ID.
+     * @param endVertexId The ending vertex ID.
+     * @param queueType The priority queue implementation to use (not the radix heap).
+     */
+    void arcFlags(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, QueueType queueType = QueueType::DaryHeap);
+
+    /**
+     * Performs a multi-level overlay (CRP) query: bidirectional Dijkstra that crosses the cells
+     * holding neither endpoint through their precomputed cliques, followed by the unpacking of the
+     * clique edges on the path. Runs on the double weights of the compact graph.
+     * Throws an exception if the graph has no overlay (see Graph::buildOverlay()).
+     *
+     * @param graph The graph to search.
+     * @param startVertexId The starting vertex ID.
+     * @param endVertexId The ending vertex ID.
+     * @param queueType The priority queue implementation of both directions (not the radix heap).
+     */
+    void multiLevelOverlay(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId,
+                           QueueType queueType = QueueType::DaryHeap);
+
+    /**
+     * Workspace variants of the searches above: they return the result instead of printing it
+     * and keep their per-vertex state in the given workspace, so that consecutive queries
+     * do not allocate or initialize anything proportional to the graph size.
+     *
+     * @param graph The graph to search.
+     * @param startVertexId The starting vertex ID.
+     * @param endVertexId The ending (goal) vertex ID.
+     * @param workspace The workspace to reuse; it must not be used by another query meanwhile.
+     * @param queueType The priority queue implementation to use (not used by BFS).
+     * @return The path, its cost, the visited count and the timings.
+     */
+    PathResult bfs(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, SearchWorkspace &workspace);
+    PathResult dijkstra(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, SearchWorkspace &workspace,
+                        QueueType queueType = QueueType::DaryHeap);
+    PathResult aStar(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, SearchWorkspace &workspace,
+                     QueueType queueType = QueueType::DaryHeap);
+    PathResult bidirectionalDijkstra(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, SearchWorkspace &workspace,
+                                     QueueType queueType = QueueType::DaryHeap);
+    PathResult bidirectionalAStar(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, SearchWorkspace &workspace,
+                                  QueueType queueType = QueueType::DaryHeap);
+    PathResult alt(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, SearchWorkspace &workspace,
+                   QueueType queueType = QueueType::DaryHeap, uint32_t activeLandmarks = 4);
+    PathResult contractionHierarchy(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, SearchWorkspace &workspace,
+                                    QueueType queueType = QueueType::DaryHeap);
+    PathResult arcFlags(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, SearchWorkspace &workspace,
+                        QueueType queueType = QueueType::DaryHeap);
+    PathResult multiLevelOverlay(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, SearchWorkspace &workspace,
+                                 QueueType queueType = QueueType::DaryHeap);
+
+    /**
+     * Answers a query with the hub labels of the graph (see Graph::buildHubLabels()):
+     * the distance is the best common hub of the forward label of the start and the
+     * backward label of the end. Throws an exception if the graph has no labels, or if
+     * a path is requested from labels built without paths.
+     *
+     * @param graph The graph to query.
+     * @param startVertexId The starting vertex ID.
+     * @param endVertexId The ending vertex ID.
+     * @param withPath True to also retrieve the path, false for the distance only (empty path).
+     * @return The result; its cost is exact to about a centimeter in distance-only mode.
+     */
+    PathResult hubLabelQuery(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, bool withPath);
+
+    /**
+     * Performs a hub label query and prints its result: the distance, or the path like the other searches.
+     *
+     * @param graph The graph to query.
+     * @param startVertexId The starting vertex ID.
+     * @param endVertexId The ending vertex ID.
+     * @param withPath True to also retrieve the path.
+     */
+    void hubLabels(const Graph &graph, uint32_t startVertexId, uint32_t endVertexId, bool withPath);
+
+    /**
+     * Prints a search result in the format of the printing searches.
+     *
+     * @param result The result to print.
+     * @param out The stream to print to.
+     */
+    void printResult(const PathResult &result, std::ostream &out);
 };
 
 #endif
\ No newline at end of file
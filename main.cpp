@@ -2,11 +2,40 @@
 #include "Graph.h"
 #include "GraphicGraph.h"
 #include "algorithms.h"
+#include "Snapshot.h"
+#include "Reordering.h"
+#include "QueueBenchmark.h"
+#include "DistanceMatrix.h"
+#include "DeltaStepping.h"
+#include "BatchQueries.h"
+#include "Isochrone.h"
+#include "AlternativeRoutes.h"
+#include "GraphParser.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <variant>
 #include <QApplication>
 #include <QGraphicsScene>
 #include <QGraphicsView>
 
-void runAlgorithm(const std::string &algorithm, const Graph &graph, uint32_t startId, uint32_t endId)
+// Landmarks computed for --algorithm alt when neither --landmarks nor the snapshot provide them
+constexpr uint32_t kDefaultLandmarks = 16;
+
+// Cells of the arc flag partition for --algorithm arcflags when neither --cells nor the snapshot provide flags
+constexpr uint32_t kDefaultCells = 32;
+
+// Overlay levels for --algorithm crp when --crp-levels is not given
+constexpr uint32_t kDefaultOverlayLevels = 3;
+
+void runAlgorithm(const std::string &algorithm, const Graph &graph, uint32_t startId, uint32_t endId, QueueType queueType,
+                  bool labelPaths)
 {
     if (algorithm == "bfs")
     {
@@ -14,24 +43,191 @@ void runAlgorithm(const std::string &algorithm, const Graph &graph, uint32_t sta
     }
     else if (algorithm == "dijkstra")
     {
-        algorithms::dijkstra(graph, startId, endId);
+        algorithms::dijkstra(graph, startId, endId, queueType);
     }
     else if (algorithm == "astar")
     {
-        algorithms::aStar(graph, startId, endId);
+        algorithms::aStar(graph, startId, endId, queueType);
+    }
+    else if (algorithm == "bidijkstra")
+    {
+        algorithms::bidirectionalDijkstra(graph, startId, endId, queueType);
+    }
+    else if (algorithm == "biastar")
+    {
+        algorithms::bidirectionalAStar(graph, startId, endId, queueType);
+    }
+    else if (algorithm == "alt")
+    {
+        algorithms::alt(graph, startId, endId, queueType);
+    }
+    else if (algorithm == "ch")
+    {
+        algorithms::contractionHierarchy(graph, startId, endId, queueType);
+    }
+    else if (algorithm == "hl")
+    {
+        algorithms::hubLabels(graph, startId, endId, labelPaths);
+    }
+    else if (algorithm == "arcflags")
+    {
+        algorithms::arcFlags(graph, startId, endId, queueType);
+    }
+    else if (algorithm == "crp")
+    {
+        algorithms::multiLevelOverlay(graph, startId, endId, queueType);
     }
     else
     {
-        std::cerr << "Error: Unknown algorithm '" << algorithm << "'. Use bfs, dijkstra, or astar." << std::endl;
+        std::cerr << "Error: Unknown algorithm '" << algorithm << "'. Use bfs, dijkstra, astar, bidijkstra, biastar, alt, ch, hl, arcflags, or crp." << std::endl;
     }
 }
 
+void applyWeights(Graph &graph, const std::string &weightsFile)
+{
+    size_t updated = graph.loadWeightUpdates(weightsFile);
+    std::cout << "INFO: " << updated << " edge weights updated from " << weightsFile
+              << " (weight version " << graph.getCompact().version() << ")" << std::endl;
+}
+
+void compressGraph(Graph &graph)
+{
+    graph.compress();
+    CompactGraph compact = graph.getCompact();
+    const CompactGraph::Arrays &arrays = compact.arrays();
+    double plainBytes = static_cast<double>(arrays.offsets.size_bytes() + arrays.targets.size_bytes() +
+                                            arrays.weights.size_bytes());
+    std::cout << "INFO: compressed adjacency: " << graph.getCompressed()->bytesPerEdge()
+              << " bytes/edge (plain layout: " << plainBytes / std::max<size_t>(1, compact.edgeCount())
+              << " bytes/edge)" << std::endl;
+}
+
+void quantizeGraph(Graph &graph, const std::string &precision)
+{
+    if (precision == "cm")
+        graph.quantize<CentimeterWeights>();
+    else if (precision == "dm")
+        graph.quantize<DecimeterWeights>();
+    else
+        throw std::runtime_error("Error: Unknown precision '" + precision + "'. Use cm or dm.");
+
+    // Same arrays in double precision: the ID translation is not part of either footprint
+    CompactGraph compact = graph.getCompact();
+    size_t doubleBytes = compact.memoryUsage() - compact.arrays().ids.size_bytes() - compact.arrays().idOrder.size_bytes();
+    std::visit([&](const auto &quantized)
+               {
+        if constexpr (!std::is_same_v<std::decay_t<decltype(quantized)>, std::monostate>)
+            std::cout << "INFO: quantized graph (" << precision << "): " << quantized->memoryUsage()
+                      << " bytes (double precision: " << doubleBytes << " bytes)" << std::endl; },
+               graph.getQuantized());
+}
+
+void computeLandmarks(Graph &graph, uint32_t count, const std::string &strategy)
+{
+    auto start = std::chrono::steady_clock::now();
+    graph.computeLandmarks(count, strategy);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "INFO: " << graph.getLandmarks()->count() << " landmarks (" << strategy << ") computed in "
+              << elapsed.count() << "ms, " << graph.getLandmarks()->memoryUsage() << " bytes" << std::endl;
+}
+
+void contractGraph(Graph &graph)
+{
+    auto start = std::chrono::steady_clock::now();
+    graph.contract();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::shared_ptr<const ContractionHierarchy> hierarchy = graph.getHierarchy();
+    std::cout << "INFO: contraction hierarchy built in " << elapsed.count() << "ms, " << hierarchy->shortcutCount()
+              << " shortcuts, " << hierarchy->memoryUsage() << " bytes" << std::endl;
+}
+
+void buildHubLabels(Graph &graph, bool withPaths)
+{
+    auto start = std::chrono::steady_clock::now();
+    graph.buildHubLabels(withPaths);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::shared_ptr<const HubLabels> labels = graph.getHubLabels();
+    std::cout << "INFO: hub labels built in " << elapsed.count() << "ms, " << labels->entryCount() << " entries, "
+              << labels->memoryUsage() << " bytes" << std::endl;
+}
+
+void computeArcFlags(Graph &graph, uint32_t cellCount)
+{
+    auto start = std::chrono::steady_clock::now();
+    graph.computeArcFlags(cellCount);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::shared_ptr<const ArcFlags> flags = graph.getArcFlags();
+    std::cout << "INFO: arc flags for " << flags->cellCount() << " cells computed in " << elapsed.count() << "ms, "
+              << std::lround(1000.0 * flags->density()) / 10.0 << "% set, " << flags->memoryUsage() << " bytes" << std::endl;
+}
+
+void buildOverlay(Graph &graph, uint32_t levelCount)
+{
+    graph.buildOverlay(levelCount);
+    std::shared_ptr<const MultiLevelOverlay> overlay = graph.getOverlay();
+    std::cout << "INFO: overlay of " << overlay->levelCount() << " levels (";
+    for (uint32_t level = 1; level <= overlay->levelCount(); ++level)
+        std::cout << (level > 1 ? "/" : "") << overlay->cellCount(level);
+    std::cout << " cells), " << overlay->boundaryCount() << " boundary vertices, partitioned in "
+              << overlay->partitionTime().count() << "ms, customized in " << overlay->customizationTime().count() << "ms, "
+              << overlay->memoryUsage() << " bytes" << std::endl;
+}
+
+// Builds what --algorithm hl needs unless a snapshot already provided it
+void prepareHubLabels(Graph &graph, bool withPaths)
+{
+    std::shared_ptr<const HubLabels> labels = graph.getHubLabels();
+    if (!labels || (withPaths && !labels->hasPaths()))
+        buildHubLabels(graph, withPaths);
+}
+
+void reorderGraph(Graph &graph, const std::string &strategy, bool printReport)
+{
+    CompactGraph before = graph.getCompact();
+    graph.reorder(reordering::computeOrder(before, strategy));
+    if (printReport)
+        reordering::printReport(before, graph.getCompact(), std::cout);
+}
+
 int main(int argc, char *argv[])
 {
     std::string start = "", end = "";
     std::string algorithm;
     std::string filename;
     std::string mode;
+    std::string snapshotFile;
+    std::string saveSnapshotFile;
+    std::string weightsFile;
+    std::string reorderStrategy;
+    bool printStatistics = false;
+    bool printReorderReport = false;
+    bool useCompressed = false;
+    std::string quantizedPrecision;
+    std::string queueName = "dary";
+    uint32_t benchmarkQueries = 0;
+    uint32_t landmarkCount = 0;
+    std::string landmarkStrategy = "avoid";
+    bool saveHubLabels = false;
+    bool labelPaths = false;
+    uint32_t labelBenchmarkQueries = 0;
+    std::string sourcesFile;
+    std::string targetsFile;
+    std::string matrixFile;
+    std::string ssspSource;
+    std::string ssspFile;
+    double delta = 0.0;
+    unsigned threadCount = 0;
+    std::string queriesFile;
+    std::string batchFile;
+    bool batchPaths = false;
+    bool checkResults = false;
+    double isochroneBudget = 0.0;
+    std::string isochroneFile;
+    std::string outlineFile;
+    uint32_t alternativeCount = 0;
+    uint32_t cellCount = 0;
+    uint32_t overlayLevels = kDefaultOverlayLevels;
+    std::string alternativesMethod = "plateau";
 
     // Argument parsing
     for (int i = 1; i < argc; i++)
@@ -47,20 +243,318 @@ int main(int argc, char *argv[])
             filename = argv[++i];
         else if (arg == "--mode" && i + 1 < argc)
             mode = argv[++i];
+        else if (arg == "--snapshot" && i + 1 < argc)
+            snapshotFile = argv[++i];
+        else if (arg == "--save-snapshot" && i + 1 < argc)
+            saveSnapshotFile = argv[++i];
+        else if (arg == "--weights" && i + 1 < argc)
+            weightsFile = argv[++i];
+        else if (arg == "--reorder" && i + 1 < argc)
+            reorderStrategy = argv[++i];
+        else if (arg == "--reorder-report")
+            printReorderReport = true;
+        else if (arg == "--quantized" && i + 1 < argc)
+            quantizedPrecision = argv[++i];
+        else if (arg == "--queue" && i + 1 < argc)
+            queueName = argv[++i];
+        else if (arg == "--benchmark-queues" && i + 1 < argc)
+            benchmarkQueries = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--landmarks" && i + 1 < argc)
+            landmarkCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--landmark-strategy" && i + 1 < argc)
+            landmarkStrategy = argv[++i];
+        else if (arg == "--hub-labels")
+            saveHubLabels = true;
+        else if (arg == "--hl-path")
+            labelPaths = true;
+        else if (arg == "--benchmark-labels" && i + 1 < argc)
+            labelBenchmarkQueries = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--sources" && i + 1 < argc)
+            sourcesFile = argv[++i];
+        else if (arg == "--targets" && i + 1 < argc)
+            targetsFile = argv[++i];
+        else if (arg == "--matrix-output" && i + 1 < argc)
+            matrixFile = argv[++i];
+        else if (arg == "--sssp" && i + 1 < argc)
+            ssspSource = argv[++i];
+        else if (arg == "--sssp-output" && i + 1 < argc)
+            ssspFile = argv[++i];
+        else if (arg == "--delta" && i + 1 < argc)
+            delta = std::stod(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc)
+            threadCount = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (arg == "--queries" && i + 1 < argc)
+            queriesFile = argv[++i];
+        else if (arg == "--batch-output" && i + 1 < argc)
+            batchFile = argv[++i];
+        else if (arg == "--batch-paths")
+            batchPaths = true;
+        else if (arg == "--check")
+            checkResults = true;
+        else if (arg == "--isochrone" && i + 1 < argc)
+            isochroneBudget = std::stod(argv[++i]);
+        else if (arg == "--isochrone-output" && i + 1 < argc)
+            isochroneFile = argv[++i];
+        else if (arg == "--outline" && i + 1 < argc)
+            outlineFile = argv[++i];
+        else if (arg == "--alternatives" && i + 1 < argc)
+            alternativeCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--alternatives-method" && i + 1 < argc)
+            alternativesMethod = argv[++i];
+        else if (arg == "--cells" && i + 1 < argc)
+            cellCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--crp-levels" && i + 1 < argc)
+            overlayLevels = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--compressed")
+            useCompressed = true;
+        else if (arg == "--stats")
+            printStatistics = true;
+    }
+
+    // Snapshot generation mode: parse the text file once and write its binary snapshot
+    if (!saveSnapshotFile.empty())
+    {
+        if (filename.empty())
+        {
+            std::cerr << "Error: --file is required with --save-snapshot." << std::endl;
+            return 1;
+        }
+        try
+        {
+            Graph graph(filename);
+            if (!weightsFile.empty())
+                applyWeights(graph, weightsFile);
+            if (!reorderStrategy.empty())
+                reorderGraph(graph, reorderStrategy, printReorderReport);
+            if (landmarkCount > 0)
+                computeLandmarks(graph, landmarkCount, landmarkStrategy);
+            if (saveHubLabels)
+                buildHubLabels(graph, false);
+            if (cellCount > 0)
+                computeArcFlags(graph, cellCount);
+            CompactGraph compact = graph.getCompact();
+            snapshot::save(compact, saveSnapshotFile, filename, graph.getLandmarks().get(), graph.getHubLabels().get(),
+                           graph.getArcFlags().get());
+            std::cout << "INFO: snapshot of " << compact.vertexCount() << " vertices and "
+                      << compact.edgeCount() << " edges written to " << saveSnapshotFile << std::endl;
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        if (start == "" && end == "")
+            return 0;
+    }
+
+    // Benchmark mode: compare the priority queues, or report on hub labels, on random queries
+    if (benchmarkQueries > 0 || labelBenchmarkQueries > 0)
+    {
+        if (filename.empty() && snapshotFile.empty())
+        {
+            std::cerr << "Error: --file or --snapshot is required with --benchmark-queues and --benchmark-labels." << std::endl;
+            return 1;
+        }
+        try
+        {
+            CompactGraph compact = snapshotFile.empty() ? Graph(filename).getCompact()
+                                                        : snapshot::load(snapshotFile, filename);
+            if (benchmarkQueries > 0)
+                benchmark::compareQueues(compact, benchmarkQueries, std::cout);
+            if (labelBenchmarkQueries > 0)
+                benchmark::reportHubLabels(compact, labelBenchmarkQueries, std::cout);
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Isochrone mode: everything reachable within a budget from one or several sources
+    if (isochroneBudget > 0.0)
+    {
+        if ((start.empty() && sourcesFile.empty()) || (filename.empty() && snapshotFile.empty()))
+        {
+            std::cerr << "Error: --start or --sources, and --file or --snapshot are required with --isochrone." << std::endl;
+            return 1;
+        }
+        try
+        {
+            Graph graph(snapshotFile.empty() ? Graph(filename).getCompact() : snapshot::load(snapshotFile, filename));
+            if (!weightsFile.empty())
+                applyWeights(graph, weightsFile);
+
+            std::vector<uint32_t> sources = sourcesFile.empty() ? std::vector<uint32_t>{static_cast<uint32_t>(std::stoul(start))}
+                                                                : parser::parseVertexList(sourcesFile);
+            auto startTime = std::chrono::steady_clock::now();
+            std::vector<isochrone::Isochrone> areas = isochrone::computeAll(graph, sources, isochroneBudget, threadCount);
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+
+            if (isochroneFile.empty())
+                isochrone::writeCsv(areas, std::cout);
+            else
+            {
+                std::ofstream out(isochroneFile);
+                if (!out.is_open())
+                    throw std::runtime_error("Error: could not open file " + isochroneFile + " for writing");
+                isochrone::writeCsv(areas, out);
+            }
+            if (!outlineFile.empty())
+            {
+                std::ofstream out(outlineFile);
+                if (!out.is_open())
+                    throw std::runtime_error("Error: could not open file " + outlineFile + " for writing");
+                isochrone::writeGeoJson(graph, areas, out);
+            }
+
+            size_t reached = 0, boundary = 0;
+            for (const isochrone::Isochrone &area : areas)
+            {
+                reached += area.vertexIds.size();
+                boundary += area.boundary.size();
+            }
+            (isochroneFile.empty() ? std::cerr : std::cout)
+                << "INFO: " << areas.size() << " isochrones of " << isochroneBudget << "m computed in " << elapsed.count()
+                << "us: " << reached << " vertices reached, " << boundary << " boundary edges" << std::endl;
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Distance matrix mode: distances from every source to every target, as CSV or binary
+    if (!sourcesFile.empty() || !targetsFile.empty())
+    {
+        if (sourcesFile.empty() || targetsFile.empty() || (filename.empty() && snapshotFile.empty()))
+        {
+            std::cerr << "Error: --sources, --targets and --file or --snapshot are required for a distance matrix." << std::endl;
+            return 1;
+        }
+        try
+        {
+            Graph graph(snapshotFile.empty() ? Graph(filename).getCompact() : snapshot::load(snapshotFile, filename));
+            if (!weightsFile.empty())
+                applyWeights(graph, weightsFile);
+            if (algorithm == "ch")
+                contractGraph(graph); // Bucket many-to-many instead of one Dijkstra per source
+
+            std::vector<uint32_t> sources = parser::parseVertexList(sourcesFile);
+            std::vector<uint32_t> targets = parser::parseVertexList(targetsFile);
+            auto startTime = std::chrono::steady_clock::now();
+            matrix::DistanceTable table = matrix::compute(graph, sources, targets);
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+
+            if (matrixFile.empty())
+                matrix::writeCsv(table, std::cout);
+            else if (matrixFile.size() >= 4 && matrixFile.compare(matrixFile.size() - 4, 4, ".bin") == 0)
+                matrix::writeBinary(table, matrixFile);
+            else
+            {
+                std::ofstream out(matrixFile);
+                if (!out.is_open())
+                    throw std::runtime_error("Error: could not open file " + matrixFile + " for writing");
+                matrix::writeCsv(table, out);
+            }
+            (matrixFile.empty() ? std::cerr : std::cout)
+                << "INFO: " << sources.size() << "x" << targets.size() << " distance matrix computed in " << elapsed.count()
+                << "ms (" << (graph.getHierarchy() ? "ch buckets" : "dijkstra") << ")" << std::endl;
+            if (checkResults)
+            {
+                // Reference table from a plain copy of the graph: one Dijkstra search per source
+                Graph plain(graph.getCompact());
+                (matrixFile.empty() ? std::cerr : std::cout)
+                    << "INFO: " << matrix::countMismatches(table, matrix::compute(plain, sources, targets)) << " of "
+                    << table.distances.size() << " entries differ from Dijkstra" << std::endl;
+            }
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Shortest path tree mode: parallel delta-stepping from one source, verified against Dijkstra
+    if (!ssspSource.empty())
+    {
+        if (filename.empty() && snapshotFile.empty())
+        {
+            std::cerr << "Error: --file or --snapshot is required with --sssp." << std::endl;
+            return 1;
+        }
+        try
+        {
+            Graph graph(snapshotFile.empty() ? Graph(filename).getCompact() : snapshot::load(snapshotFile, filename));
+            if (!weightsFile.empty())
+                applyWeights(graph, weightsFile);
+            CompactGraph compact = graph.getCompact();
+            uint32_t sourceIndex = compact.indexOf(static_cast<uint32_t>(std::stoul(ssspSource)));
+            if (sourceIndex == CompactGraph::kInvalidIndex)
+                throw std::runtime_error("Error: vertex " + ssspSource + " not found in the graph.");
+            if (delta <= 0.0)
+                delta = sssp::chooseDelta(compact);
+            unsigned threads = threadCount > 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+
+            auto startTime = std::chrono::steady_clock::now();
+            sssp::ShortestPathTree tree = sssp::deltaStepping(compact, sourceIndex, delta, threads);
+            auto parallelTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+            startTime = std::chrono::steady_clock::now();
+            sssp::ShortestPathTree reference = sssp::dijkstra(compact, sourceIndex);
+            auto sequentialTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+            size_t failures = sssp::verify(compact, tree, reference);
+            size_t reached = static_cast<size_t>(std::count_if(tree.distances.begin(), tree.distances.end(), [](double distance)
+                                                               { return distance != std::numeric_limits<double>::infinity(); }));
+
+            std::cout << "INFO: delta-stepping (delta = " << delta << "m, " << threads << " threads) in "
+                      << parallelTime.count() << "us, sequential Dijkstra in " << sequentialTime.count() << "us" << std::endl;
+            std::cout << "INFO: " << reached << " of " << compact.vertexCount() << " vertices reached, " << failures
+                      << " mismatches against Dijkstra" << std::endl;
+
+            if (!ssspFile.empty())
+            {
+                std::ofstream out(ssspFile);
+                if (!out.is_open())
+                    throw std::runtime_error("Error: could not open file " + ssspFile + " for writing");
+                out << "id,distance,parent\n" << std::fixed << std::setprecision(2);
+                for (uint32_t v = 0; v < compact.vertexCount(); ++v)
+                {
+                    if (tree.distances[v] == std::numeric_limits<double>::infinity())
+                        continue;
+                    out << compact.idOf(v) << ',' << tree.distances[v] << ',';
+                    if (tree.parents[v] != CompactGraph::kInvalidIndex)
+                        out << compact.idOf(tree.parents[v]);
+                    out << '\n';
+                }
+            }
+            if (failures > 0)
+                return 1;
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
     }
 
     // Input validation
-    if (start == "" || end == "")
+    if ((start == "" || end == "") && queriesFile.empty())
     {
-        std::cerr << "Error: --start and --end are required." << std::endl;
+        std::cerr << "Error: --start and --end (or --queries) are required." << std::endl;
         return 1;
     }
-    if (algorithm.empty())
+    if (algorithm.empty() && alternativeCount == 0)
     {
-        std::cerr << "Error: --algorithm is required. Available options are: bfs, dijkstra, astar." << std::endl;
+        std::cerr << "Error: --algorithm is required. Available options are: bfs, dijkstra, astar, bidijkstra, biastar, alt, ch, hl, arcflags, crp." << std::endl;
         return 1;
     }
-    if (filename.empty())
+    if (filename.empty() && snapshotFile.empty())
     {
         std::cerr << "Error: --file is required. Please specify the graph file." << std::endl;
         return 1;
@@ -74,14 +568,116 @@ int main(int argc, char *argv[])
         std::cerr << "Error: --mode must be 'text' or 'graphic'." << std::endl;
         return 1;
     }
+    if (useCompressed && !quantizedPrecision.empty())
+    {
+        std::cerr << "Error: --compressed and --quantized cannot be combined." << std::endl;
+        return 1;
+    }
+    if (!snapshotFile.empty() && mode == "graphic")
+    {
+        std::cerr << "Error: --snapshot is only supported in text mode." << std::endl;
+        return 1;
+    }
+    if (!queriesFile.empty() && mode == "graphic")
+    {
+        std::cerr << "Error: --queries is only supported in text mode." << std::endl;
+        return 1;
+    }
 
     try
     {
+        QueueType queueType = queueTypeFromName(queueName);
         if (mode == "text")
         {
-            Graph graph(filename);
+            // A snapshot is checked against the text file when both are given
+            std::unique_ptr<Graph> graph;
+            if (snapshotFile.empty())
+                graph = std::make_unique<Graph>(filename);
+            else
+            {
+                snapshot::Contents contents = snapshot::loadContents(snapshotFile, filename);
+                graph = std::make_unique<Graph>(contents.graph);
+                graph->setLandmarks(contents.landmarks);
+                graph->setHubLabels(contents.hubLabels);
+                graph->setArcFlags(contents.arcFlags);
+            }
+            if (printStatistics)
+                graph->getStatistics().print(std::cout);
+            if (!weightsFile.empty())
+                applyWeights(*graph, weightsFile);
+            if (!reorderStrategy.empty())
+                reorderGraph(*graph, reorderStrategy, printReorderReport);
+            if (useCompressed)
+                compressGraph(*graph);
+            if (!quantizedPrecision.empty())
+                quantizeGraph(*graph, quantizedPrecision);
+            if (landmarkCount > 0)
+                computeLandmarks(*graph, landmarkCount, landmarkStrategy);
+            else if (algorithm == "alt" && !graph->getLandmarks())
+                computeLandmarks(*graph, kDefaultLandmarks, landmarkStrategy);
+            if (algorithm == "ch")
+                contractGraph(*graph);
+            if (algorithm == "hl")
+                prepareHubLabels(*graph, labelPaths || batchPaths);
+            if (cellCount > 0)
+                computeArcFlags(*graph, cellCount);
+            else if (algorithm == "arcflags" && !graph->getArcFlags())
+                computeArcFlags(*graph, kDefaultCells);
+            if (algorithm == "crp")
+                buildOverlay(*graph, overlayLevels);
+
+            if (!queriesFile.empty())
+            {
+                // Batch mode: the graph is loaded and prepared once for all the queries
+                std::vector<parser::QueryPair> queries = parser::parseQueries(queriesFile);
+                batch::BatchReport report = batch::run(*graph, queries, algorithm, queueType, batchPaths, threadCount);
+                if (batchFile.empty())
+                    batch::writeCsv(report, std::cout, batchPaths);
+                else
+                {
+                    std::ofstream out(batchFile);
+                    if (!out.is_open())
+                        throw std::runtime_error("Error: could not open file " + batchFile + " for writing");
+                    batch::writeCsv(report, out, batchPaths);
+                }
+                batch::printSummary(report, batchFile.empty() ? std::cerr : std::cout);
+                if (checkResults)
+                {
+                    // Reference answers from a plain copy of the graph: Dijkstra on the double weights, with
+                    // the paths whose edge counts bound the rounding error of the integer and compressed modes
+                    Graph plain(graph->getCompact());
+                    batch::BatchReport reference = batch::run(plain, queries, "dijkstra", QueueType::DaryHeap, true, threadCount);
+                    (batchFile.empty() ? std::cerr : std::cout)
+                        << "INFO: " << batch::countMismatches(report, reference, graph->weightStep()) << " of " << queries.size()
+                        << " queries differ from Dijkstra" << std::endl;
+                }
+                return 0;
+            }
+
+            if (alternativeCount > 0)
+            {
+                // Alternative routes: Yen's k shortest paths (exact) or plateaus (fast)
+                SearchWorkspace workspace;
+                auto startTime = std::chrono::steady_clock::now();
+                std::vector<alternatives::Route> routes;
+                if (alternativesMethod == "yen")
+                    routes = alternatives::kShortest(*graph, std::stoul(start), std::stoul(end), alternativeCount, workspace);
+                else if (alternativesMethod == "plateau")
+                {
+                    alternatives::Options options;
+                    options.count = alternativeCount;
+                    routes = alternatives::plateaus(*graph, std::stoul(start), std::stoul(end), options, workspace);
+                }
+                else
+                    throw std::runtime_error("Error: Unknown alternatives method '" + alternativesMethod + "'. Use yen or plateau.");
+                auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+                alternatives::printRoutes(routes, std::cout);
+                std::cout << "INFO: " << routes.size() << " routes (" << alternativesMethod << ") calculated in "
+                          << elapsed.count() << "us" << std::endl;
+                return 0;
+            }
 
-            runAlgorithm(algorithm, graph, std::stoul(start), std::stoul(end));
+            runAlgorithm(algorithm, *graph, std::stoul(start), std::stoul(end), queueType, labelPaths);
 
             return 0;
         }
@@ -92,8 +688,26 @@ int main(int argc, char *argv[])
             QGraphicsView *view = new QGraphicsView(scene);
 
             GraphicGraph graph(filename, scene);
+            if (printStatistics)
+                graph.getStatistics().print(std::cout);
+            if (!weightsFile.empty())
+                applyWeights(graph, weightsFile);
+            if (useCompressed)
+                compressGraph(graph);
+            if (!quantizedPrecision.empty())
+                quantizeGraph(graph, quantizedPrecision);
+            if (landmarkCount > 0 || algorithm == "alt")
+                computeLandmarks(graph, landmarkCount > 0 ? landmarkCount : kDefaultLandmarks, landmarkStrategy);
+            if (algorithm == "ch")
+                contractGraph(graph);
+            if (algorithm == "hl")
+                prepareHubLabels(graph, labelPaths);
+            if (cellCount > 0 || algorithm == "arcflags")
+                computeArcFlags(graph, cellCount > 0 ? cellCount : kDefaultCells);
+            if (algorithm == "crp")
+                buildOverlay(graph, overlayLevels);
 
-            runAlgorithm(algorithm, graph, std::stoul(start), std::stoul(end));
+            runAlgorithm(algorithm, graph, std::stoul(start), std::stoul(end), queueType, labelPaths);
 
             view->show();
             return app.exec();
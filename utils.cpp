@@ -1,5 +1,7 @@
 #include "utils.h"
+#include <algorithm>
 #include <cmath>
+#include <numeric>
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -32,20 +34,29 @@ std::pair<double, double> utils::mediumPoint(const Graph &graph)
     return count > 0 ? std::make_pair(sumLat / count, sumLong / count) : std::make_pair(0.0, 0.0);
 }
 
-std::pair<std::pair<double, double>, std::pair<double, double>> utils::mercatorProjection(const Graph &graph, const Vertex &v1, const Vertex &v2)
+utils::ProjectionContext utils::projectionContext(const Graph &graph)
 {
     auto mid = utils::mediumPoint(graph);
-    double midLatitude = mid.first;
-    double midLongitude = mid.second;
+    return projectionContext(mid.first, mid.second);
+}
 
+utils::ProjectionContext utils::projectionContext(double midLatitude, double midLongitude)
+{
     // Approximate scale factors for converting degrees to meters
     double scale_y = 111000.0 * 0.88; // meters per degree (approx)
     double scale_x = scale_y * std::cos(midLatitude * M_PI / 180.0);
 
-    double x1 = scale_x * (v1.getLongitude() - midLongitude);
-    double y1 = scale_y * (v1.getLatitude() - midLatitude);
-    double x2 = scale_x * (v2.getLongitude() - midLongitude);
-    double y2 = scale_y * (v2.getLatitude() - midLatitude);
+    return ProjectionContext{midLatitude, midLongitude, scale_x, scale_y};
+}
+
+std::pair<std::pair<double, double>, std::pair<double, double>> utils::mercatorProjection(const Graph &graph, const Vertex &v1, const Vertex &v2)
+{
+    ProjectionContext context = utils::projectionContext(graph);
+
+    double x1 = context.scaleX * (v1.getLongitude() - context.midLongitude);
+    double y1 = context.scaleY * (v1.getLatitude() - context.midLatitude);
+    double x2 = context.scaleX * (v2.getLongitude() - context.midLongitude);
+    double y2 = context.scaleY * (v2.getLatitude() - context.midLatitude);
 
     return std::pair<std::pair<double, double>, std::pair<double, double>>(std::make_pair(x1, y1), std::make_pair(x2, y2));
 }
@@ -58,15 +69,38 @@ double utils::computeEuclideanDistance(const Graph &graph, const Vertex &v1, con
     return std::sqrt(dx * dx + dy * dy);
 }
 
+void utils::computeEuclideanDistances(const ProjectionContext &context,
+                                      std::span<const double> longitudes1, std::span<const double> latitudes1,
+                                      std::span<const double> longitudes2, std::span<const double> latitudes2,
+                                      std::span<double> distances)
+{
+    // The medium point cancels out of the difference of two projected points,
+    // only the scale factors are needed
+    const double scaleX = context.scaleX;
+    const double scaleY = context.scaleY;
+    const size_t count = distances.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        double dx = scaleX * (longitudes1[i] - longitudes2[i]);
+        double dy = scaleY * (latitudes1[i] - latitudes2[i]);
+        distances[i] = std::sqrt(dx * dx + dy * dy);
+    }
+}
+
 double utils::computeHaversineDistance(const Vertex &v1, const Vertex &v2)
+{
+    return computeHaversineDistance(v1.getLongitude(), v1.getLatitude(), v2.getLongitude(), v2.getLatitude());
+}
+
+double utils::computeHaversineDistance(double longitude1, double latitude1, double longitude2, double latitude2)
 {
     double radius = 6371000.0; // Radius of the Earth in meters
 
     // Convert degrees to radians
-    double lat1 = v1.getLatitude() * M_PI / 180.0;
-    double lon1 = v1.getLongitude() * M_PI / 180.0;
-    double lat2 = v2.getLatitude() * M_PI / 180.0;
-    double lon2 = v2.getLongitude() * M_PI / 180.0;
+    double lat1 = latitude1 * M_PI / 180.0;
+    double lon1 = longitude1 * M_PI / 180.0;
+    double lat2 = latitude2 * M_PI / 180.0;
+    double lon2 = longitude2 * M_PI / 180.0;
 
     double dLat = lat2 - lat1;
     double dLon = lon2 - lon1;
@@ -78,3 +112,226 @@ double utils::computeHaversineDistance(const Vertex &v1, const Vertex &v2)
 
     return distance;
 }
+
+// Assigns cells [firstCell, firstCell + cellCount) to the vertices of [begin, end), splitting the
+// longer side of their bounding box so that every cell gets the same share of the vertices
+static void kdSplit(const CompactGraph &graph, std::vector<uint32_t>::iterator begin, std::vector<uint32_t>::iterator end,
+                    uint32_t firstCell, uint32_t cellCount, std::vector<uint32_t> &cells)
+{
+    if (cellCount <= 1 || end - begin <= 1)
+    {
+        for (auto it = begin; it != end; ++it)
+            cells[*it] = firstCell;
+        return;
+    }
+
+    double minLon = HUGE_VAL, maxLon = -HUGE_VAL, minLat = HUGE_VAL, maxLat = -HUGE_VAL;
+    for (auto it = begin; it != end; ++it)
+    {
+        minLon = std::min(minLon, graph.longitude(*it));
+        maxLon = std::max(maxLon, graph.longitude(*it));
+        minLat = std::min(minLat, graph.latitude(*it));
+        maxLat = std::max(maxLat, graph.latitude(*it));
+    }
+    // A degree of longitude is shorter than a degree of latitude away from the equator
+    bool byLongitude = (maxLon - minLon) * std::cos((minLat + maxLat) / 2 * M_PI / 180.0) > maxLat - minLat;
+
+    uint32_t leftCells = cellCount / 2;
+    auto middle = begin + (end - begin) * leftCells / cellCount;
+    std::nth_element(begin, middle, end, [&](uint32_t a, uint32_t b)
+                     { return byLongitude ? graph.longitude(a) < graph.longitude(b) : graph.latitude(a) < graph.latitude(b); });
+    kdSplit(graph, begin, middle, firstCell, leftCells, cells);
+    kdSplit(graph, middle, end, firstCell + leftCells, cellCount - leftCells, cells);
+}
+
+std::vector<uint32_t> utils::kdPartition(const CompactGraph &graph, uint32_t cellCount)
+{
+    std::vector<uint32_t> order(graph.vertexCount());
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<uint32_t> cells(graph.vertexCount(), 0);
+    kdSplit(graph, order.begin(), order.end(), 0, std::max<uint32_t>(1, cellCount), cells);
+    return cells;
+}
+
+// Undirected unit-capacity network of the edges inside one part, with local vertex numbers
+struct PartNetwork
+{
+    std::vector<uint32_t> offsets; // Arcs of local vertex i are [offsets[i], offsets[i + 1])
+    std::vector<uint32_t> heads;
+    std::vector<uint32_t> twins;  // Opposite arc of every arc
+    std::vector<int8_t> flow;     // -1, 0 or 1 unit along every arc, opposite to its twin
+};
+
+static PartNetwork buildPartNetwork(const CompactGraph &graph, const ReverseAdjacency &reverse, const std::vector<uint32_t> &part,
+                                    const std::vector<uint32_t> &local)
+{
+    PartNetwork network;
+    network.offsets.reserve(part.size() + 1);
+    network.offsets.push_back(0);
+    for (uint32_t v : part)
+    {
+        size_t first = network.heads.size();
+        for (uint32_t e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e)
+        {
+            if (local[graph.target(e)] != CompactGraph::kInvalidIndex && graph.target(e) != v)
+                network.heads.push_back(local[graph.target(e)]);
+        }
+        for (uint32_t r = reverse.edgeBegin(v); r < reverse.edgeEnd(v); ++r)
+        {
+            if (local[reverse.source(r)] != CompactGraph::kInvalidIndex && reverse.source(r) != v)
+                network.heads.push_back(local[reverse.source(r)]);
+        }
+        // A two-way road is one undirected edge
+        std::sort(network.heads.begin() + first, network.heads.end());
+        network.heads.erase(std::unique(network.heads.begin() + first, network.heads.end()), network.heads.end());
+        network.offsets.push_back(static_cast<uint32_t>(network.heads.size()));
+    }
+    network.twins.resize(network.heads.size());
+    for (uint32_t i = 0; i + 1 < network.offsets.size(); ++i)
+    {
+        for (uint32_t arc = network.offsets[i]; arc < network.offsets[i + 1]; ++arc)
+        {
+            uint32_t j = network.heads[arc];
+            auto begin = network.heads.begin() + network.offsets[j], end = network.heads.begin() + network.offsets[j + 1];
+            network.twins[arc] = static_cast<uint32_t>(std::lower_bound(begin, end, i) - network.heads.begin());
+        }
+    }
+    network.flow.assign(network.heads.size(), 0);
+    return network;
+}
+
+// Max flow from the sources to the sinks (side 1 and 2 of the labels, 0 elsewhere) by breadth-first
+// augmenting paths, then the side of the minimum cut of every vertex: true if reachable from the sources
+static uint32_t minimumCut(PartNetwork &network, const std::vector<uint8_t> &labels, std::vector<uint8_t> &sourceSide)
+{
+    const uint32_t m = static_cast<uint32_t>(labels.size());
+    std::fill(network.flow.begin(), network.flow.end(), 0);
+    std::vector<uint32_t> parentArc(m);
+    std::vector<uint32_t> queue;
+    queue.reserve(m);
+    uint32_t flow = 0;
+    for (;;)
+    {
+        std::fill(parentArc.begin(), parentArc.end(), CompactGraph::kInvalidIndex);
+        queue.clear();
+        for (uint32_t i = 0; i < m; ++i)
+        {
+            if (labels[i] == 1)
+            {
+                parentArc[i] = static_cast<uint32_t>(network.heads.size()); // Root marker
+                queue.push_back(i);
+            }
+        }
+        uint32_t reached = CompactGraph::kInvalidIndex;
+        for (size_t head = 0; head < queue.size() && reached == CompactGraph::kInvalidIndex; ++head)
+        {
+            uint32_t u = queue[head];
+            for (uint32_t arc = network.offsets[u]; arc < network.offsets[u + 1]; ++arc)
+            {
+                uint32_t v = network.heads[arc];
+                if (network.flow[arc] < 1 && parentArc[v] == CompactGraph::kInvalidIndex)
+                {
+                    parentArc[v] = arc;
+                    if (labels[v] == 2)
+                    {
+                        reached = v;
+                        break;
+                    }
+                    queue.push_back(v);
+                }
+            }
+        }
+        if (reached == CompactGraph::kInvalidIndex)
+            break;
+        for (uint32_t v = reached; labels[v] != 1;)
+        {
+            uint32_t arc = parentArc[v];
+            network.flow[arc]++;
+            network.flow[network.twins[arc]]--;
+            v = network.heads[network.twins[arc]];
+        }
+        flow++;
+    }
+    // The last search reached exactly the source side of a minimum cut
+    sourceSide.assign(m, 0);
+    for (uint32_t u : queue)
+        sourceSide[u] = 1;
+    return flow;
+}
+
+// Assigns cells [firstCell, firstCell + cellCount) to the vertices of the part, bisecting it along
+// the smallest of the minimum cuts found for four directions
+static void flowSplit(const CompactGraph &graph, const ReverseAdjacency &reverse, std::vector<uint32_t> part,
+                      uint32_t firstCell, uint32_t cellCount, std::vector<uint32_t> &cells, std::vector<uint32_t> &local)
+{
+    if (cellCount <= 1 || part.size() <= 1)
+    {
+        for (uint32_t v : part)
+            cells[v] = firstCell;
+        return;
+    }
+
+    const uint32_t m = static_cast<uint32_t>(part.size());
+    for (uint32_t i = 0; i < m; ++i)
+        local[part[i]] = i;
+    PartNetwork network = buildPartNetwork(graph, reverse, part, local);
+    for (uint32_t v : part)
+        local[v] = CompactGraph::kInvalidIndex;
+
+    double meanLatitude = 0.0;
+    for (uint32_t v : part)
+        meanLatitude += graph.latitude(v) / m;
+    // A degree of longitude is shorter than a degree of latitude away from the equator
+    const double lonScale = std::cos(meanLatitude * M_PI / 180.0);
+    const double directions[4][2] = {{1.0, 0.0}, {0.0, 1.0}, {1.0, 1.0}, {1.0, -1.0}};
+
+    std::vector<uint32_t> order(m);
+    std::vector<double> keys(m);
+    std::vector<uint8_t> labels(m), side, bestSide;
+    uint32_t bestCut = CompactGraph::kInvalidIndex;
+    uint32_t bestImbalance = m;
+    const uint32_t terminals = std::max<uint32_t>(1, m / 4);
+    for (const auto &direction : directions)
+    {
+        for (uint32_t i = 0; i < m; ++i)
+            keys[i] = direction[0] * graph.longitude(part[i]) * lonScale + direction[1] * graph.latitude(part[i]);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+                  { return keys[a] < keys[b]; });
+        std::fill(labels.begin(), labels.end(), 0);
+        for (uint32_t i = 0; i < terminals; ++i)
+        {
+            labels[order[i]] = 1;
+            labels[order[m - 1 - i]] = 2;
+        }
+
+        uint32_t cut = minimumCut(network, labels, side);
+        uint32_t sourceCount = static_cast<uint32_t>(std::count(side.begin(), side.end(), 1));
+        uint32_t imbalance = sourceCount > m / 2 ? sourceCount - m / 2 : m / 2 - sourceCount;
+        if (cut < bestCut || (cut == bestCut && imbalance < bestImbalance))
+        {
+            bestCut = cut;
+            bestImbalance = imbalance;
+            bestSide.swap(side);
+        }
+    }
+
+    std::vector<uint32_t> first, second;
+    for (uint32_t i = 0; i < m; ++i)
+        (bestSide[i] ? first : second).push_back(part[i]);
+    part = std::vector<uint32_t>(); // Released before recursing
+    network = PartNetwork();
+    uint32_t firstCells = cellCount / 2;
+    flowSplit(graph, reverse, std::move(first), firstCell, firstCells, cells, local);
+    flowSplit(graph, reverse, std::move(second), firstCell + firstCells, cellCount - firstCells, cells, local);
+}
+
+std::vector<uint32_t> utils::flowPartition(const CompactGraph &graph, const ReverseAdjacency &reverse, uint32_t cellCount)
+{
+    std::vector<uint32_t> part(graph.vertexCount());
+    std::iota(part.begin(), part.end(), 0);
+    std::vector<uint32_t> cells(graph.vertexCount(), 0);
+    std::vector<uint32_t> local(graph.vertexCount(), CompactGraph::kInvalidIndex);
+    flowSplit(graph, reverse, std::move(part), 0, std::max<uint32_t>(1, cellCount), cells, local);
+    return cells;
+}
\ No newline at end of file
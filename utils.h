@@ -1,6 +1,7 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <span>
 #include <string_view>
 #include "Graph.h"
 
@@ -22,6 +23,51 @@ namespace utils
      */
     std::pair<double, double> mediumPoint(const Graph &graph);
 
+    /**
+     * @brief Parameters of the local Mercator projection of a graph, computed once from all its vertices.
+     */
+    struct ProjectionContext
+    {
+        double midLatitude;
+        double midLongitude;
+        double scaleX; // meters per degree of longitude at midLatitude
+        double scaleY; // meters per degree of latitude
+    };
+
+    /**
+     * @brief Computes the local Mercator projection context of the graph (medium point and scale factors).
+     *
+     * @param graph The graph containing the vertices.
+     * @return The projection context.
+     */
+    ProjectionContext projectionContext(const Graph &graph);
+
+    /**
+     * @brief Computes the local Mercator projection context around a given medium point.
+     *
+     * @param midLatitude The medium latitude of the vertices.
+     * @param midLongitude The medium longitude of the vertices.
+     * @return The projection context.
+     */
+    ProjectionContext projectionContext(double midLatitude, double midLongitude);
+
+    /**
+     * @brief Computes the projected Euclidean distances of a batch of coordinate pairs.
+     * The inputs are flat arrays of the same length, so the loop runs branch-free over
+     * contiguous memory and can be vectorized by the compiler.
+     *
+     * @param context The projection context of the graph.
+     * @param longitudes1 The longitudes of the first points.
+     * @param latitudes1 The latitudes of the first points.
+     * @param longitudes2 The longitudes of the second points.
+     * @param latitudes2 The latitudes of the second points.
+     * @param distances Output array receiving the distances in meters.
+     */
+    void computeEuclideanDistances(const ProjectionContext &context,
+                                   std::span<const double> longitudes1, std::span<const double> latitudes1,
+                                   std::span<const double> longitudes2, std::span<const double> latitudes2,
+                                   std::span<double> distances);
+
     /**
      * @brief Performs local Mercator projection for two vertices in the graph
      * returns the projected coordinates as a pair of ((x1, y1), (x2, y2)).
@@ -53,6 +99,44 @@ namespace utils
      * @return The Haversine distance in meters.
      */
     double computeHaversineDistance(const Vertex &current, const Vertex &goal);
+
+    /**
+     * @brief Computes the Haversine distance between two points given by raw coordinates.
+     * Used by the search algorithms, which keep coordinates in flat arrays.
+     *
+     * @param longitude1 The longitude of the first point in degrees.
+     * @param latitude1 The latitude of the first point in degrees.
+     * @param longitude2 The longitude of the second point in degrees.
+     * @param latitude2 The latitude of the second point in degrees.
+     * @return The Haversine distance in meters.
+     */
+    double computeHaversineDistance(double longitude1, double latitude1, double longitude2, double latitude2);
+
+    /**
+     * @brief Partitions the vertices into cells by a k-d split of their coordinates: every split
+     * cuts the longer side of the bounding box of a part at the vertex count that keeps the cells
+     * balanced. With a power of two cell count, cells c >> k form the coarser partition into
+     * cellCount >> k cells, so that one split serves several nested levels.
+     *
+     * @param graph The compact graph.
+     * @param cellCount The number of cells, at least 1.
+     * @return The cell of every vertex, by dense index.
+     */
+    std::vector<uint32_t> kdPartition(const CompactGraph &graph, uint32_t cellCount);
+
+    /**
+     * @brief Partitions the vertices into cells by recursive bisection along small edge cuts
+     * (inertial flow): every part is sorted along four directions of the plane, and the minimum
+     * cut between its first and last quarter, found with a unit-capacity max flow over its
+     * undirected edges, is taken for the direction where it is smallest. Cells nest like the ones
+     * of kdPartition(), but far fewer edges cross them, at the price of less even sizes.
+     *
+     * @param graph The compact graph.
+     * @param reverse The reverse adjacency of the graph, so that every edge is seen from both ends.
+     * @param cellCount The number of cells, a power of two.
+     * @return The cell of every vertex, by dense index.
+     */
+    std::vector<uint32_t> flowPartition(const CompactGraph &graph, const ReverseAdjacency &reverse, uint32_t cellCount);
 }
 
 #endif
\ No newline at end of file